@@ -444,17 +444,19 @@ void wiz_light(struct chunk *c, bool full)
 					/* Perma-light the grid */
 					sqinfo_on(c->squares[yy][xx].info, SQUARE_GLOW);
 
-					/* Memorize normal features */
+					/* Memorize normal features; the known level only matches
+					 * the live one, not one still being generated */
 					if (!square_isfloor(c, yy, xx) || 
 						square_isvisibletrap(c, yy, xx)) {
 						sqinfo_on(c->squares[yy][xx].info, SQUARE_MARK);
-						cave_k->squares[yy][xx].feat = c->squares[yy][xx].feat;
+						if (c == cave)
+							cave_k->squares[yy][xx].feat = c->squares[yy][xx].feat;
 					}
 				}
 			}
 
 			/* Memorize objects */
-			for (obj = square_object(cave, y, x); obj; obj = obj->next) {
+			for (obj = square_object(c, y, x); obj; obj = obj->next) {
 				/* Skip dead objects */
 				assert(obj->kind);
 
@@ -574,11 +576,6 @@ void cave_illuminate(struct chunk *c, bool daytime)
 	player->upkeep->redraw |= (PR_MAP | PR_MONLIST | PR_ITEMLIST);
 }
 
-/**
- * Size of the circular queue used by "update_flow()"
- */
-#define FLOW_MAX 2048
-
 /*
  * Hack -- provide some "speed" for the "flow" code
  * This entry is the "current index" for the "when" field
@@ -595,7 +592,512 @@ void cave_illuminate(struct chunk *c, bool daytime)
  */
 static int flow_save = 0;
 
+/**
+ * Cost of grids which the flow does not reach
+ */
+#define FLOW_NONE	255
+
+/**
+ * Most terrain changes noted between flow updates; after any more the flow
+ * is worked out afresh
+ */
+#define FLOW_CHANGES_MAX	64
+
+/**
+ * A grid queued to pass the flow on to its neighbours
+ */
+struct flow_step {
+	struct loc grid;
+	int next;
+};
+
+/**
+ * The flow from the latest update, kept so that the next update only has to
+ * work out again the grids whose cost changes.
+ *
+ * While the flow is live, the grids it reaches have the current "when" and
+ * their cost from here; everything else has the "when" and "cost" left in
+ * the grid by the last update which reached it.
+ */
+struct flow_map {
+	byte *cost;			/* Flow cost from the player, or FLOW_NONE */
+	byte *mark;			/* Grids being redone, or already filled */
+	struct loc source;	/* Where the player was for the latest update */
+	bool valid;			/* Costs can be updated rather than redone */
+	bool live;			/* Costs are current, not forgotten */
+	u32b feat_gen;		/* Terrain generation the costs allow for */
+
+	/* Terrain changes since the latest update */
+	struct loc changed[FLOW_CHANGES_MAX];
+	int changed_n;
+	bool changed_lost;
+
+	/* Grids queued by cost; pushes only ever go to a higher cost */
+	int *bucket;
+	struct flow_step *steps;
+	int steps_n;
+	int steps_size;
+
+	/* Grids whose cost no longer follows from their neighbours */
+	struct loc *raise;
+	int raise_n;
+	int raise_size;
+
+	/* Grids whose cost this update has changed, and one more than the cost
+	 * each had before (FLOW_NONE if it had none) */
+	struct loc *touched;
+	int touched_n;
+	int touched_size;
+	byte *old;
+};
+
+static struct flow_map *flow_map_get(struct chunk *c)
+{
+	int depth = z_info->max_flow_depth;
+	int size = (2 * depth + 1) * (2 * depth + 1);
+	int i;
 
+	if (c->flow) return c->flow;
+
+	assert(depth < FLOW_NONE);
+	c->flow = mem_zalloc(sizeof(*c->flow));
+	c->flow->cost = mem_alloc(c->height * c->width);
+	memset(c->flow->cost, FLOW_NONE, c->height * c->width);
+	c->flow->mark = mem_zalloc(c->height * c->width);
+	c->flow->bucket = mem_alloc(depth * sizeof(*c->flow->bucket));
+	for (i = 0; i < depth; i++)
+		c->flow->bucket[i] = -1;
+	c->flow->steps_size = size;
+	c->flow->steps = mem_alloc(size * sizeof(*c->flow->steps));
+	c->flow->raise_size = size;
+	c->flow->raise = mem_alloc(size * sizeof(*c->flow->raise));
+	c->flow->touched_size = size;
+	c->flow->touched = mem_alloc(size * sizeof(*c->flow->touched));
+	c->flow->old = mem_zalloc(c->height * c->width);
+	return c->flow;
+}
+
+/**
+ * Free a chunk's flow
+ */
+void cave_flow_free(struct chunk *c)
+{
+	if (!c->flow) return;
+	mem_free(c->flow->cost);
+	mem_free(c->flow->mark);
+	mem_free(c->flow->bucket);
+	mem_free(c->flow->steps);
+	mem_free(c->flow->raise);
+	mem_free(c->flow->touched);
+	mem_free(c->flow->old);
+	mem_free(c->flow);
+	c->flow = NULL;
+}
+
+/**
+ * Note that the terrain of a grid has changed, so the next flow update
+ * can start from it
+ */
+void cave_flow_note_change(struct chunk *c, int y, int x)
+{
+	struct flow_map *flow = c->flow;
+
+	if (!flow) return;
+
+	if (flow->changed_n < FLOW_CHANGES_MAX)
+		flow->changed[flow->changed_n++] = loc(x, y);
+	else
+		flow->changed_lost = TRUE;
+
+	/* Only keep up with the terrain while every change has been noted */
+	if (flow->feat_gen + 1 == c->feat_gen)
+		flow->feat_gen = c->feat_gen;
+}
+
+/**
+ * The "when" of a grid: the flow update which last reached it, or zero
+ */
+int cave_flow_when(struct chunk *c, int y, int x)
+{
+	struct flow_map *flow = c->flow;
+
+	if (flow && flow->live && (flow->cost[y * c->width + x] != FLOW_NONE))
+		return flow_save;
+	return c->squares[y][x].when;
+}
+
+/**
+ * The "cost" of a grid: its flow cost from the player at the flow update
+ * which last reached it
+ */
+int cave_flow_cost(struct chunk *c, int y, int x)
+{
+	struct flow_map *flow = c->flow;
+
+	if (flow && flow->live && (flow->cost[y * c->width + x] != FLOW_NONE))
+		return flow->cost[y * c->width + x];
+	return c->squares[y][x].cost;
+}
+
+/**
+ * Whether the flow goes through a grid; the player's grid always passes it on
+ */
+static bool flow_passes(struct chunk *c, struct loc source, int y, int x)
+{
+	if ((y == source.y) && (x == source.x)) return TRUE;
+	return (f_info[c->squares[y][x].feat].prop & FEAT_PROP_NO_FLOW) ? FALSE :
+		TRUE;
+}
+
+/**
+ * What the flow adds to the cost of a grid to pass into it
+ */
+static int flow_weight(struct chunk *c, int y, int x)
+{
+	return f_info[c->squares[y][x].feat].flow_cost;
+}
+
+/**
+ * Change the cost of a grid, remembering what it was before this update
+ */
+static void flow_set(struct flow_map *flow, int width, struct loc grid,
+					 int cost)
+{
+	int i = grid.y * width + grid.x;
+
+	if (!flow->old[i]) {
+		if (flow->touched_n == flow->touched_size) {
+			flow->touched_size *= 2;
+			flow->touched = mem_realloc(flow->touched, flow->touched_size *
+										sizeof(*flow->touched));
+		}
+		flow->touched[flow->touched_n++] = grid;
+		flow->old[i] = (flow->cost[i] == FLOW_NONE) ? FLOW_NONE :
+			flow->cost[i] + 1;
+	}
+	flow->cost[i] = cost;
+}
+
+/**
+ * Queue a grid to pass its cost on to its neighbours
+ */
+static void flow_push(struct flow_map *flow, struct loc grid, int cost)
+{
+	if (flow->steps_n == flow->steps_size) {
+		flow->steps_size *= 2;
+		flow->steps = mem_realloc(flow->steps,
+								  flow->steps_size * sizeof(*flow->steps));
+	}
+	flow->steps[flow->steps_n].grid = grid;
+	flow->steps[flow->steps_n].next = flow->bucket[cost];
+	flow->bucket[cost] = flow->steps_n++;
+}
+
+static void flow_queue(struct flow_map *flow, int width, struct loc grid,
+					   int cost)
+{
+	flow_set(flow, width, grid, cost);
+	flow_push(flow, grid, cost);
+}
+
+/**
+ * Give a grid the cost its neighbours allow, if that is lower than it has
+ */
+static void flow_seed(struct chunk *c, struct flow_map *flow,
+					  struct loc source, struct loc grid)
+{
+	int best = flow->cost[grid.y * c->width + grid.x];
+	int w = flow_weight(c, grid.y, grid.x);
+	int d;
+
+	for (d = 0; d < 8; d++) {
+		int y = grid.y + ddy_ddd[d];
+		int x = grid.x + ddx_ddd[d];
+		int n;
+
+		if (!square_in_bounds(c, y, x)) continue;
+		n = flow->cost[y * c->width + x];
+		if (n + w >= MIN(best, z_info->max_flow_depth)) continue;
+		if (!flow_passes(c, source, y, x)) continue;
+		best = n + w;
+	}
+
+	if (best < flow->cost[grid.y * c->width + grid.x])
+		flow_queue(flow, c->width, grid, best);
+}
+
+/**
+ * Pass the queued costs on to every grid they lower.
+ *
+ * Passing into a grid costs its flow_cost, at least one (even along
+ * diagonals), so each grid only ever queues its neighbours at a higher cost,
+ * and taking the grids a cost at a time finds every cost in one pass.
+ * Costs stop below z_info->max_flow_depth, which limits the flow depth.
+ */
+static void flow_lower(struct chunk *c, struct flow_map *flow,
+					   struct loc source)
+{
+	int n, d;
+
+	for (n = 0; n < z_info->max_flow_depth; n++) {
+		int i = flow->bucket[n];
+
+		flow->bucket[n] = -1;
+
+		for (; i >= 0; i = flow->steps[i].next) {
+			struct loc grid = flow->steps[i].grid;
+
+			/* Lowered again since it was queued */
+			if (flow->cost[grid.y * c->width + grid.x] != n) continue;
+
+			for (d = 0; d < 8; d++) {
+				int y = grid.y + ddy_ddd[d];
+				int x = grid.x + ddx_ddd[d];
+				int m;
+
+				if (!square_in_bounds(c, y, x)) continue;
+				m = n + flow_weight(c, y, x);
+				if (m >= z_info->max_flow_depth) continue;
+				if (flow->cost[y * c->width + x] <= m) continue;
+
+				/* Ignore "walls" */
+				if (!flow_passes(c, source, y, x)) continue;
+
+				flow_queue(flow, c->width, loc(x, y), m);
+			}
+		}
+	}
+
+	flow->steps_n = 0;
+}
+
+/**
+ * Whether a grid's cost still follows from a neighbour nearer the player
+ * which is not itself being redone
+ */
+static bool flow_supported(struct chunk *c, struct flow_map *flow,
+						   struct loc source, int y, int x)
+{
+	int n = flow->cost[y * c->width + x] - flow_weight(c, y, x);
+	int d;
+
+	if (!flow_passes(c, source, y, x)) return FALSE;
+
+	for (d = 0; d < 8; d++) {
+		int yy = y + ddy_ddd[d];
+		int xx = x + ddx_ddd[d];
+
+		if (!square_in_bounds(c, yy, xx)) continue;
+		if (flow->mark[yy * c->width + xx]) continue;
+		if (flow->cost[yy * c->width + xx] != n) continue;
+		if (flow_passes(c, source, yy, xx)) return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Mark a grid, and every grid whose cost depended only on it, to be redone
+ */
+static void flow_raise(struct chunk *c, struct flow_map *flow,
+					   struct loc source, struct loc grid)
+{
+	int i = flow->raise_n, d;
+
+	if (flow->mark[grid.y * c->width + grid.x]) return;
+	if (flow->cost[grid.y * c->width + grid.x] == FLOW_NONE) return;
+
+	flow->mark[grid.y * c->width + grid.x] = 1;
+	flow->raise[flow->raise_n++] = grid;
+
+	for (; i < flow->raise_n; i++) {
+		int n = flow->cost[flow->raise[i].y * c->width + flow->raise[i].x];
+
+		for (d = 0; d < 8; d++) {
+			int y = flow->raise[i].y + ddy_ddd[d];
+			int x = flow->raise[i].x + ddx_ddd[d];
+
+			if (!square_in_bounds(c, y, x)) continue;
+			if (flow->mark[y * c->width + x]) continue;
+			if (flow->cost[y * c->width + x] != n + flow_weight(c, y, x))
+				continue;
+			if (flow_supported(c, flow, source, y, x)) continue;
+
+			if (flow->raise_n == flow->raise_size) {
+				flow->raise_size *= 2;
+				flow->raise = mem_realloc(flow->raise, flow->raise_size *
+										  sizeof(*flow->raise));
+			}
+			flow->mark[y * c->width + x] = 1;
+			flow->raise[flow->raise_n++] = loc(x, y);
+		}
+	}
+}
+
+/**
+ * Drop every grid from the flow, leaving the old cost and "when" in the
+ * grid if the flow was live
+ */
+static void flow_clear(struct chunk *c, struct flow_map *flow, int old_when)
+{
+	int depth = z_info->max_flow_depth;
+	int y, x;
+
+	if (!flow->valid) return;
+
+	for (y = MAX(flow->source.y - depth, 0);
+		 y <= MIN(flow->source.y + depth, c->height - 1); y++) {
+		for (x = MAX(flow->source.x - depth, 0);
+			 x <= MIN(flow->source.x + depth, c->width - 1); x++) {
+			byte *cost = &flow->cost[y * c->width + x];
+
+			if (*cost == FLOW_NONE) continue;
+			if (old_when) {
+				c->squares[y][x].when = old_when;
+				c->squares[y][x].cost = *cost;
+			}
+			*cost = FLOW_NONE;
+		}
+	}
+}
+
+/**
+ * Update the flow from the player's old grid and any grids whose terrain has
+ * changed: costs are first lowered from the player's grid and from grids which
+ * have opened up or got cheaper, then grids whose cost relied on the old grid
+ * or on a grid which has changed are redone from their neighbours
+ */
+static void flow_repair(struct chunk *c, struct flow_map *flow,
+						struct loc source, int old_when)
+{
+	int i;
+
+	/* Lower costs */
+	if (flow->cost[source.y * c->width + source.x] != 0)
+		flow_queue(flow, c->width, source, 0);
+	for (i = 0; i < flow->changed_n; i++) {
+		struct loc grid = flow->changed[i];
+
+		if ((grid.y == source.y) && (grid.x == source.x)) continue;
+		if (flow_passes(c, source, grid.y, grid.x))
+			flow_seed(c, flow, source, grid);
+	}
+	flow_lower(c, flow, source);
+
+	/* Redo costs which no longer hold */
+	if ((flow->source.y != source.y) || (flow->source.x != source.x))
+		flow_raise(c, flow, source, flow->source);
+	for (i = 0; i < flow->changed_n; i++) {
+		struct loc grid = flow->changed[i];
+
+		if ((grid.y == source.y) && (grid.x == source.x)) continue;
+		flow_raise(c, flow, source, grid);
+	}
+
+	/* Refill them from the grids around */
+	for (i = 0; i < flow->raise_n; i++) {
+		struct loc grid = flow->raise[i];
+
+		flow->mark[grid.y * c->width + grid.x] = 0;
+		flow_set(flow, c->width, grid, FLOW_NONE);
+	}
+	for (i = 0; i < flow->raise_n; i++) {
+		struct loc grid = flow->raise[i];
+
+		if (flow_passes(c, source, grid.y, grid.x))
+			flow_seed(c, flow, source, grid);
+	}
+	flow_lower(c, flow, source);
+	flow->raise_n = 0;
+
+	/* Grids the flow no longer reaches keep their last cost and "when" */
+	for (i = 0; i < flow->touched_n; i++) {
+		struct loc grid = flow->touched[i];
+		int old = flow->old[grid.y * c->width + grid.x];
+
+		if (old_when && (old != FLOW_NONE) &&
+			(flow->cost[grid.y * c->width + grid.x] == FLOW_NONE)) {
+			c->squares[grid.y][grid.x].when = old_when;
+			c->squares[grid.y][grid.x].cost = old - 1;
+		}
+		flow->old[grid.y * c->width + grid.x] = 0;
+	}
+	flow->touched_n = 0;
+}
+
+/**
+ * Update the flow after the player has taken one step onto a grid which
+ * costs one to pass from the old grid, and no terrain has changed.  No cost
+ * can go up by more than one, and the grids whose cost doesn't go up are
+ * just those that a fill from the player's new grid reaches without going
+ * above their old cost; so only those are filled, and every other grid goes
+ * up by one.
+ */
+static void flow_step(struct chunk *c, struct flow_map *flow,
+					  struct loc source, int old_when)
+{
+	int depth = z_info->max_flow_depth;
+	int n, y, x, d;
+
+	/* Fill from the player, through grids no further away than before */
+	flow->cost[source.y * c->width + source.x] = 0;
+	flow->mark[source.y * c->width + source.x] = 1;
+	flow_push(flow, source, 0);
+	for (n = 0; n < depth; n++) {
+		int i = flow->bucket[n];
+
+		flow->bucket[n] = -1;
+		for (; i >= 0; i = flow->steps[i].next) {
+			struct loc grid = flow->steps[i].grid;
+
+			/* Lowered again since it was queued */
+			if (flow->cost[grid.y * c->width + grid.x] != n) continue;
+
+			for (d = 0; d < 8; d++) {
+				int j, m;
+
+				y = grid.y + ddy_ddd[d];
+				x = grid.x + ddx_ddd[d];
+				if (!square_in_bounds(c, y, x)) continue;
+				j = y * c->width + x;
+				m = n + flow_weight(c, y, x);
+
+				/* Hack -- Limit flow depth */
+				if (m >= depth) continue;
+				if (flow->cost[j] < m) continue;
+				if (flow->mark[j] && (flow->cost[j] == m)) continue;
+				if (!flow_passes(c, source, y, x)) continue;
+
+				flow->cost[j] = m;
+				flow->mark[j] = 1;
+				flow_push(flow, loc(x, y), m);
+			}
+		}
+	}
+	flow->steps_n = 0;
+
+	/* Everything else is a step further away, or out of the flow */
+	for (y = MAX(flow->source.y - depth, 0);
+		 y <= MIN(flow->source.y + depth, c->height - 1); y++) {
+		for (x = MAX(flow->source.x - depth, 0);
+			 x <= MIN(flow->source.x + depth, c->width - 1); x++) {
+			byte *cost = &flow->cost[y * c->width + x];
+			byte *mark = &flow->mark[y * c->width + x];
+
+			if (*mark) {
+				*mark = 0;
+			} else if (*cost + 1 < depth) {
+				(*cost)++;
+			} else if (*cost != FLOW_NONE) {
+				if (old_when) {
+					c->squares[y][x].when = old_when;
+					c->squares[y][x].cost = *cost;
+				}
+				*cost = FLOW_NONE;
+			}
+		}
+	}
+}
 
 /**
  * Forget the "flow" information ready for a complete update
@@ -616,44 +1118,39 @@ void cave_forget_flow(struct chunk *c)
 		}
 	}
 
+	/* The costs stay as a starting point for the next update */
+	if (c->flow)
+		c->flow->live = FALSE;
+
 	/* Start over */
 	flow_save = 0;
 }
 
 
 /*
- * Hack -- fill in the "cost" field of every grid that the player can
- * "reach" with the number of steps needed to reach that grid.  This
+ * Hack -- work out the "cost" of every grid that the player can "reach"
+ * as the sum of the flow costs of the grids passed through to reach it, one
+ * a step over open ground and more through doors and passable rubble.  This
  * also yields the "distance" of the player from every grid.
  *
  * In addition, mark the "when" of the grids that can reach the player
  * with the incremented value of "flow_save".
  *
- * Hack -- use the local "flow_y" and "flow_x" arrays as a "circular
- * queue" of cave grids.
- *
- * We do not need a priority queue because the cost from grid to grid
- * is always "one" (even along diagonals) and we process them in order.
+ * The costs are kept in the chunk from one update to the next, and only
+ * worked out afresh when the player has moved more than a step or the
+ * terrain has changed without being noted.  Otherwise they are updated from
+ * the player's old and new grids and from the grids whose terrain changed,
+ * and if nothing has changed there is nothing to do.  The result is always
+ * the same as a full fill from the player.
  */
 void cave_update_flow(struct chunk *c)
 {
-	int py = player->py;
-	int px = player->px;
-
-	int ty, tx;
-
+	struct flow_map *flow = flow_map_get(c);
+	struct loc source = loc(player->px, player->py);
+	int old_when = flow->live ? flow_save : 0;
+	bool moved = (source.y != flow->source.y) || (source.x != flow->source.x);
 	int y, x;
 
-	int n, d;
-
-	int flow_n;
-
-	int flow_tail = 0;
-	int flow_head = 0;
-
-	byte flow_y[FLOW_MAX];
-	byte flow_x[FLOW_MAX];
-
 
 	/*** Cycle the flow ***/
 
@@ -672,80 +1169,34 @@ void cave_update_flow(struct chunk *c)
 
 		/* Restart */
 		flow_save = 128;
+		if (old_when) old_when -= 128;
 	}
 
-	/* Local variable */
-	flow_n = flow_save;
-
 
-	/*** Player Grid ***/
-
-	/* Save the time-stamp */
-	c->squares[py][px].when = flow_n;
-
-	/* Save the flow cost */
-	c->squares[py][px].cost = 0;
-
-	/* Enqueue that entry */
-	flow_y[flow_head] = py;
-	flow_x[flow_head] = px;
-
-	/* Advance the queue */
-	++flow_tail;
-
-
-	/*** Process Queue ***/
-
-	/* Now process the queue */
-	while (flow_head != flow_tail)
-	{
-		/* Extract the next entry */
-		ty = flow_y[flow_head];
-		tx = flow_x[flow_head];
-
-		/* Forget that entry (with wrap) */
-		if (++flow_head == FLOW_MAX) flow_head = 0;
-
-		/* Child cost */
-		n = c->squares[ty][tx].cost + 1;
-
-		/* Hack -- Limit flow depth */
-		if (n == z_info->max_flow_depth) continue;
-
-		/* Add the "children" */
-		for (d = 0; d < 8; d++)
-		{
-			int old_head = flow_tail;
-
-			/* Child location */
-			y = ty + ddy_ddd[d];
-			x = tx + ddx_ddd[d];
-			if (!square_in_bounds(c, y, x)) continue;
-
-			/* Ignore "pre-stamped" entries */
-			if (c->squares[y][x].when == flow_n) continue;
-
-			/* Ignore "walls" and "rubble" */
-			if (tf_has(f_info[c->squares[y][x].feat].flags, TF_NO_FLOW))
-				continue;
-
-			/* Save the time-stamp */
-			c->squares[y][x].when = flow_n;
-
-			/* Save the flow cost */
-			c->squares[y][x].cost = n;
-
-			/* Enqueue that entry */
-			flow_y[flow_tail] = y;
-			flow_x[flow_tail] = x;
-
-			/* Advance the queue */
-			if (++flow_tail == FLOW_MAX) flow_tail = 0;
-
-			/* Hack -- Overflow by forgetting new entry */
-			if (flow_tail == flow_head) flow_tail = old_head;
-		}
+	/*** Update the costs ***/
+
+	if (!flow->valid || flow->changed_lost || (flow->feat_gen != c->feat_gen) ||
+		(ABS(source.y - flow->source.y) > 1) ||
+		(ABS(source.x - flow->source.x) > 1)) {
+		/* The old costs are no use, so start afresh */
+		flow_clear(c, flow, old_when);
+		flow->changed_n = 0;
+		flow->source = source;
+		flow_repair(c, flow, source, old_when);
+	} else if (moved && !flow->changed_n &&
+			   flow_passes(c, source, flow->source.y, flow->source.x) &&
+			   (flow_weight(c, flow->source.y, flow->source.x) == 1)) {
+		flow_step(c, flow, source, old_when);
+	} else if (moved || flow->changed_n) {
+		flow_repair(c, flow, source, old_when);
 	}
+
+	flow->source = source;
+	flow->changed_n = 0;
+	flow->changed_lost = FALSE;
+	flow->feat_gen = c->feat_gen;
+	flow->valid = TRUE;
+	flow->live = TRUE;
 }
 
 /* Make map features known */
@@ -64,7 +64,7 @@ bool feat_is_treasure(int feat)
  */
 bool feat_is_wall(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_WALL);
+	return (f_info[feat].prop & FEAT_PROP_WALL) ? TRUE : FALSE;
 }
 
 /**
@@ -72,7 +72,7 @@ bool feat_is_wall(int feat)
  */
 bool feat_is_monster_walkable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return (f_info[feat].prop & FEAT_PROP_PASSABLE) ? TRUE : FALSE;
 }
 
 /**
@@ -88,7 +88,7 @@ bool feat_is_shop(int feat)
  */
 bool feat_is_passable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PASSABLE);
+	return (f_info[feat].prop & FEAT_PROP_PASSABLE) ? TRUE : FALSE;
 }
 
 /**
@@ -96,7 +96,7 @@ bool feat_is_passable(int feat)
  */
 bool feat_is_projectable(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_PROJECT);
+	return (f_info[feat].prop & FEAT_PROP_PROJECT) ? TRUE : FALSE;
 }
 
 /**
@@ -104,7 +104,7 @@ bool feat_is_projectable(int feat)
  */
 bool feat_is_bright(int feat)
 {
-	return tf_has(f_info[feat].flags, TF_BRIGHT);
+	return (f_info[feat].prop & FEAT_PROP_BRIGHT) ? TRUE : FALSE;
 }
 
 /**
@@ -761,6 +761,8 @@ void square_set_feat(struct chunk *c, int y, int x, int feat)
 
 	/* Make the change */
 	c->squares[y][x].feat = feat;
+	c->feat_gen++;
+	cave_flow_note_change(c, y, x);
 
 	/* Make the new terrain feel at home */
 	if (character_dungeon) {
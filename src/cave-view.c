@@ -20,6 +20,7 @@
 #include "cave.h"
 #include "cmds.h"
 #include "init.h"
+#include "mon-util.h"
 #include "monster.h"
 #include "player-calcs.h"
 #include "player-timed.h"
@@ -448,8 +449,8 @@ void forget_view(struct chunk *c)
 {
 	int x, y;
 
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	for (y = c->view_min.y; y <= c->view_max.y; y++) {
+		for (x = c->view_min.x; x <= c->view_max.x; x++) {
 			if (!square_isview(c, y, x))
 				continue;
 			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
@@ -457,6 +458,10 @@ void forget_view(struct chunk *c)
 			square_light_spot(c, y, x);
 		}
 	}
+
+	/* Nothing is in view any more */
+	c->view_min = loc(c->width, c->height);
+	c->view_max = loc(-1, -1);
 }
 
 
@@ -468,8 +473,8 @@ static void mark_wasseen(struct chunk *c)
 {
 	int x, y;
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
+	for (y = c->view_min.y; y <= c->view_max.y; y++) {
+		for (x = c->view_min.x; x <= c->view_max.x; x++) {
 			if (square_isseen(c, y, x))
 				sqinfo_on(c->squares[y][x].info, SQUARE_WASSEEN);
 			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
@@ -482,23 +487,25 @@ static void mark_wasseen(struct chunk *c)
  */
 static void add_monster_lights(struct chunk *c, struct loc from)
 {
-	int i, j, k;
-
-	/* Scan monster list and add monster lights */
-	for (k = 1; k < cave_monster_max(c); k++) {
-		/* Check the k'th monster */
-		struct monster *m = cave_monster(c, k);
+	int i, j, k, n;
+	s16b *found;
 
-		bool in_los = los(c, from.y, from.x, m->fy, m->fx);
+	/* Only monsters near enough to light a grid in view need be checked */
+	n = mon_buckets_near(c, from.y, from.x, monster_light_view_range(),
+						 &found);
 
-		/* Skip dead monsters */
-		if (!m->race)
-			continue;
+	/* Scan those monsters and add monster lights */
+	for (k = 0; k < n; k++) {
+		/* Check the k'th monster */
+		struct monster *m = cave_monster(c, found[k]);
+		bool in_los;
 
 		/* Skip monsters not carrying light */
 		if (!rf_has(m->race->flags, RF_HAS_LIGHT))
 			continue;
 
+		in_los = los(c, from.y, from.x, m->fy, m->fx);
+
 		/* Light a 3x3 box centered on the monster */
 		for (i = -1; i <= 1; i++)
 			for (j = -1; j <= 1; j++) {
@@ -522,6 +529,8 @@ static void add_monster_lights(struct chunk *c, struct loc from)
 				sqinfo_on(c->squares[sy][sx].info, SQUARE_SEEN);
 			}
 	}
+
+	mem_free(found);
 }
 
 /**
@@ -599,14 +608,6 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
 	if (d > z_info->max_sight)
 		return;
 
-	/* Light squares with adjacent bright terrain */
-	for (dir = 0; dir < 8; dir++) {
-		if (!square_in_bounds(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
-			continue;
-		if (square_isbright(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
-			lit = TRUE;
-	}
-
 	/* Special case for wall lighting. If we are a wall and the square in
 	 * the direction of the player is in LOS, we are in LOS. This avoids
 	 * situations like:
@@ -654,8 +655,32 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
 	}
 
 
-	if (los(c, py, px, yc, xc))
-		become_viewable(c, y, x, lit, py, px);
+	if (!los(c, py, px, yc, xc))
+		return;
+
+	/* Light squares with adjacent bright terrain */
+	for (dir = 0; dir < 8 && !lit; dir++) {
+		if (!square_in_bounds(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
+			continue;
+		if (square_isbright(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
+			lit = TRUE;
+	}
+
+	become_viewable(c, y, x, lit, py, px);
+}
+
+/**
+ * Find the smallest rectangle containing every grid that could be in view
+ * from (py, px).  Any grid further than max_sight along either axis is also
+ * further than max_sight by distance(), so there is no need to look at it.
+ */
+static void view_bounds(struct chunk *c, int py, int px, int *y1, int *x1,
+						int *y2, int *x2)
+{
+	*y1 = MAX(py - z_info->max_sight, 0);
+	*x1 = MAX(px - z_info->max_sight, 0);
+	*y2 = MIN(py + z_info->max_sight, c->height - 1);
+	*x2 = MIN(px + z_info->max_sight, c->width - 1);
 }
 
 /**
@@ -664,6 +689,7 @@ static void update_view_one(struct chunk *c, int y, int x, int radius, int py, i
 void update_view(struct chunk *c, struct player *p)
 {
 	int x, y;
+	int y1, x1, y2, x2;
 
 	int radius;
 
@@ -682,15 +708,20 @@ void update_view(struct chunk *c, struct player *p)
 	if (radius > 0 || square_isglow(c, p->py, p->px))
 		sqinfo_on(c->squares[p->py][p->px].info, SQUARE_SEEN);
 
-	/* View squares we have LOS to */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	/* View squares we have LOS to, looking only as far as we can see */
+	view_bounds(c, p->py, p->px, &y1, &x1, &y2, &x2);
+	for (y = y1; y <= y2; y++)
+		for (x = x1; x <= x2; x++)
 			update_view_one(c, y, x, radius, p->py, p->px);
 
-	/* Complete the algorithm */
-	for (y = 0; y < c->height; y++)
-		for (x = 0; x < c->width; x++)
+	/* Complete the algorithm for grids in either the old or the new view */
+	for (y = MIN(y1, c->view_min.y); y <= MAX(y2, c->view_max.y); y++)
+		for (x = MIN(x1, c->view_min.x); x <= MAX(x2, c->view_max.x); x++)
 			update_one(c, y, x, p->timed[TMD_BLIND]);
+
+	/* Remember where to look next time */
+	c->view_min = loc(x1, y1);
+	c->view_max = loc(x2, y2);
 }
 
 
@@ -22,14 +22,18 @@
 #include "cmd-core.h"
 #include "game-event.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "monster.h"
+#include "mon-move.h"
+#include "mon-util.h"
 #include "obj-ignore.h"
 #include "obj-pile.h"
 #include "obj-tval.h"
 #include "obj-util.h"
 #include "object.h"
 #include "player-timed.h"
+#include "project.h"
 #include "trap.h"
 
 struct feature *f_info;
@@ -87,10 +91,42 @@ static int lookup_feat(const char *name)
 }
 
 /**
- * Set terrain constants to the indices from terrain.txt
+ * Set terrain constants to the indices from terrain.txt, and cache the
+ * properties used by the innermost loops.
+ *
+ * The flow through a grid costs a step, or more where a monster has to stop
+ * to get through: a closed or secret door must be opened, and passable rubble
+ * is slow going.  Rubble nothing can walk through doesn't flow at all.
  */
 void set_terrain(void)
 {
+	int i;
+
+	for (i = 0; i < z_info->f_max; i++) {
+		struct feature *feat = &f_info[i];
+
+		feat->prop = 0;
+		if (tf_has(feat->flags, TF_PASSABLE))
+			feat->prop |= FEAT_PROP_PASSABLE;
+		if (tf_has(feat->flags, TF_PROJECT))
+			feat->prop |= FEAT_PROP_PROJECT;
+		if (tf_has(feat->flags, TF_BRIGHT))
+			feat->prop |= FEAT_PROP_BRIGHT;
+		if (tf_has(feat->flags, TF_WALL))
+			feat->prop |= FEAT_PROP_WALL;
+		if (tf_has(feat->flags, TF_NO_FLOW))
+			feat->prop |= FEAT_PROP_NO_FLOW;
+
+		if (tf_has(feat->flags, TF_DOOR_ANY) &&
+			!tf_has(feat->flags, TF_PASSABLE))
+			feat->flow_cost = 2;
+		else if (tf_has(feat->flags, TF_ROCK) &&
+				 tf_has(feat->flags, TF_PASSABLE))
+			feat->flow_cost = 2;
+		else
+			feat->flow_cost = 1;
+	}
+
 	FEAT_NONE = lookup_feat("unknown grid");
 	FEAT_FLOOR = lookup_feat("open floor");
 	FEAT_CLOSED = lookup_feat("closed door");
@@ -117,24 +153,38 @@ void set_terrain(void)
  */
 struct chunk *cave_new(int height, int width) {
 	int y, x;
+	struct square *grid;
+	bitflag *info;
+	struct chunk *c;
 
-	struct chunk *c = mem_zalloc(sizeof *c);
+	gen_phase_begin(GEN_PHASE_ALLOC);
+	c = mem_zalloc(sizeof *c);
 	c->height = height;
 	c->width = width;
 	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
 
+	/* The squares, and all their info flags, each live in one contiguous
+	 * block; squares[y] just points at the start of row y */
+	grid = mem_zalloc(c->height * c->width * sizeof(struct square));
+	info = mem_zalloc(c->height * c->width * SQUARE_SIZE * sizeof(bitflag));
 	c->squares = mem_zalloc(c->height * sizeof(struct square*));
 	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
+		c->squares[y] = grid + y * c->width;
 		for (x = 0; x < c->width; x++)
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
+			c->squares[y][x].info = info + (y * c->width + x) * SQUARE_SIZE;
 	}
 
+	/* Square info may be filled in by the caller, so assume any grid can be
+	 * in view until the view is next forgotten or recalculated */
+	c->view_min = loc(0, 0);
+	c->view_max = loc(width - 1, height - 1);
+
 	c->monsters = mem_zalloc(z_info->level_monster_max *sizeof(struct monster));
 	c->mon_max = 1;
 	c->mon_current = -1;
 
 	c->created_at = turn;
+	gen_phase_end();
 	return c;
 }
 
@@ -146,18 +196,22 @@ void cave_free(struct chunk *c) {
 
 	for (y = 0; y < c->height; y++) {
 		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
 			if (c->squares[y][x].trap)
 				square_free_trap(c, y, x);
 			if (c->squares[y][x].obj)
 				object_pile_free(c->squares[y][x].obj);
 		}
-		mem_free(c->squares[y]);
 	}
+	mem_free(c->squares[0][0].info);
+	mem_free(c->squares[0]);
 	mem_free(c->squares);
 
 	mem_free(c->feat_count);
 	mem_free(c->monsters);
+	mon_sched_free(c);
+	mon_buckets_free(c);
+	projection_cache_free(c);
+	cave_flow_free(c);
 	if (c->name)
 		string_free(c->name);
 	mem_free(c);
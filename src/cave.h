@@ -24,6 +24,9 @@
 
 struct player;
 struct monster;
+struct monster_schedule;
+struct monster_buckets;
+struct projection_cache;
 
 const s16b ddd[9];
 const s16b ddx[10];
@@ -79,6 +82,17 @@ enum
 
 #define tf_has(f, flag)        flag_has_dbg(f, TF_SIZE, flag, #f, #flag)
 
+/**
+ * Terrain properties which are tested in the innermost loops (los(),
+ * project_path(), view and flow), cached in each feature's prop field so they
+ * can be checked without going through tf_has().  Set by set_terrain().
+ */
+#define FEAT_PROP_PASSABLE     0x01
+#define FEAT_PROP_PROJECT      0x02
+#define FEAT_PROP_BRIGHT       0x04
+#define FEAT_PROP_WALL         0x08
+#define FEAT_PROP_NO_FLOW      0x10
+
 /**
  * Information about terrain features.
  *
@@ -99,6 +113,8 @@ struct feature {
 	byte dig;      /**< How hard is it to dig through? */
 
 	bitflag flags[TF_SIZE];    /**< Terrain flags */
+	byte prop;                 /**< Cached FEAT_PROP_* properties */
+	byte flow_cost;            /**< Flow cost to pass through, if it flows */
 
 	byte d_attr;   /**< Default feature attribute */
 	wchar_t d_char;/**< Default feature character */
@@ -156,16 +172,33 @@ struct chunk {
 	
 	u16b feeling_squares; /* How many feeling squares the player has visited */
 	int *feat_count;
+	u32b feat_gen; /* Bumped whenever the terrain of any grid changes */
 
 	byte **feat;
 	s16b **m_idx;
 
 	struct square **squares;
 
+	/* Bounding box of grids which may have SQUARE_VIEW or SQUARE_SEEN set */
+	struct loc view_min;
+	struct loc view_max;
+
 	struct monster *monsters;
 	u16b mon_max;
 	u16b mon_cnt;
 	int mon_current;
+
+	/* Which monsters move on which game turns (see mon-move.c) */
+	struct monster_schedule *sched;
+
+	/* Which monsters are in which part of the level (see mon-util.c) */
+	struct monster_buckets *mon_buckets;
+
+	/* Recent projection paths and project() scratch space (see project.c) */
+	struct projection_cache *proj_cache;
+
+	/* The monster flow from the latest update (see cave-map.c) */
+	struct flow_map *flow;
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -226,6 +259,10 @@ void light_room(int y1, int x1, bool light);
 void wiz_light(struct chunk *c, bool full);
 void wiz_dark(void);
 void cave_illuminate(struct chunk *c, bool daytime);
+void cave_flow_free(struct chunk *c);
+void cave_flow_note_change(struct chunk *c, int y, int x);
+int cave_flow_when(struct chunk *c, int y, int x);
+int cave_flow_cost(struct chunk *c, int y, int x);
 void cave_update_flow(struct chunk *c);
 void cave_forget_flow(struct chunk *c);
 
@@ -1333,8 +1333,9 @@ bool effect_handler_DETECT_OBJECTS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
+	s16b *found;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
@@ -1351,19 +1352,10 @@ bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
+	/* Scan monsters in the area */
+	n = mon_buckets_rect(cave, y1, x1, y2, x2, &found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 
 		/* Detect all non-invisible, obvious monsters */
 		if (!rf_has(mon->race->flags, RF_INVISIBLE) &&
@@ -1386,6 +1378,8 @@ bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
 		}
 	}
 
+	mem_free(found);
+
 	if (monsters)
 		msg("You sense the presence of monsters!");
 	else if (context->aware)
@@ -1402,8 +1396,9 @@ bool effect_handler_DETECT_VISIBLE_MONSTERS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
+	s16b *found;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
@@ -1420,23 +1415,14 @@ bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Scan monsters in the area */
+	n = mon_buckets_rect(cave, y1, x1, y2, x2, &found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 		struct monster_lore *lore;
 
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
 		lore = get_lore(mon->race);
 
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
 		/* Detect invisible monsters */
 		if (rf_has(mon->race->flags, RF_INVISIBLE)) {
 			/* Take note that they are invisible */
@@ -1459,6 +1445,8 @@ bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
 		}
 	}
 
+	mem_free(found);
+
 	if (monsters)
 		msg("You sense the presence of invisible creatures!");
 	else if (context->aware)
@@ -1476,8 +1464,9 @@ bool effect_handler_DETECT_INVISIBLE_MONSTERS(effect_handler_context_t *context)
  */
 bool effect_handler_DETECT_EVIL(effect_handler_context_t *context)
 {
-	int i, x, y;
+	int i, n;
 	int x1, x2, y1, y2;
+	s16b *found;
 	int y_dist = context->value.dice;
 	int x_dist = context->value.sides;
 
@@ -1494,23 +1483,14 @@ bool effect_handler_DETECT_EVIL(effect_handler_context_t *context)
 	if (y2 > cave->height - 1) y2 = cave->height - 1;
 	if (x2 > cave->width - 1) x2 = cave->width - 1;
 
-	/* Scan monsters */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
+	/* Scan monsters in the area */
+	n = mon_buckets_rect(cave, y1, x1, y2, x2, &found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(cave, found[i]);
 		struct monster_lore *lore;
 
-		/* Skip dead monsters */
-		if (!mon->race) continue;
-
 		lore = get_lore(mon->race);
 
-		/* Location */
-		y = mon->fy;
-		x = mon->fx;
-
-		/* Only detect nearby monsters */
-		if (x < x1 || y < y1 || x > x2 || y > y2) continue;
-
 		/* Detect evil monsters */
 		if (rf_has(mon->race->flags, RF_EVIL)) {
 			/* Take note that they are evil */
@@ -1533,6 +1513,8 @@ bool effect_handler_DETECT_EVIL(effect_handler_context_t *context)
 		}
 	}
 
+	mem_free(found);
+
 	if (monsters)
 		msg("You sense the presence of evil creatures!");
 	else if (context->aware)
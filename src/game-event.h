@@ -73,6 +73,7 @@ typedef enum game_event_type
 	EVENT_COMMAND_REPEAT,
 	EVENT_ANIMATE,
 	EVENT_CHEAT_DEATH,
+	EVENT_SAVE_DONE,	/* A background save has finished */
 
 	EVENT_INITSTATUS,	/* New status message for initialisation */
 	EVENT_BIRTHPOINTS,	/* Change in the birth points */
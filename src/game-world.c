@@ -21,6 +21,7 @@
 #include "effects.h"
 #include "game-world.h"
 #include "init.h"
+#include "mon-list.h"
 #include "mon-make.h"
 #include "mon-move.h"
 #include "mon-util.h"
@@ -33,6 +34,7 @@
 #include "player-timed.h"
 #include "player-util.h"
 #include "target.h"
+#include "test-hooks.h"
 
 u16b daycount = 0;
 u32b seed_randart;		/* Hack -- consistent random artifacts */
@@ -42,6 +44,12 @@ bool character_generated;	/* The character exists */
 bool character_dungeon;		/* The character has a dungeon */
 bool character_saved;		/* The character was just saved to a savefile */
 
+/* Don't skip the idle game turns of a rest (see test-hooks.h) */
+bool rest_every_turn = FALSE;
+
+/* How many idle game turns of a rest have been skipped (see test-hooks.h) */
+s32b rest_turns_skipped = 0;
+
 /**
  * This table allows quick conversion from "speed" to "energy"
  * The basic function WAS ((S>=110) ? (S-110) : (100 / (120-S)))
@@ -658,6 +666,9 @@ void on_new_level(void)
 	/* Cancel the health bar */
 	health_track(player->upkeep, NULL);
 
+	/* Find the visible monsters afresh */
+	monster_list_forget_visible();
+
 	/* Disturb */
 	disturb(player, 1);
 
@@ -712,6 +723,53 @@ static void on_leave_level(void) {
 }
 
 
+/**
+ * Pass over the game turns of a rest on which nothing would happen.
+ *
+ * Most game turns of a long rest only hand out energy: the world isn't due to
+ * be processed, the player hasn't the energy for another turn, and no monster
+ * is due to move, or those that are are too far from the player to do more
+ * than use up their energy (see mon_sched_pass_turns()).  All those turns can
+ * go by at once, with the player given their energy for them in one lump, and
+ * nothing refreshed in between, as nothing has changed.  The world and the
+ * player's own turns are still processed one at a time, as they always were.
+ */
+static void skip_idle_rest_turns(void)
+{
+	int energy = turn_energy(player->state.speed);
+	s32b until;
+
+	if (rest_every_turn || !player_is_resting(player))
+		return;
+
+	/* Anything waiting to be updated has to be done on the right turn */
+	if (player->upkeep->update || player->upkeep->notice ||
+		player->upkeep->generate_level || player->is_dead)
+		return;
+
+	/* The player moves as soon as they have the energy */
+	if (player->energy >= z_info->move_energy)
+		return;
+	until = turn + (z_info->move_energy - player->energy + energy - 1) / energy;
+
+	/* The world is processed every ten game turns */
+	if (turn % 10 == 0)
+		return;
+	until = MIN(until, turn - turn % 10 + 10);
+
+	/* Monsters out of the player's way can be left to gain their energy,
+	 * otherwise stop for the first one to move */
+	if (mon_sched_next_turn(cave) < until &&
+		!mon_sched_pass_turns(cave, until))
+		until = mon_sched_next_turn(cave);
+	if (until <= turn)
+		return;
+
+	player->energy += (until - turn) * energy;
+	rest_turns_skipped += until - turn;
+	turn = until;
+}
+
 /**
  * The main game loop.
  *
@@ -798,6 +856,9 @@ void run_game_loop(void)
 
 			/* Count game turns */
 			turn++;
+
+			/* Resting through game turns where nothing happens is quick */
+			skip_idle_rest_turns();
 		}
 
 		/* Make a new level if requested */
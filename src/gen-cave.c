@@ -106,6 +106,8 @@ static void build_streamer(struct chunk *c, int feat, int chance)
     int i, tx, ty;
     int y, x, dir;
 
+    gen_phase_begin(GEN_PHASE_STREAMERS);
+
     /* Hack -- Choose starting point */
     y = rand_spread(c->height / 2, 10);
     x = rand_spread(c->width / 2, 15);
@@ -139,6 +141,8 @@ static void build_streamer(struct chunk *c, int feat, int chance)
 		/* Stop at dungeon edge */
 		if (!square_in_bounds(c, y, x)) break;
     }
+
+    gen_phase_end();
 }
 
 
@@ -178,6 +182,8 @@ static void build_tunnel(struct chunk *c, int row1, int col1, int row2, int col2
 
     /* Used to prevent excessive door creation along overlapping corridors. */
     bool door_flag = FALSE;
+
+    gen_phase_begin(GEN_PHASE_TUNNELS);
 	
     /* Reset the arrays */
     dun->tunn_n = 0;
@@ -349,6 +355,8 @@ static void build_tunnel(struct chunk *c, int row1, int col1, int row2, int col2
 		if (randint0(100) < dun->profile->tun.pen)
 			place_random_door(c, y, x);
     }
+
+    gen_phase_end();
 }
 
 /**
@@ -455,8 +463,10 @@ struct chunk *classic_gen(struct player *p) {
     ROOM_LOG("height=%d  width=%d  nrooms=%d", c->height, c->width, num_rooms);
 
     /* Fill cave area with basic granite */
+    gen_phase_begin(GEN_PHASE_ALLOC);
     fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
 				   FEAT_GRANITE, SQUARE_NONE);
+    gen_phase_end();
 
     /* Actual maximum number of rooms on this level */
     dun->row_blocks = c->height / dun->block_hgt;
@@ -900,7 +910,9 @@ static void init_cavern(struct chunk *c, int density) {
     int count = (size * density) / 100;
 
     /* Fill the entire chunk with rock */
+    gen_phase_begin(GEN_PHASE_ALLOC);
     fill_rectangle(c, 0, 0, h - 1, w - 1, FEAT_GRANITE, SQUARE_WALL_SOLID);
+    gen_phase_end();
 	
     while (count > 0) {
 		int y = randint1(h - 2);
@@ -1285,14 +1297,18 @@ static void join_regions(struct chunk *c, int colors[], int counts[]) {
  */
 void ensure_connectedness(struct chunk *c) {
     int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+    int *colors, *counts;
+
+    gen_phase_begin(GEN_PHASE_CONNECT);
+    colors = mem_zalloc(size * sizeof(int));
+    counts = mem_zalloc(size * sizeof(int));
 
     build_colors(c, colors, counts, TRUE);
     join_regions(c, colors, counts);
 
     mem_free(colors);
     mem_free(counts);
+    gen_phase_end();
 }
 
 
@@ -1619,8 +1635,10 @@ struct chunk *modified_chunk(int depth, int height, int width)
     ROOM_LOG("height=%d  width=%d  nfloors=%d", c->height, c->width,num_floors);
 
     /* Fill cave area with basic granite */
+    gen_phase_begin(GEN_PHASE_ALLOC);
     fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
 				   FEAT_GRANITE, SQUARE_NONE);
+    gen_phase_end();
 
     /* Generate permanent walls around the generated area (temporarily!) */
     draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
@@ -1850,8 +1868,10 @@ struct chunk *moria_chunk(int depth, int height, int width)
     ROOM_LOG("height=%d  width=%d  nfloors=%d", c->height, c->width,num_floors);
 
     /* Fill cave area with basic granite */
+    gen_phase_begin(GEN_PHASE_ALLOC);
     fill_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
 				   FEAT_GRANITE, SQUARE_NONE);
+    gen_phase_end();
 
     /* Generate permanent walls around the generated area (temporarily!) */
     draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
@@ -2500,8 +2520,10 @@ struct chunk *gauntlet_gen(struct player *p) {
 	c->depth = p->depth;
 
 	/* Fill cave area with basic granite */
+	gen_phase_begin(GEN_PHASE_ALLOC);
 	fill_rectangle(c, 0, 0, c->height - 1, c->width - 1,
 				   FEAT_GRANITE, SQUARE_NONE);
+	gen_phase_end();
 
 	/* Fill the area between the caverns with permanent rock */
 	fill_rectangle(c, 0, line1, c->height - 1, line2 - 1, FEAT_PERM,
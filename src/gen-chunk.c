@@ -27,14 +27,21 @@
 #include "cave.h"
 #include "generate.h"
 #include "init.h"
+#include "message.h"
 #include "mon-make.h"
+#include "mon-move.h"
+#include "mon-util.h"
 #include "obj-util.h"
+#include "savefile.h"
 #include "trap.h"
 
 #define CHUNK_LIST_INCR 10
 struct chunk **chunk_list;     /**< list of pointers to saved chunks */
 u16b chunk_list_max = 0;      /**< current max actual chunk index */
 
+struct chunk_stored *chunk_stored_list;	/**< chunks not yet read back */
+u16b chunk_stored_max = 0;		/**< number of chunks not yet read back */
+
 /**
  * Write a chunk to memory and return a pointer to it.  Optionally write
  * monsters, objects and/or traps, and in those cases delete those things from
@@ -87,7 +94,8 @@ struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 					if (!source_mon->race)
 						continue;
 
-					/* Copy over */
+					/* Copy over, with energy up to date */
+					mon_sched_settle(cave, source_mon);
 					new->squares[y][x].mon = ++new->mon_cnt;
 					dest_mon = cave_monster(new, new->mon_cnt);
 					memcpy(dest_mon, source_mon, sizeof(*source_mon));
@@ -140,6 +148,71 @@ void chunk_list_add(struct chunk *c)
 	chunk_list[chunk_list_max++] = c;
 }
 
+/**
+ * Keep a chunk from the savefile without reading it; it is read by
+ * chunk_find_name() the first time it is wanted
+ *
+ * Monsters in a chunk that hasn't been read are not counted in their race's
+ * cur_num, so a unique stored this way could be made again elsewhere.  That
+ * is fine while the only stored chunk is the Town, which is written without
+ * monsters (see cave_generate()); a chunk kept with its monsters would have
+ * to be read straight away, or have its uniques counted here.
+ * \param name the name of the chunk
+ * \param data the chunk as it was in the savefile, which the list now owns
+ * \param len the length of data
+ */
+void chunk_stored_add(const char *name, byte *data, u32b len)
+{
+	int newsize = (chunk_stored_max + CHUNK_LIST_INCR) *
+		sizeof(struct chunk_stored);
+
+	/* Lengthen the list if necessary */
+	if (chunk_stored_max == 0)
+		chunk_stored_list = mem_zalloc(newsize);
+	else if ((chunk_stored_max % CHUNK_LIST_INCR) == 0)
+		chunk_stored_list = mem_realloc(chunk_stored_list, newsize);
+
+	/* Add the new one */
+	chunk_stored_list[chunk_stored_max].name = string_make(name);
+	chunk_stored_list[chunk_stored_max].data = data;
+	chunk_stored_list[chunk_stored_max].len = len;
+	chunk_stored_max++;
+}
+
+/**
+ * Remove entry i from the stored chunk list, returning its data
+ */
+static byte *chunk_stored_take(int i)
+{
+	byte *data = chunk_stored_list[i].data;
+
+	string_free(chunk_stored_list[i].name);
+	for (i++; i < chunk_stored_max; i++)
+		chunk_stored_list[i - 1] = chunk_stored_list[i];
+	chunk_stored_max--;
+
+	return data;
+}
+
+/**
+ * Free every chunk in the list, read back or not
+ */
+void chunk_list_clear(void)
+{
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++)
+		cave_free(chunk_list[i]);
+	mem_free(chunk_list);
+	chunk_list = NULL;
+	chunk_list_max = 0;
+
+	while (chunk_stored_max)
+		mem_free(chunk_stored_take(chunk_stored_max - 1));
+	mem_free(chunk_stored_list);
+	chunk_stored_list = NULL;
+}
+
 /**
  * Remove an entry from the chunk list, return whether it was found
  * \param name the name of the chunk being removed from the list
@@ -170,13 +243,23 @@ bool chunk_list_remove(char *name)
 		}
 	}
 
+	/* It may never have been read back */
+	for (i = 0; i < chunk_stored_max; i++) {
+		if (!strcmp(name, chunk_stored_list[i].name)) {
+			mem_free(chunk_stored_take(i));
+			return TRUE;
+		}
+	}
+
 	return FALSE;
 }
 
 /**
- * Find a chunk by name
+ * Find a chunk by name, reading it from its savefile data if it hasn't been
+ * wanted before
  * \param name the name of the chunk being sought
- * \return the pointer to the chunk
+ * \return the pointer to the chunk, or NULL if there is none or its stored
+ * data could not be read (which is reported, and the data thrown away)
  */
 struct chunk *chunk_find_name(char *name)
 {
@@ -186,6 +269,26 @@ struct chunk *chunk_find_name(char *name)
 		if (!strcmp(name, chunk_list[i]->name))
 			return chunk_list[i];
 
+	for (i = 0; i < chunk_stored_max; i++) {
+		if (!strcmp(name, chunk_stored_list[i].name)) {
+			u32b len = chunk_stored_list[i].len;
+			byte *data = chunk_stored_take(i);
+			struct chunk *c = chunk_read_stored(data, len);
+
+			mem_free(data);
+
+			/* The data is gone, so the caller will have to make a new one */
+			if (!c) {
+				msg("The stored level '%s' could not be read, and will be made afresh.",
+					name);
+				return NULL;
+			}
+
+			chunk_list_add(c);
+			return c;
+		}
+	}
+
 	return NULL;
 }
 
@@ -239,7 +342,8 @@ void symmetry_transform(int *y, int *x, int y0, int x0, int height, int width,
 
 /**
  * Write a chunk, transformed, to a given offset in another chunk.  Note that
- * objects are copied from the old chunk and not retained there
+ * objects and traps are moved from the old chunk and not retained there, so
+ * the old chunk can be freed afterwards
  * \param dest the chunk where the copy is going
  * \param source the chunk being copied
  * \param y0
@@ -287,6 +391,9 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 					obj->iy = dest_y;
 					obj->ix = dest_x;
 				}
+
+				/* The objects now belong to dest */
+				source->squares[y][x].obj = NULL;
 			}
 
 			/* Monsters */
@@ -315,16 +422,21 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				dest_mon->midx = idx;
 				dest_mon->fy = dest_y;
 				dest_mon->fx = dest_x;
+				mon_sched_start(dest, dest_mon);
+				mon_buckets_add(dest, dest_mon);
 
 				/* Held objects */
-				if (source_mon->held_obj)
+				if (source_mon->held_obj) {
 					dest_mon->held_obj = source_mon->held_obj;
+					source_mon->held_obj = NULL;
+				}
 			}
 
 			/* Traps */
 			if (source->squares[y][x].trap) {
 				struct trap *trap = source->squares[y][x].trap;
-				dest->squares[y][x].trap = trap;
+				dest->squares[dest_y][dest_x].trap = trap;
+				source->squares[y][x].trap = NULL;
 
 				/* Traverse the trap list */
 				while (trap) {
@@ -344,6 +456,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 	/* Miscellany */
 	for (i = 0; i < z_info->f_max + 1; i++)
 		dest->feat_count[i] += source->feat_count[i];
+	dest->feat_gen++;
 
 	dest->obj_rating += source->obj_rating;
 	dest->mon_rating += source->mon_rating;
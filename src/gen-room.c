@@ -2958,8 +2958,8 @@ bool build_huge(struct chunk *c, int y0, int x0)
  * Note that we restrict the number of pits/nests to reduce
  * the chance of overflowing the monster list during level creation.
  */
-bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
-	bool finds_own_space)
+static bool room_build_aux(struct chunk *c, int by0, int bx0,
+						   struct room_profile profile, bool finds_own_space)
 {
 	/* Extract blocks */
 	int by1 = by0;
@@ -3026,3 +3026,19 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	/* Success */
 	return TRUE;
 }
+
+/**
+ * Attempt to build a room, charging the time taken to the rooms phase of
+ * generation timing; see room_build_aux() for the parameters.
+ */
+bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
+	bool finds_own_space)
+{
+	bool built;
+
+	gen_phase_begin(GEN_PHASE_ROOMS);
+	built = room_build_aux(c, by0, bx0, profile, finds_own_space);
+	gen_phase_end();
+
+	return built;
+}
@@ -340,6 +340,8 @@ void new_player_spot(struct chunk *c, struct player *p)
 {
     int y, x;
 
+    gen_phase_begin(GEN_PHASE_FEATURES);
+
     /* Try to find a good place to put the player */
     cave_find_in_range(c, &y, 0, c->height, &x, 0, c->width, square_isstart);
 
@@ -352,6 +354,7 @@ void new_player_spot(struct chunk *c, struct player *p)
 		square_set_feat(c, y, x, FEAT_LESS);
 
     player_place(c, p, y, x);
+    gen_phase_end();
 }
 
 
@@ -442,7 +445,9 @@ void place_object(struct chunk *c, int y, int x, int level, bool good, bool grea
 
     if (!square_canputitem(c, y, x)) return;
 
+    gen_phase_begin(GEN_PHASE_OBJECTS);
     new_obj = make_object(c, level, good, great, FALSE, &rating, tval);
+    gen_phase_end();
 	if (!new_obj) return;
 
     new_obj->origin = origin;
@@ -480,7 +485,9 @@ void place_gold(struct chunk *c, int y, int x, int level, byte origin)
 
     if (!square_canputitem(c, y, x)) return;
 
+    gen_phase_begin(GEN_PHASE_OBJECTS);
     money = make_gold(level, "any");
+    gen_phase_end();
 
     money->origin = origin;
     money->origin_depth = level;
@@ -549,6 +556,8 @@ void alloc_stairs(struct chunk *c, int feat, int num, int walls)
 {
     int y, x, i, j, done;
 
+    gen_phase_begin(GEN_PHASE_FEATURES);
+
     /* Place "num" stairs */
     for (i = 0; i < num; i++) {
 		/* Place some stairs */
@@ -567,6 +576,8 @@ void alloc_stairs(struct chunk *c, int feat, int num, int walls)
 			if (walls) walls--;
 		}
     }
+
+    gen_phase_end();
 }
 
 
@@ -584,10 +595,17 @@ void alloc_stairs(struct chunk *c, int feat, int num, int walls)
 void alloc_objects(struct chunk *c, int set, int typ, int num, int depth, byte origin)
 {
     int k, l = 0;
+
+    /* Rubble and traps are part of the layout; the rest are objects */
+    if (typ == TYP_RUBBLE || typ == TYP_TRAP)
+		gen_phase_begin(GEN_PHASE_FEATURES);
+    else
+		gen_phase_begin(GEN_PHASE_OBJECTS);
     for (k = 0; k < num; k++) {
 		bool ok = alloc_object(c, set, typ, depth, origin);
 		if (!ok) l++;
     }
+    gen_phase_end();
 }
 
 
@@ -55,6 +55,20 @@ struct pit_profile *pit_info;
 struct vault *vaults;
 struct cave_profile *cave_profiles;
 
+/*
+ * Per-phase generation timing, off unless a front end turns it on
+ */
+bool gen_timing = FALSE;
+clock_t gen_phase_time[GEN_PHASE_MAX];
+
+#define GEN_PHASE_DEPTH 8
+
+static enum gen_phase gen_phase_stack[GEN_PHASE_DEPTH];
+static int gen_phase_depth = 0;
+static clock_t gen_phase_mark;
+static clock_t gen_attempt_time[GEN_PHASE_MAX];
+static clock_t gen_attempt_mark;
+
 
 static const struct {
 	const char *name;
@@ -435,12 +449,76 @@ static void cleanup_room(void)
 	}
 }
 
+/**
+ * The layout of a room template record, for the cache header
+ */
+static u32b room_cache_layout(void)
+{
+	size_t sizes[] = { sizeof(struct room_template) };
+	return cache_layout(sizes, N_ELEMENTS(sizes));
+}
+
+static bool save_room(void)
+{
+	struct room_template *t;
+	u32b n = 0;
+
+	for (t = room_templates; t; t = t->next)
+		n++;
+	cache_wr_u32b(n);
+
+	for (t = room_templates; t; t = t->next) {
+		cache_wr_string(t->name);
+		cache_wr_string(t->text);
+		cache_wr_byte(t->typ);
+		cache_wr_byte(t->rat);
+		cache_wr_byte(t->hgt);
+		cache_wr_byte(t->wid);
+		cache_wr_byte(t->dor);
+		cache_wr_byte(t->tval);
+	}
+
+	return TRUE;
+}
+
+static bool load_room(void)
+{
+	struct room_template **last = &room_templates;
+	u32b i, n = cache_rd_u32b();
+
+	room_templates = NULL;
+	for (i = 0; i < n && cache_rd_ok(); i++) {
+		struct room_template *t = mem_zalloc(sizeof *t);
+		*last = t;
+		last = &t->next;
+
+		t->name = cache_rd_string();
+		t->text = cache_rd_string();
+		t->typ = cache_rd_byte();
+		t->rat = cache_rd_byte();
+		t->hgt = cache_rd_byte();
+		t->wid = cache_rd_byte();
+		t->dor = cache_rd_byte();
+		t->tval = cache_rd_byte();
+	}
+
+	if (!cache_rd_ok()) {
+		cleanup_room();
+		room_templates = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static struct file_parser room_parser = {
 	"room_template",
 	init_parse_room,
 	run_parse_room,
 	finish_parse_room,
-	cleanup_room
+	cleanup_room,
+	save_room,
+	load_room,
+	room_cache_layout
 };
 
 
@@ -583,12 +661,84 @@ static void cleanup_vault(void)
 	}
 }
 
+/**
+ * The layout of a vault record, for the cache header
+ */
+static u32b vault_cache_layout(void)
+{
+	size_t sizes[] = { sizeof(struct vault) };
+	return cache_layout(sizes, N_ELEMENTS(sizes));
+}
+
+/**
+ * Vaults without a max-depth take it from z_info, so the cache notes it
+ */
+static bool save_vault(void)
+{
+	struct vault *v;
+	u32b n = 0;
+
+	for (v = vaults; v; v = v->next)
+		n++;
+	cache_wr_u32b(z_info->max_depth);
+	cache_wr_u32b(n);
+
+	for (v = vaults; v; v = v->next) {
+		cache_wr_string(v->name);
+		cache_wr_string(v->text);
+		cache_wr_string(v->typ);
+		cache_wr_byte(v->rat);
+		cache_wr_byte(v->hgt);
+		cache_wr_byte(v->wid);
+		cache_wr_byte(v->min_lev);
+		cache_wr_byte(v->max_lev);
+	}
+
+	return TRUE;
+}
+
+static bool load_vault(void)
+{
+	struct vault **last = &vaults;
+	u32b i, n;
+
+	if (cache_rd_u32b() != (u32b)z_info->max_depth)
+		return FALSE;
+	n = cache_rd_u32b();
+
+	vaults = NULL;
+	for (i = 0; i < n && cache_rd_ok(); i++) {
+		struct vault *v = mem_zalloc(sizeof *v);
+		*last = v;
+		last = &v->next;
+
+		v->name = cache_rd_string();
+		v->text = cache_rd_string();
+		v->typ = cache_rd_string();
+		v->rat = cache_rd_byte();
+		v->hgt = cache_rd_byte();
+		v->wid = cache_rd_byte();
+		v->min_lev = cache_rd_byte();
+		v->max_lev = cache_rd_byte();
+	}
+
+	if (!cache_rd_ok()) {
+		cleanup_vault();
+		vaults = NULL;
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static struct file_parser vault_parser = {
 	"vault",
 	init_parse_vault,
 	run_parse_vault,
 	finish_parse_vault,
-	cleanup_vault
+	cleanup_vault,
+	save_vault,
+	load_vault,
+	vault_cache_layout
 };
 
 static void run_template_parser(void) {
@@ -743,6 +893,70 @@ bool labyrinth_check(int depth)
 	return TRUE;
 }
 
+/**
+ * Start timing a generation phase.
+ *
+ * Phases nest; time spent in an inner phase (such as placing the monsters
+ * of a vault while building rooms) is charged to the inner phase only.
+ */
+void gen_phase_begin(enum gen_phase phase)
+{
+	clock_t now;
+
+	if (!gen_timing) return;
+	assert(gen_phase_depth < GEN_PHASE_DEPTH);
+
+	now = clock();
+	if (gen_phase_depth)
+		gen_phase_time[gen_phase_stack[gen_phase_depth - 1]] +=
+			now - gen_phase_mark;
+	gen_phase_stack[gen_phase_depth++] = phase;
+	gen_phase_mark = now;
+}
+
+/**
+ * Stop timing the most recently started generation phase.
+ */
+void gen_phase_end(void)
+{
+	clock_t now;
+
+	if (!gen_timing) return;
+	assert(gen_phase_depth > 0);
+
+	now = clock();
+	gen_phase_time[gen_phase_stack[--gen_phase_depth]] += now - gen_phase_mark;
+	gen_phase_mark = now;
+}
+
+/**
+ * Note the start of an attempt at building a level, so its time can be
+ * taken back out of the phases if the level is thrown away.
+ */
+static void gen_attempt_begin(void)
+{
+	if (!gen_timing) return;
+
+	memcpy(gen_attempt_time, gen_phase_time, sizeof(gen_attempt_time));
+	gen_attempt_mark = clock();
+}
+
+/**
+ * Charge all the time spent on the current attempt to GEN_PHASE_RETRIES,
+ * whichever phases it went on.
+ */
+static void gen_attempt_discard(void)
+{
+	clock_t retries;
+
+	if (!gen_timing) return;
+	assert(gen_phase_depth == 0);
+
+	retries = gen_attempt_time[GEN_PHASE_RETRIES] + clock() - gen_attempt_mark;
+	memcpy(gen_phase_time, gen_attempt_time, sizeof(gen_phase_time));
+	gen_phase_time[GEN_PHASE_RETRIES] = retries;
+}
+
 /**
  * Find a cave_profile by name
  * \param name is the name of the cave_profile being looked for
@@ -850,6 +1064,18 @@ static void cave_clear(struct chunk *c, struct player *p)
  * \param p is the current player struct, in practice the global player
  */
 void cave_generate(struct chunk **c, struct player *p)
+{
+	cave_generate_profile(c, p, NULL);
+}
+
+/**
+ * Generate a level using a given cave profile.
+ * \param c is the level we're going to end up with
+ * \param p is the current player struct
+ * \param profile is the profile to build with, or NULL to choose one by depth
+ */
+void cave_generate_profile(struct chunk **c, struct player *p,
+						   const struct cave_profile *profile)
 {
 	const char *error = "no generation";
 	int y, x, tries = 0;
@@ -862,6 +1088,7 @@ void cave_generate(struct chunk **c, struct player *p)
 		struct dun_data dun_body;
 
 		error = NULL;
+		gen_attempt_begin();
 
 		/* Mark the dungeon as being unready (to avoid artifact loss, etc) */
 		character_dungeon = FALSE;
@@ -874,7 +1101,7 @@ void cave_generate(struct chunk **c, struct player *p)
 		dun->tunn = mem_zalloc(z_info->tunn_grid_max * sizeof(struct loc));
 
 		/* Choose a profile and build the level */
-		dun->profile = choose_profile(p->depth);
+		dun->profile = profile ? profile : choose_profile(p->depth);
 		chunk = dun->profile->builder(p);
 		if (!chunk) {
 			error = "Failed to find builder";
@@ -882,6 +1109,7 @@ void cave_generate(struct chunk **c, struct player *p)
 			mem_free(dun->door);
 			mem_free(dun->wall);
 			mem_free(dun->tunn);
+			gen_attempt_discard();
 			continue;
 		}
 
@@ -904,6 +1132,7 @@ void cave_generate(struct chunk **c, struct player *p)
 		}
 
 		/* Clear generation flags. */
+		gen_phase_begin(GEN_PHASE_FINISH);
 		for (y = 0; y < chunk->height; y++) {
 			for (x = 0; x < chunk->width; x++) {
 				sqinfo_off(chunk->squares[y][x].info, SQUARE_WALL_INNER);
@@ -912,6 +1141,7 @@ void cave_generate(struct chunk **c, struct player *p)
 				sqinfo_off(chunk->squares[y][x].info, SQUARE_MON_RESTRICT);
 			}
 		}
+		gen_phase_end();
 
 		/* Regenerate levels that overflow their maxima */
 		if (cave_monster_max(chunk) >= z_info->level_monster_max)
@@ -926,10 +1156,15 @@ void cave_generate(struct chunk **c, struct player *p)
 		mem_free(dun->door);
 		mem_free(dun->wall);
 		mem_free(dun->tunn);
+
+		if (error)
+			gen_attempt_discard();
 	}
 
 	if (error) quit_fmt("cave_generate() failed 100 times!");
 
+	gen_phase_begin(GEN_PHASE_FINISH);
+
 	/* Free the old cave, use the new one */
 	if (*c)
 		cave_clear(*c, p);
@@ -963,6 +1198,7 @@ void cave_generate(struct chunk **c, struct player *p)
 		cave_known();
 
 	(*c)->created_at = turn;
+	gen_phase_end();
 }
 
 /**
@@ -240,6 +240,35 @@ struct room_template {
 struct dun_data *dun;
 struct vault *vaults;
 struct room_template *room_templates;
+extern struct cave_profile *cave_profiles;
+
+/**
+ * Parts of level generation which can be timed separately
+ */
+enum gen_phase {
+	GEN_PHASE_ALLOC,		/* Allocating chunks and filling them with rock */
+	GEN_PHASE_ROOMS,
+	GEN_PHASE_TUNNELS,
+	GEN_PHASE_STREAMERS,
+	GEN_PHASE_MONSTERS,
+	GEN_PHASE_OBJECTS,
+	GEN_PHASE_CONNECT,		/* Joining up disconnected areas */
+	GEN_PHASE_FEATURES,		/* Stairs, rubble, traps and the player */
+	GEN_PHASE_FINISH,		/* Tidying up and rating a finished level */
+	GEN_PHASE_RETRIES,		/* All of the levels which were thrown away */
+
+	GEN_PHASE_MAX
+};
+
+extern bool gen_timing;
+extern clock_t gen_phase_time[GEN_PHASE_MAX];
+
+/* generate.c */
+void gen_phase_begin(enum gen_phase phase);
+void gen_phase_end(void);
+const struct cave_profile *find_cave_profile(char *name);
+void cave_generate_profile(struct chunk **c, struct player *p,
+						   const struct cave_profile *profile);
 
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p);
@@ -254,10 +283,25 @@ struct chunk *lair_gen(struct player *p);
 struct chunk *gauntlet_gen(struct player *p);
 
 /* gen-chunk.c */
+
+/**
+ * A chunk as it was in the savefile, kept until it is wanted
+ */
+struct chunk_stored {
+	char *name;
+	byte *data;
+	u32b len;
+};
+
+extern struct chunk_stored *chunk_stored_list;
+extern u16b chunk_stored_max;
+
 struct chunk *chunk_write(int y0, int x0, int height, int width, bool monsters,
 						 bool objects, bool traps);
 void chunk_list_add(struct chunk *c);
 bool chunk_list_remove(char *name);
+void chunk_stored_add(const char *name, byte *data, u32b len);
+void chunk_list_clear(void);
 struct chunk *chunk_find_name(char *name);
 bool chunk_find(struct chunk *c);
 bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
@@ -750,6 +750,7 @@ static struct file_parser constants_parser = {
 void init_game_constants(void)
 {
 	event_signal_message(EVENT_INITSTATUS, 0, "Initializing constants");
+	parse_cache_begin();
 	if (run_parser(&constants_parser))
 		quit_fmt("Cannot initialize constants.");
 }
@@ -1310,6 +1311,13 @@ static errr run_parse_object(struct parser *p) {
 	return parse_file(p, "object");
 }
 
+/**
+ * Compiled object data.  The artifacts add kinds of their own to k_info, so
+ * remember where the object file's kinds end.
+ */
+static int object_kinds_parsed;
+
+
 static errr finish_parse_object(struct parser *p) {
 	struct object_kind *k, *next = NULL;
 
@@ -1338,32 +1346,363 @@ static errr finish_parse_object(struct parser *p) {
 		mem_free(k);
 	}
 	z_info->k_max += 1;
+	object_kinds_parsed = z_info->k_max;
 
 	/*objkinds = parser_priv(p); not used yet, when used, remove the mem_free(k); above */
 	parser_destroy(p);
 	return 0;
 }
 
+static void free_kind(struct object_kind *k)
+{
+	string_free(k->name);
+	mem_free(k->text);
+	mem_free(k->effect_msg);
+	free_brand(k->brands);
+	free_slay(k->slays);
+	free_effect(k->effect);
+}
+
 static void cleanup_object(void)
 {
 	int idx;
-	for (idx = 0; idx < z_info->k_max; idx++) {
-		string_free(k_info[idx].name);
-		mem_free(k_info[idx].text);
-		mem_free(k_info[idx].effect_msg);
-		free_brand(k_info[idx].brands);
-		free_slay(k_info[idx].slays);
-		free_effect(k_info[idx].effect);
-	}
+	for (idx = 0; idx < z_info->k_max; idx++)
+		free_kind(&k_info[idx]);
 	mem_free(k_info);
 }
+static void save_element_info(const struct element_info *el_info)
+{
+	int i;
+	for (i = 0; i < ELEM_MAX; i++) {
+		cache_wr_u32b(el_info[i].res_level);
+		cache_wr_byte(el_info[i].flags);
+	}
+}
+
+static void load_element_info(struct element_info *el_info)
+{
+	int i;
+	for (i = 0; i < ELEM_MAX; i++) {
+		el_info[i].res_level = (s16b)cache_rd_u32b();
+		el_info[i].flags = cache_rd_byte();
+	}
+}
+
+static void save_brands(const struct brand *b)
+{
+	const struct brand *c;
+	u32b n = 0;
+
+	for (c = b; c; c = c->next)
+		n++;
+	cache_wr_u32b(n);
+	for (c = b; c; c = c->next) {
+		cache_wr_string(c->name);
+		cache_wr_u32b(c->element);
+		cache_wr_u32b(c->multiplier);
+		cache_wr_byte(c->known);
+	}
+}
+
+static struct brand *load_brands(void)
+{
+	struct brand *brands = NULL, **last = &brands;
+	u32b i, n = cache_rd_u32b();
+
+	for (i = 0; i < n && cache_rd_ok(); i++) {
+		struct brand *b = mem_zalloc(sizeof *b);
+		*last = b;
+		last = &b->next;
+
+		b->name = cache_rd_string();
+		b->element = cache_rd_u32b();
+		b->multiplier = cache_rd_u32b();
+		b->known = cache_rd_byte();
+	}
+	return brands;
+}
+
+static void save_slays(const struct slay *s)
+{
+	const struct slay *c;
+	u32b n = 0;
+
+	for (c = s; c; c = c->next)
+		n++;
+	cache_wr_u32b(n);
+	for (c = s; c; c = c->next) {
+		cache_wr_string(c->name);
+		cache_wr_u32b(c->race_flag);
+		cache_wr_u32b(c->multiplier);
+		cache_wr_byte(c->known);
+	}
+}
+
+static struct slay *load_slays(void)
+{
+	struct slay *slays = NULL, **last = &slays;
+	u32b i, n = cache_rd_u32b();
+
+	for (i = 0; i < n && cache_rd_ok(); i++) {
+		struct slay *s = mem_zalloc(sizeof *s);
+		*last = s;
+		last = &s->next;
+
+		s->name = cache_rd_string();
+		s->race_flag = cache_rd_u32b();
+		s->multiplier = cache_rd_u32b();
+		s->known = cache_rd_byte();
+	}
+	return slays;
+}
+
+/**
+ * Effects keep the text their dice and expressions were parsed from, and are
+ * parsed again on load, so they come back just as the parser made them
+ */
+static void save_effects(const struct effect *e)
+{
+	const struct effect *c;
+	u32b n = 0;
+
+	for (c = e; c; c = c->next)
+		n++;
+	cache_wr_u32b(n);
+
+	for (c = e; c; c = c->next) {
+		const char *name;
+		const expression_t *expr;
+		int i;
+
+		cache_wr_u32b(c->index);
+		for (i = 0; i < 3; i++)
+			cache_wr_u32b(c->params[i]);
+
+		cache_wr_string(c->dice ? dice_text(c->dice) : NULL);
+		if (!c->dice)
+			continue;
+
+		/* Bound expressions, ended by a NULL name */
+		for (i = 0; dice_expression_slot(c->dice, i, &name, &expr); i++) {
+			if (!name || !expr)
+				continue;
+			cache_wr_string(name);
+			cache_wr_string(spell_value_base_name(expression_base_value(expr)));
+			cache_wr_string(expression_text(expr));
+		}
+		cache_wr_string(NULL);
+	}
+}
+
+static struct effect *load_effects(void)
+{
+	struct effect *effects = NULL, **last = &effects;
+	u32b i, n = cache_rd_u32b();
+
+	for (i = 0; i < n && cache_rd_ok(); i++) {
+		struct effect *e = mem_zalloc(sizeof *e);
+		char *text, *name;
+		int j;
+
+		*last = e;
+		last = &e->next;
+
+		e->index = cache_rd_u32b();
+		for (j = 0; j < 3; j++)
+			e->params[j] = (s32b)cache_rd_u32b();
+
+		text = cache_rd_string();
+		if (!text)
+			continue;
+		e->dice = dice_new();
+		if (!dice_parse_string(e->dice, text))
+			cache_rd_fail();
+		string_free(text);
+
+		while ((name = cache_rd_string())) {
+			char *base = cache_rd_string();
+			char *ops = cache_rd_string();
+			expression_t *expr = expression_new();
+
+			if (base)
+				expression_set_base_value(expr,
+										  spell_value_base_by_name(base));
+			if ((ops && expression_add_operations_string(expr, ops) < 0) ||
+				dice_bind_expression(e->dice, name, expr) < 0)
+				cache_rd_fail();
+
+			expression_free(expr);
+			string_free(ops);
+			string_free(base);
+			string_free(name);
+		}
+	}
+	return effects;
+}
+
+/**
+ * Write an object kind; its base is always the one for its tval, and the
+ * next kind is written as its index plus one
+ */
+static void save_kind(const struct object_kind *k)
+{
+	int i;
+
+	cache_wr_string(k->name);
+	cache_wr_string(k->text);
+	cache_wr_byte(k->base != NULL);
+	cache_wr_u32b(k->next ? k->next - k_info + 1 : 0);
+	cache_wr_u32b(k->kidx);
+	cache_wr_u32b(k->tval);
+	cache_wr_u32b(k->sval);
+	cache_wr_random(k->pval);
+	cache_wr_random(k->to_h);
+	cache_wr_random(k->to_d);
+	cache_wr_random(k->to_a);
+	cache_wr_u32b(k->ac);
+	cache_wr_u32b(k->dd);
+	cache_wr_u32b(k->ds);
+	cache_wr_u32b(k->weight);
+	cache_wr_u32b(k->cost);
+	cache_wr_flags(k->flags, OF_SIZE);
+	cache_wr_flags(k->kind_flags, KF_SIZE);
+	for (i = 0; i < OBJ_MOD_MAX; i++)
+		cache_wr_random(k->modifiers[i]);
+	save_element_info(k->el_info);
+	save_brands(k->brands);
+	save_slays(k->slays);
+	cache_wr_byte(k->d_attr);
+	cache_wr_u32b(k->d_char);
+	cache_wr_u32b(k->alloc_prob);
+	cache_wr_u32b(k->alloc_min);
+	cache_wr_u32b(k->alloc_max);
+	cache_wr_u32b(k->level);
+	save_effects(k->effect);
+	cache_wr_u32b(k->power);
+	cache_wr_string(k->effect_msg);
+	cache_wr_random(k->time);
+	cache_wr_random(k->charge);
+	cache_wr_u32b(k->gen_mult_prob);
+	cache_wr_random(k->stack_size);
+}
+
+/**
+ * Read an object kind into `k`, which is part of the `n` long array `kinds`;
+ * the caller counts it against its base
+ */
+static void load_kind(struct object_kind *k, struct object_kind *kinds,
+					  u32b n)
+{
+	bool has_base;
+	u32b next;
+	int i;
+
+	k->name = cache_rd_string();
+	k->text = cache_rd_string();
+	has_base = cache_rd_byte();
+	next = cache_rd_u32b();
+	k->kidx = cache_rd_u32b();
+	k->tval = cache_rd_u32b();
+	k->sval = cache_rd_u32b();
+	k->pval = cache_rd_random();
+	k->to_h = cache_rd_random();
+	k->to_d = cache_rd_random();
+	k->to_a = cache_rd_random();
+	k->ac = cache_rd_u32b();
+	k->dd = cache_rd_u32b();
+	k->ds = cache_rd_u32b();
+	k->weight = cache_rd_u32b();
+	k->cost = cache_rd_u32b();
+	cache_rd_flags(k->flags, OF_SIZE);
+	cache_rd_flags(k->kind_flags, KF_SIZE);
+	for (i = 0; i < OBJ_MOD_MAX; i++)
+		k->modifiers[i] = cache_rd_random();
+	load_element_info(k->el_info);
+	k->brands = load_brands();
+	k->slays = load_slays();
+	k->d_attr = cache_rd_byte();
+	k->d_char = cache_rd_u32b();
+	k->alloc_prob = cache_rd_u32b();
+	k->alloc_min = cache_rd_u32b();
+	k->alloc_max = cache_rd_u32b();
+	k->level = cache_rd_u32b();
+	k->effect = load_effects();
+	k->power = cache_rd_u32b();
+	k->effect_msg = cache_rd_string();
+	k->time = cache_rd_random();
+	k->charge = cache_rd_random();
+	k->gen_mult_prob = cache_rd_u32b();
+	k->stack_size = cache_rd_random();
+
+	/* Turn the indices back into pointers */
+	if (k->tval < 0 || k->tval >= TV_MAX || next > n)
+		cache_rd_fail();
+	else {
+		k->base = has_base ? &kb_info[k->tval] : NULL;
+		k->next = next ? &kinds[next - 1] : NULL;
+	}
+}
+
+/**
+ * What load_kind() and the helpers it calls read into
+ */
+#define KIND_CACHE_LAYOUT \
+	sizeof(struct object_kind), sizeof(struct element_info), \
+	sizeof(struct brand), sizeof(struct slay), sizeof(struct effect), \
+	OF_SIZE, KF_SIZE, OBJ_MOD_MAX, ELEM_MAX
+
+static u32b object_cache_layout(void)
+{
+	size_t sizes[] = { KIND_CACHE_LAYOUT };
+	return cache_layout(sizes, N_ELEMENTS(sizes));
+}
+
+static bool save_object(void)
+{
+	int i;
+
+	cache_wr_u32b(z_info->k_max);
+	for (i = 0; i < z_info->k_max; i++)
+		save_kind(&k_info[i]);
+
+	return TRUE;
+}
+
+static bool load_object(void)
+{
+	u32b i, n = cache_rd_u32b();
+
+	if (!n || n > 65535)
+		return FALSE;
+
+	z_info->k_max = n;
+	k_info = mem_zalloc(n * sizeof(*k_info));
+	for (i = 0; i < n && cache_rd_ok(); i++)
+		load_kind(&k_info[i], k_info, n);
+
+	if (!cache_rd_done()) {
+		cleanup_object();
+		return FALSE;
+	}
+
+	/* Count the kinds of each tval, as parse_object_type() does */
+	for (i = 0; i < n; i++)
+		if (k_info[i].base)
+			k_info[i].base->num_svals++;
+
+	object_kinds_parsed = z_info->k_max;
+	return TRUE;
+}
 
 static struct file_parser object_parser = {
 	"object",
 	init_parse_object,
 	run_parse_object,
 	finish_parse_object,
-	cleanup_object
+	cleanup_object,
+	save_object,
+	load_object,
+	object_cache_layout
 };
 
 /**
@@ -1890,12 +2229,202 @@ static void cleanup_artifact(void)
 	mem_free(a_info);
 }
 
+/**
+ * The artifact cache also holds the kinds made for special artifacts, and the
+ * look the graphics lines gave to the object file's special artifact kinds
+ */
+static u32b artifact_cache_layout(void)
+{
+	size_t sizes[] = { KIND_CACHE_LAYOUT, sizeof(struct artifact) };
+	return cache_layout(sizes, N_ELEMENTS(sizes));
+}
+
+static bool save_artifact(void)
+{
+	int i, j;
+	u32b n = 0;
+
+	cache_wr_u32b(z_info->k_max - object_kinds_parsed);
+	for (i = object_kinds_parsed; i < z_info->k_max; i++)
+		save_kind(&k_info[i]);
+
+	for (i = 0; i < object_kinds_parsed; i++)
+		if (kf_has(k_info[i].kind_flags, KF_INSTA_ART))
+			n++;
+	cache_wr_u32b(n);
+	for (i = 0; i < object_kinds_parsed; i++) {
+		if (!kf_has(k_info[i].kind_flags, KF_INSTA_ART))
+			continue;
+		cache_wr_u32b(i);
+		cache_wr_byte(k_info[i].d_attr);
+		cache_wr_u32b(k_info[i].d_char);
+	}
+
+	cache_wr_u32b(z_info->a_max);
+	for (i = 0; i < z_info->a_max; i++) {
+		struct artifact *a = &a_info[i];
+
+		cache_wr_string(a->name);
+		cache_wr_string(a->text);
+		cache_wr_u32b(a->aidx);
+		cache_wr_u32b(a->next ? a->next - a_info + 1 : 0);
+		cache_wr_u32b(a->tval);
+		cache_wr_u32b(a->sval);
+		cache_wr_u32b(a->to_h);
+		cache_wr_u32b(a->to_d);
+		cache_wr_u32b(a->to_a);
+		cache_wr_u32b(a->ac);
+		cache_wr_u32b(a->dd);
+		cache_wr_u32b(a->ds);
+		cache_wr_u32b(a->weight);
+		cache_wr_u32b(a->cost);
+		cache_wr_flags(a->flags, OF_SIZE);
+		for (j = 0; j < OBJ_MOD_MAX; j++)
+			cache_wr_u32b(a->modifiers[j]);
+		save_element_info(a->el_info);
+		save_brands(a->brands);
+		save_slays(a->slays);
+		cache_wr_u32b(a->level);
+		cache_wr_u32b(a->alloc_prob);
+		cache_wr_u32b(a->alloc_min);
+		cache_wr_u32b(a->alloc_max);
+		cache_wr_u32b(a->activation ? a->activation->index : 0);
+		cache_wr_string(a->alt_msg);
+		cache_wr_random(a->time);
+	}
+
+	return TRUE;
+}
+
+static bool load_artifact(void)
+{
+	struct object_kind *kinds;
+	u32b *insta_idx = NULL;
+	byte *insta_attr = NULL;
+	wchar_t *insta_char = NULL;
+	int num_svals[TV_MAX];
+	u32b i, n_kinds, n_insta, n;
+	int j;
+
+	/* Kinds for special artifacts, kept aside until all is read */
+	n_kinds = cache_rd_u32b();
+	if (n_kinds > 65535)
+		return FALSE;
+	kinds = mem_zalloc((n_kinds + 1) * sizeof(*kinds));
+	for (i = 0; i < n_kinds && cache_rd_ok(); i++)
+		load_kind(&kinds[i], kinds, n_kinds);
+
+	n_insta = cache_rd_u32b();
+	if (n_insta <= (u32b)object_kinds_parsed) {
+		insta_idx = mem_zalloc((n_insta + 1) * sizeof(*insta_idx));
+		insta_attr = mem_zalloc((n_insta + 1) * sizeof(*insta_attr));
+		insta_char = mem_zalloc((n_insta + 1) * sizeof(*insta_char));
+		for (i = 0; i < n_insta && cache_rd_ok(); i++) {
+			insta_idx[i] = cache_rd_u32b();
+			insta_attr[i] = cache_rd_byte();
+			insta_char[i] = cache_rd_u32b();
+			if (insta_idx[i] >= (u32b)object_kinds_parsed)
+				cache_rd_fail();
+		}
+	} else
+		cache_rd_fail();
+
+	n = cache_rd_u32b();
+	if (n > 65535)
+		cache_rd_fail();
+	z_info->a_max = cache_rd_ok() ? n : 0;
+	a_info = mem_zalloc((z_info->a_max + 1) * sizeof(*a_info));
+	for (i = 0; i < z_info->a_max && cache_rd_ok(); i++) {
+		struct artifact *a = &a_info[i];
+		u32b next, act;
+
+		a->name = cache_rd_string();
+		a->text = cache_rd_string();
+		a->aidx = cache_rd_u32b();
+		next = cache_rd_u32b();
+		a->tval = cache_rd_u32b();
+		a->sval = cache_rd_u32b();
+		a->to_h = cache_rd_u32b();
+		a->to_d = cache_rd_u32b();
+		a->to_a = cache_rd_u32b();
+		a->ac = cache_rd_u32b();
+		a->dd = cache_rd_u32b();
+		a->ds = cache_rd_u32b();
+		a->weight = cache_rd_u32b();
+		a->cost = cache_rd_u32b();
+		cache_rd_flags(a->flags, OF_SIZE);
+		for (j = 0; j < OBJ_MOD_MAX; j++)
+			a->modifiers[j] = (s32b)cache_rd_u32b();
+		load_element_info(a->el_info);
+		a->brands = load_brands();
+		a->slays = load_slays();
+		a->level = cache_rd_u32b();
+		a->alloc_prob = cache_rd_u32b();
+		a->alloc_min = cache_rd_u32b();
+		a->alloc_max = cache_rd_u32b();
+		act = cache_rd_u32b();
+		a->alt_msg = cache_rd_string();
+		a->time = cache_rd_random();
+
+		/* Turn the indices back into pointers */
+		if (next > z_info->a_max || act >= (u32b)z_info->act_max)
+			cache_rd_fail();
+		else {
+			a->next = next ? &a_info[next - 1] : NULL;
+			a->activation = act ? &activations[act] : NULL;
+		}
+	}
+
+	/* The new kinds must take the svals write_dummy_object_record() gave */
+	for (j = 0; j < TV_MAX; j++)
+		num_svals[j] = kb_info[j].num_svals;
+	for (i = 0; i < n_kinds && cache_rd_ok(); i++) {
+		if (kinds[i].kidx != object_kinds_parsed + i || kinds[i].next ||
+			!kinds[i].base || kinds[i].sval != ++num_svals[kinds[i].tval])
+			cache_rd_fail();
+	}
+
+	if (!cache_rd_done()) {
+		for (i = 0; i < n_kinds; i++)
+			free_kind(&kinds[i]);
+		mem_free(kinds);
+		mem_free(insta_idx);
+		mem_free(insta_attr);
+		mem_free(insta_char);
+		cleanup_artifact();
+		return FALSE;
+	}
+
+	/* Add the new kinds to k_info as write_dummy_object_record() does */
+	if (n_kinds) {
+		z_info->k_max += n_kinds;
+		k_info = mem_realloc(k_info, (z_info->k_max + 1) * sizeof(*k_info));
+		memcpy(&k_info[object_kinds_parsed], kinds, n_kinds * sizeof(*kinds));
+		memset(&k_info[z_info->k_max], 0, sizeof(*k_info));
+		for (i = 0; i < n_kinds; i++)
+			k_info[object_kinds_parsed + i].base->num_svals++;
+	}
+	for (i = 0; i < n_insta; i++) {
+		k_info[insta_idx[i]].d_attr = insta_attr[i];
+		k_info[insta_idx[i]].d_char = insta_char[i];
+	}
+
+	mem_free(kinds);
+	mem_free(insta_idx);
+	mem_free(insta_attr);
+	mem_free(insta_char);
+	return TRUE;
+}
+
 static struct file_parser artifact_parser = {
 	"artifact",
 	init_parse_artifact,
 	run_parse_artifact,
 	finish_parse_artifact,
-	cleanup_artifact
+	cleanup_artifact,
+	save_artifact,
+	load_artifact,
+	artifact_cache_layout
 };
 
 /**
@@ -4414,6 +4943,9 @@ static struct init_module arrays_module = {
 
 extern struct init_module z_quark_module;
 extern struct init_module generate_module;
+extern struct init_module obj_lookup_module;
+extern struct init_module mon_lookup_module;
+extern struct init_module trap_lookup_module;
 extern struct init_module obj_make_module;
 extern struct init_module ignore_module;
 extern struct init_module mon_make_module;
@@ -4428,6 +4960,9 @@ static struct init_module *modules[] = {
 	&messages_module,
 	&player_module,
 	&arrays_module,
+	&obj_lookup_module,
+	&mon_lookup_module,
+	&trap_lookup_module,
 	&generate_module,
 	&obj_make_module,
 	&ignore_module,
@@ -4492,9 +5027,7 @@ void cleanup_angband(void)
 	event_remove_all_handlers();
 
 	/* Free the chunk list */
-	for (i = 0; i < chunk_list_max; i++)
-		cave_free(chunk_list[i]);
-	mem_free(chunk_list);
+	chunk_list_clear();
 
 	/* Free the main cave */
 	if (cave)
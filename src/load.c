@@ -148,16 +148,12 @@ static struct object *rd_item(void)
 	rd_u16b(&obj->origin_xtra);
 	rd_byte(&obj->ignore);
 
-	for (i = 0; i < of_size; i++)
-		rd_byte(&obj->flags[i]);
+	rd_bytes(obj->flags, of_size);
 
 	of_wipe(obj->known_flags);
 
-	for (i = 0; i < of_size; i++)
-		rd_byte(&obj->known_flags[i]);
-
-	for (i = 0; i < id_size; i++)
-		rd_byte(&obj->id_flags[i]);
+	rd_bytes(obj->known_flags, of_size);
+	rd_bytes(obj->id_flags, id_size);
 
 	for (i = 0; i < obj_mod_max; i++) {
 		rd_s16b(&obj->modifiers[i]);
@@ -276,11 +272,8 @@ static bool rd_monster(struct chunk *c, struct monster *mon)
 		rd_s16b(&mon->m_timed[j]);
 
 	/* Read and extract the flag */
-	for (j = 0; j < mflag_size; j++)
-		rd_byte(&mon->mflag[j]);
-
-	for (j = 0; j < of_size; j++)
-		rd_byte(&mon->known_pstate.flags[j]);
+	rd_bytes(mon->mflag, mflag_size);
+	rd_bytes(mon->known_pstate.flags, of_size);
 
 	for (j = 0; j < elem_max; j++)
 		rd_s16b(&mon->known_pstate.el_info[j].res_level);
@@ -318,16 +311,13 @@ static bool rd_monster(struct chunk *c, struct monster *mon)
  */
 static void rd_trap(struct trap *trap)
 {
-    int i;
-
     rd_byte(&trap->t_idx);
     trap->kind = &trap_info[trap->t_idx];
     rd_byte(&trap->fy);
     rd_byte(&trap->fx);
     rd_byte(&trap->xtra);
 
-    for (i = 0; i < trf_size; i++)
-		rd_byte(&trap->flags[i]);
+    rd_bytes(trap->flags, trf_size);
 }
 
 /**
@@ -352,9 +342,9 @@ int rd_randomizer(void)
 	state_i = state_i % RAND_DEG;
     
 	/* RNG variables */
-	rd_u32b(&z0);
-	rd_u32b(&z1);
-	rd_u32b(&z2);
+	rd_u32b(&Rand_context->z0);
+	rd_u32b(&Rand_context->z1);
+	rd_u32b(&Rand_context->z2);
     
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
@@ -821,6 +811,7 @@ int rd_ignore(void)
 	rd_u16b(&inscriptions);
 
 	/* Read the autoinscriptions array */
+	quarks_reserve(inscriptions);
 	for (i = 0; i < inscriptions; i++) {
 		char tmp[80];
 		s16b kidx;
@@ -1038,47 +1029,18 @@ int rd_stores(void) { return rd_stores_aux(rd_item); }
 
 
 /**
- * Read the dungeon
- *
- * The monsters/objects must be loaded in the same order
- * that they were stored, since the actual indexes matter.
- *
- * Note that the size of the dungeon is now the currrent dimensions of the
- * cave global variable.
- *
- * Note that dungeon objects, including objects held by monsters, are
- * placed directly into the dungeon, using "object_copy()", which will
- * copy "iy", "ix", and "held_m_idx", leaving "next_o_idx" blank for
- * objects held by monsters, since it is not saved in the savefile.
- *
- * After loading the monsters, the objects being held by monsters are
- * linked directly into those monsters.
+ * Read the grids of a chunk from the old byte run length encoding
  */
-static int rd_dungeon_aux(struct chunk **c)
+static void rd_grids_rle(struct chunk *c)
 {
-	struct chunk *c1 = *c;
 	int i, n, y, x;
-
-	u16b height, width;
-
 	byte count;
 	byte tmp8u;
-	u16b tmp16u;
-	char name[100];
-
-	/* Header info */
-	rd_string(name, sizeof(name));
-	rd_u16b(&height);
-	rd_u16b(&width);
-
-	/* We need a cave struct */
-	c1 = cave_new(height, width);
-	c1->name = string_make(name);
 
     /* Run length decoding of cave->squares[y][x].info */
 	for (n = 0; n < square_size; n++) {
 		/* Load the dungeon data */
-		for (x = y = 0; y < c1->height; ) {
+		for (x = y = 0; y < c->height; ) {
 			/* Grab RLE info */
 			rd_byte(&count);
 			rd_byte(&tmp8u);
@@ -1086,22 +1048,22 @@ static int rd_dungeon_aux(struct chunk **c)
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
 				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
+				c->squares[y][x].info[n] = tmp8u;
 
 				/* Advance/Wrap */
-				if (++x >= c1->width) {
+				if (++x >= c->width) {
 					/* Wrap */
 					x = 0;
 
 					/* Advance/Wrap */
-					if (++y >= c1->height) break;
+					if (++y >= c->height) break;
 				}
 			}
 		}
 	}
 
 	/* Run length decoding of dungeon data */
-	for (x = y = 0; y < c1->height; ) {
+	for (x = y = 0; y < c->height; ) {
 		/* Grab RLE info */
 		rd_byte(&count);
 		rd_byte(&tmp8u);
@@ -1109,19 +1071,193 @@ static int rd_dungeon_aux(struct chunk **c)
 		/* Apply the RLE info */
 		for (i = count; i > 0; i--) {
 			/* Extract "feat" */
-			square_set_feat(c1, y, x, tmp8u);
+			square_set_feat(c, y, x, tmp8u);
 
 			/* Advance/Wrap */
-			if (++x >= c1->width) {
+			if (++x >= c->width) {
 				/* Wrap */
 				x = 0;
 
 				/* Advance/Wrap */
-				if (++y >= c1->height) break;
+				if (++y >= c->height) break;
 			}
 		}
 	}
+}
 
+/**
+ * Read a run header, as written by wr_plane_run()
+ */
+static void rd_plane_run(u32b *count, byte *kind)
+{
+	u32b v = 0;
+	int shift = 0;
+	byte tmp8u;
+
+	do {
+		rd_byte(&tmp8u);
+		if (shift < 32)
+			v |= (u32b)(tmp8u & 0x7F) << shift;
+		shift += 7;
+	} while (tmp8u & 0x80);
+
+	*count = v >> 2;
+	*kind = v & 0x03;
+}
+
+/**
+ * Read `len` bytes of plane, `width` to a row, copying from ref or the row
+ * above where the savefile says to
+ */
+static int rd_plane(byte *plane, const byte *ref, u32b len, u32b width)
+{
+	u32b i = 0, count;
+	byte kind;
+
+	while (i < len) {
+		rd_plane_run(&count, &kind);
+		if (!count || count > len - i) {
+			note("Broken grid plane!");
+			return -1;
+		}
+
+		switch (kind) {
+			case PLANE_REPEAT: {
+				byte tmp8u;
+
+				rd_byte(&tmp8u);
+				memset(plane + i, tmp8u, count);
+				break;
+			}
+			case PLANE_LITERAL: {
+				rd_bytes(plane + i, count);
+				break;
+			}
+			case PLANE_SAME: {
+				if (!ref) {
+					note("Broken grid plane!");
+					return -1;
+				}
+				memcpy(plane + i, ref + i, count);
+				break;
+			}
+			case PLANE_ABOVE: {
+				u32b j;
+
+				if (i < width) {
+					note("Broken grid plane!");
+					return -1;
+				}
+
+				/* The run may overlap the row it copies */
+				for (j = i; j < i + count; j++)
+					plane[j] = plane[j - width];
+				break;
+			}
+		}
+		i += count;
+	}
+
+	return 0;
+}
+
+/**
+ * Read the grids of a chunk, as a plane for each info byte and then one for
+ * the terrain, possibly as differences from ref
+ */
+static int rd_grids_planes(struct chunk *c, struct chunk *ref)
+{
+	u32b len = c->height * c->width;
+	byte *plane, *ref_plane = NULL;
+	byte delta;
+	size_t n;
+	int y, x;
+	int err = 0;
+
+	rd_byte(&delta);
+	if (delta) {
+		if (!ref || ref->height != c->height || ref->width != c->width) {
+			note("Missing reference for the grids!");
+			return -1;
+		}
+		ref_plane = mem_alloc(len);
+	}
+
+	plane = mem_alloc(len);
+	for (n = 0; n <= square_size; n++) {
+		const byte *p = plane;
+
+		/* Fill in the reference plane, which is laid out the same way */
+		if (ref_plane) {
+			byte *q = ref_plane;
+
+			for (y = 0; y < ref->height; y++)
+				for (x = 0; x < ref->width; x++)
+					*q++ = (n == square_size) ? ref->squares[y][x].feat :
+						(n < SQUARE_SIZE) ? ref->squares[y][x].info[n] : 0;
+		}
+
+		err = rd_plane(plane, ref_plane, len, c->width);
+		if (err) break;
+
+		/* Info planes this version doesn't know about are dropped */
+		for (y = 0; y < c->height; y++) {
+			for (x = 0; x < c->width; x++, p++) {
+				if (n == square_size)
+					square_set_feat(c, y, x, *p);
+				else if (n < SQUARE_SIZE)
+					c->squares[y][x].info[n] = *p;
+			}
+		}
+	}
+	mem_free(plane);
+	mem_free(ref_plane);
+
+	return err;
+}
+
+/**
+ * Read the dungeon
+ *
+ * The monsters/objects must be loaded in the same order
+ * that they were stored, since the actual indexes matter.
+ *
+ * Note that the size of the dungeon is now the currrent dimensions of the
+ * cave global variable.
+ *
+ * Note that dungeon objects, including objects held by monsters, are
+ * placed directly into the dungeon, using "object_copy()", which will
+ * copy "iy", "ix", and "held_m_idx", leaving "next_o_idx" blank for
+ * objects held by monsters, since it is not saved in the savefile.
+ *
+ * After loading the monsters, the objects being held by monsters are
+ * linked directly into those monsters.
+ */
+static int rd_dungeon_aux(struct chunk **c, int version, struct chunk *ref)
+{
+	struct chunk *c1 = *c;
+
+	u16b height, width;
+
+	byte tmp8u;
+	u16b tmp16u;
+	char name[100];
+
+	/* Header info */
+	rd_string(name, sizeof(name));
+	rd_u16b(&height);
+	rd_u16b(&width);
+
+	/* We need a cave struct */
+	c1 = cave_new(height, width);
+	c1->name = string_make(name);
+
+	if (version == 1)
+		rd_grids_rle(c1);
+	else if (rd_grids_planes(c1, ref)) {
+		cave_free(c1);
+		return -1;
+	}
 
 	/* Read "feeling" */
 	rd_byte(&tmp8u);
@@ -1215,6 +1351,10 @@ static int rd_traps_aux(struct chunk *c)
 		return 0;
 
     rd_byte(&trf_size);
+	if (trf_size > TRF_SIZE) {
+	        note(format("Too many (%u) trap flags!", trf_size));
+		return (-1);
+	}
 
 	/* Read traps until one has no location */
 	while (TRUE) {
@@ -1235,7 +1375,10 @@ static int rd_traps_aux(struct chunk *c)
     return 0;
 }
 
-int rd_dungeon(void)
+/**
+ * Read the current level and the player's memory of it
+ */
+static int rd_cave(int version)
 {
 	u16b depth;
 	u16b py, px;
@@ -1257,7 +1400,7 @@ int rd_dungeon(void)
 		return (0);
 	}
 
-	if (rd_dungeon_aux(&cave))
+	if (rd_dungeon_aux(&cave, version, NULL))
 		return 1;
 
 	/* Ignore illegal dungeons */
@@ -1277,12 +1420,18 @@ int rd_dungeon(void)
 	character_dungeon = TRUE;
 
 	/* Read known cave */
-	if (rd_dungeon_aux(&cave_k))
+	if (rd_dungeon_aux(&cave_k, version, cave))
 		return 1;
 
 	return 0;
 }
 
+/**
+ * Read the dungeon - wrapper functions
+ */
+int rd_dungeon_1(void) { return rd_cave(1); }
+int rd_dungeon(void) { return rd_cave(2); }
+
 
 /**
  * Read the objects - wrapper functions
@@ -1320,36 +1469,117 @@ int rd_traps(void)
 	return 0;
 }
 
+/**
+ * Read one chunk, with everything on it
+ */
+static int rd_chunk_aux(struct chunk **c, int version)
+{
+	/* Read the dungeon */
+	if (rd_dungeon_aux(c, version, NULL))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, *c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(*c))
+		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(*c))
+		return -1;
+
+	return 0;
+}
+
+/**
+ * Read a chunk kept in the savefile's current layout
+ */
+static int rd_chunk_kept(void *user)
+{
+	return rd_chunk_aux((struct chunk **)user, 2);
+}
+
+/**
+ * Whether data from the savefile being read is laid out exactly as this
+ * version would write it, and so can be kept and read later
+ */
+static bool rd_sizes_current(void)
+{
+	return square_size == SQUARE_SIZE && of_size == OF_SIZE &&
+		id_size == ID_SIZE && obj_mod_max == OBJ_MOD_MAX &&
+		elem_max == ELEM_MAX && mflag_size == MFLAG_SIZE;
+}
+
+/**
+ * Read a chunk that was kept aside from an earlier load
+ */
+struct chunk *chunk_read_stored(const byte *data, u32b len)
+{
+	struct chunk *c = NULL;
+
+	/* It was only kept if it matched these */
+	square_size = SQUARE_SIZE;
+	of_size = OF_SIZE;
+	id_size = ID_SIZE;
+	obj_mod_max = OBJ_MOD_MAX;
+	elem_max = ELEM_MAX;
+	mflag_size = MFLAG_SIZE;
+
+	if (rd_kept(data, len, rd_chunk_kept, &c)) {
+		if (c) cave_free(c);
+		return NULL;
+	}
+
+	return c;
+}
+
 /**
  * Read the chunk list
+ *
+ * From version 3, each chunk comes with its name and size, so unless the
+ * savefile is laid out differently from this version it is just kept for
+ * chunk_find_name() to read when the chunk is wanted.
  */
-int rd_chunks(void)
+static int rd_chunk_list(int version)
 {
 	int j;
 	u16b chunk_max;
 
+	/* These replace any chunks from an earlier game */
+	chunk_list_clear();
+
 	if (player->is_dead)
 		return 0;
 
 	rd_u16b(&chunk_max);
 	for (j = 0; j < chunk_max; j++) {
-		struct chunk *c;
+		struct chunk *c = NULL;
 
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
-			return -1;
+		if (version >= 3) {
+			char name[100];
+			u32b len;
+			byte *data;
 
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
+			rd_string(name, sizeof(name));
+			rd_u32b(&len);
+			data = mem_alloc(len);
+			rd_bytes(data, len);
 
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
-			return -1;
+			if (rd_sizes_current()) {
+				chunk_stored_add(name, data, len);
+				continue;
+			}
 
-		/* Read traps */
-		if (rd_traps_aux(c))
+			if (rd_kept(data, len, rd_chunk_kept, &c)) {
+				mem_free(data);
+				return -1;
+			}
+			mem_free(data);
+		} else if (rd_chunk_aux(&c, version)) {
 			return -1;
+		}
 
 		chunk_list_add(c);
 	}
@@ -1357,6 +1587,13 @@ int rd_chunks(void)
 	return 0;
 }
 
+/**
+ * Read the chunk list - wrapper functions
+ */
+int rd_chunks_1(void) { return rd_chunk_list(1); }
+int rd_chunks_2(void) { return rd_chunk_list(2); }
+int rd_chunks(void) { return rd_chunk_list(3); }
+
 
 int rd_history(void)
 {
@@ -0,0 +1,332 @@
+/**
+ * \file main-bench.c
+ * \brief Pseudo-UI for timing level generation (borrows from main-stats.c)
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_BENCH
+
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "main.h"
+#include "mon-make.h"
+#include "obj-util.h"
+#include "parser.h"
+#include "player.h"
+#include "player-birth.h"
+#include <time.h>
+
+#define BENCH_MAX_DEPTHS	16
+#define BENCH_MAX_PROFILES	16
+
+static int num_levels = 100;
+static int depths[BENCH_MAX_DEPTHS] = { 5, 20, 40, 60, 80 };
+static int num_depths = 5;
+static char *profile_names[BENCH_MAX_PROFILES];
+static int num_profiles = 0;
+static u32b seed = 1;
+static int running_bench = 0;
+
+static const char *phase_names[GEN_PHASE_MAX] = {
+	"alloc", "rooms", "tunnels", "streamers", "monsters", "objects",
+	"connect", "features", "finish", "retries"
+};
+
+/**
+ * Per-level timings, sorted to find the percentiles
+ */
+static clock_t *level_times;
+
+static int bench_compare_times(const void *a, const void *b)
+{
+	clock_t ta = *(const clock_t *)a;
+	clock_t tb = *(const clock_t *)b;
+
+	return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static double bench_ms(clock_t t)
+{
+	return (1000.0 * t) / CLOCKS_PER_SEC;
+}
+
+/**
+ * Set up the minimum of a character that level generation needs
+ */
+static void bench_prepare_player(void)
+{
+	int i;
+
+	player_init(player);
+	player_generate(player, races, classes, FALSE);
+
+	/* Player needs a body, for valuing objects */
+	memcpy(&player->body, &bodies[player->race->body], sizeof(player->body));
+	player->body.name = string_make(bodies[player->race->body].name);
+	player->body.slots = mem_zalloc(player->body.count *
+									sizeof(struct equip_slot));
+	for (i = 0; i < player->body.count; i++) {
+		player->body.slots[i].type = bodies[player->race->body].slots[i].type;
+		player->body.slots[i].name =
+			string_make(bodies[player->race->body].slots[i].name);
+	}
+
+	OPT(auto_more) = TRUE;
+	player->upkeep->playing = TRUE;
+	player->upkeep->autosave = FALSE;
+
+	seed_flavor = randint0(0x10000000);
+	flavor_init();
+}
+
+/**
+ * Throw away the current level outside the timed section, and let the next
+ * level make artifacts as if nothing had been made yet
+ */
+static void bench_clear_level(void)
+{
+	int i;
+
+	if (cave) {
+		wipe_mon_list(cave, player);
+		cave_free(cave);
+		cave = NULL;
+	}
+	if (cave_k) {
+		cave_free(cave_k);
+		cave_k = NULL;
+	}
+
+	for (i = 0; i < z_info->a_max; i++)
+		a_info[i].created = FALSE;
+}
+
+/**
+ * Generate num_levels levels with one profile at one depth and report on them
+ */
+static void bench_profile(const struct cave_profile *profile, int depth)
+{
+	clock_t total = 0, phases = 0;
+	unsigned long allocs;
+	int i;
+
+	rng_state_init(Rand_context, seed);
+	player->depth = player->max_depth = depth;
+	memset(gen_phase_time, 0, sizeof(gen_phase_time));
+	allocs = mem_alloc_count;
+
+	for (i = 0; i < num_levels; i++) {
+		clock_t start;
+
+		bench_clear_level();
+
+		start = clock();
+		cave_generate_profile(&cave, player, profile);
+		level_times[i] = clock() - start;
+		total += level_times[i];
+	}
+	allocs = mem_alloc_count - allocs;
+
+	qsort(level_times, num_levels, sizeof(clock_t), bench_compare_times);
+
+	printf("%-12s %5d %9.1f %8.2f %8.2f %9lu", profile->name, depth,
+		   total ? num_levels / (total / (double)CLOCKS_PER_SEC) : 0.0,
+		   bench_ms(level_times[(num_levels - 1) / 2]),
+		   bench_ms(level_times[(num_levels - 1) * 99 / 100]),
+		   allocs / num_levels);
+	for (i = 0; i < GEN_PHASE_MAX; i++) {
+		printf(" %9.2f", bench_ms(gen_phase_time[i]) / num_levels);
+		phases += gen_phase_time[i];
+	}
+	printf(" %9.2f\n", bench_ms(total - phases) / num_levels);
+	fflush(stdout);
+}
+
+/**
+ * Run the benchmark over every requested profile and depth
+ */
+static errr run_bench(void)
+{
+	int i, j;
+
+	/* Report on start-up first, if asked */
+	if (parse_timing) {
+		clock_t total = 0;
+
+		printf("%-20s %7s %9s\n", "data file", "lines", "ms");
+		for (i = 0; i < parse_times_count; i++) {
+			printf("%-20s %7u %9.2f%s\n", parse_times[i].name,
+				   parse_times[i].lines, bench_ms(parse_times[i].time),
+				   parse_times[i].cached ? " (cached)" : "");
+			total += parse_times[i].time;
+		}
+		printf("%-20s %7s %9.2f\n\n", "total", "", bench_ms(total));
+		parse_timing = FALSE;
+	}
+
+	level_times = mem_zalloc(num_levels * sizeof(clock_t));
+	bench_prepare_player();
+	gen_timing = TRUE;
+
+	printf("Generating %d levels per profile and depth (seed %u)\n",
+		   num_levels, seed);
+	printf("%-12s %5s %9s %8s %8s %9s", "profile", "depth", "levels/s",
+		   "p50 ms", "p99 ms", "allocs");
+	for (i = 0; i < GEN_PHASE_MAX; i++)
+		printf(" %9s", phase_names[i]);
+	printf(" %9s\n", "other");
+
+	for (i = 0; i < z_info->profile_max; i++) {
+		const struct cave_profile *profile = &cave_profiles[i];
+
+		/* Use the named profiles, or all dungeon profiles by default */
+		if (num_profiles) {
+			for (j = 0; j < num_profiles; j++)
+				if (streq(profile_names[j], profile->name)) break;
+			if (j == num_profiles) continue;
+		} else if (streq(profile->name, "town")) {
+			continue;
+		}
+
+		for (j = 0; j < num_depths; j++) {
+			if (depths[j] >= z_info->max_depth) continue;
+
+			/* The cavern builder refuses shallow levels */
+			if (streq(profile->name, "cavern") && depths[j] < 15) continue;
+
+			bench_profile(profile, depths[j]);
+		}
+	}
+
+	gen_timing = FALSE;
+	bench_clear_level();
+	mem_free(level_times);
+	for (i = 0; i < num_profiles; i++)
+		string_free(profile_names[i]);
+
+	cleanup_angband();
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_bench(int n, int v) {
+	if (n != TERM_XTRA_EVENT || running_bench) return 0;
+
+	running_bench = 1;
+	return run_bench();
+}
+
+static errr term_curs_bench(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_bench(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_bench(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = TRUE;
+	t->never_frosh = TRUE;
+
+	t->xtra_hook = term_xtra_bench;
+	t->curs_hook = term_curs_bench;
+	t->wipe_hook = term_wipe_bench;
+	t->text_hook = term_text_bench;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_bench[] = "Level generation benchmark, subopts -n(# of levels) -d(epths) -p(rofile) -S(eed) -t(ime data files) -c(ache data files)";
+
+/**
+ * Usage:
+ *
+ * angband -mbench -- [-nNNNN] [-dNN[,NN...]] [-pNAME]... [-SNNNN] [-t] [-c]
+ *
+ *   -nNNNN         Generate NNNN levels per profile and depth (default: 100)
+ *   -dNN[,NN...]   Depths to generate at (default: 5,20,40,60,80)
+ *   -pNAME         Only use the named profile; may be given more than once
+ *                  (default: every profile but the town)
+ *   -SNNNN         Seed each profile and depth with NNNN (default: 1)
+ *   -t             First report the time taken to parse each data file
+ *   -c             Use (and make) compiled caches of the data files
+ */
+errr init_bench(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-n")) {
+			num_levels = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-d")) {
+			char *s = &argv[i][2];
+
+			num_depths = 0;
+			while (*s && num_depths < BENCH_MAX_DEPTHS) {
+				depths[num_depths++] = MAX(atoi(s), 1);
+				s += strcspn(s, ",");
+				if (*s) s++;
+			}
+			continue;
+		}
+		if (prefix(argv[i], "-p")) {
+			if (num_profiles < BENCH_MAX_PROFILES)
+				profile_names[num_profiles++] = string_make(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed = strtoul(&argv[i][2], NULL, 10);
+			continue;
+		}
+		if (streq(argv[i], "-t")) {
+			parse_timing = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "-c")) {
+			parse_cache = TRUE;
+			continue;
+		}
+		printf("init-bench: bad argument '%s'\n", argv[i]);
+	}
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_BENCH */
@@ -22,6 +22,7 @@
 
 #include "buildid.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "main.h"
 #include "mon-make.h"
@@ -33,6 +34,7 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 #include "object.h"
+#include "parser.h"
 #include "player.h"
 #include "player-birth.h"
 #include "player-util.h"
@@ -42,6 +44,8 @@
 #include "store.h"
 #include <stddef.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #define OBJ_FEEL_MAX	 11
 #define MON_FEEL_MAX 	 10
@@ -66,6 +70,9 @@
 static int randarts = 0;
 static int no_selling = 0;
 static u32b num_runs = 1;
+static int num_workers = 1;
+static u32b seed_base = 0;
+static bool seed_given = FALSE;
 static bool quiet = FALSE;
 static int nextkey = 0;
 static int running_stats = 0;
@@ -179,6 +186,8 @@ static void free_stats_memory(void)
 /* Copied from birth.c:generate_player() */
 static void generate_player_for_stats()
 {
+	int i;
+
 	OPT(birth_randarts) = randarts;
 	OPT(birth_no_selling) = no_selling;
 	OPT(birth_no_stacking) = FALSE;
@@ -189,6 +198,17 @@ static void generate_player_for_stats()
 	player->race = races;  /* Human   */
 	player->class = classes; /* Warrior */
 
+	/* Player needs a body */
+	memcpy(&player->body, &bodies[player->race->body], sizeof(player->body));
+	player->body.name = string_make(bodies[player->race->body].name);
+	player->body.slots = mem_zalloc(player->body.count *
+									sizeof(struct equip_slot));
+	for (i = 0; i < player->body.count; i++) {
+		player->body.slots[i].type = bodies[player->race->body].slots[i].type;
+		player->body.slots[i].name =
+			string_make(bodies[player->race->body].slots[i].name);
+	}
+
 	/* Level 1 */
 	player->max_lev = player->lev = 1;
 
@@ -213,18 +233,20 @@ static void generate_player_for_stats()
 	player->history = get_history(player->race->history);
 }
 
-static void initialize_character(void)
+/**
+ * Each run gets its own seed, so that a run comes out the same whichever
+ * worker makes it
+ */
+static void initialize_character(u32b run)
 {
-	u32b seed;
+	int i;
 
 	if (!quiet) {
 		printf(" [I  ]\b\b\b\b\b\b");
 		fflush(stdout);
 	}
 
-	seed = (time(NULL));
-	Rand_quick = FALSE;
-	Rand_state_init(seed);
+	rng_state_init(Rand_context, seed_base + run);
 
 	player_init(player);
 	generate_player_for_stats();
@@ -237,6 +259,9 @@ static void initialize_character(void)
 		do_randart(seed_randart, TRUE);
 	}
 
+	/* Stores start without owners, as they do in a new process */
+	for (i = 0; i < MAX_STORES; i++)
+		stores[i].owner = NULL;
 	store_reset();
 	flavor_init();
 	player->upkeep->playing = TRUE;
@@ -253,6 +278,9 @@ static void kill_all_monsters(int level)
 
 		level_data[level].monsters[mon->race->ridx]++;
 
+		/* Mimicked objects stay on the floor, to be counted with the rest */
+		mon->mimicked_obj = NULL;
+
 		monster_death(mon, TRUE);
 
 		if (rf_has(mon->race->flags, RF_UNIQUE))
@@ -302,6 +330,9 @@ static void log_all_objects(int level)
 			for (obj = square_object(cave, y, x); obj; obj = obj->next) {
 				/*	u32b o_power = 0; */
 
+				/* Only the first few origins are counted */
+				if (obj->origin >= ORIGIN_STATS) continue;
+
 				/* Mark object as fully known */
 				object_notice_everything(obj);
 
@@ -1184,6 +1215,8 @@ static int stats_write_db_level_data(const char *table, int max_idx)
 			u32b count;
 			if (streq(table, "gold"))
 				count = *((long long *)((byte *)&level_data[level] + offset) + i);
+			else if (streq(table, "monsters"))
+				count = (*((u32b **)((byte *)&level_data[level] + offset)))[i];
 			else
 				count = *((u32b *)((byte *)&level_data[level] + offset) + i);
 
@@ -1469,13 +1502,278 @@ void progress_bar(u32b run, time_t start) {
 
 static void stats_cleanup_angband_run(void)
 {
-	if (player->history) mem_free(player->history);
+	struct chunk *town;
+	int i;
+
+	/* Free the last level, while its monsters still count as alive */
+	wipe_mon_list(cave, player);
+	cave_free(cave);
+	cave = NULL;
+
+	mem_free(player->history);
+	player->history = NULL;
+
+	for (i = 0; i < player->body.count; i++)
+		string_free(player->body.slots[i].name);
+	mem_free(player->body.slots);
+	string_free(player->body.name);
+	memset(&player->body, 0, sizeof(player->body));
+
+	/* Each run gets a new town */
+	town = chunk_find_name("Town");
+	if (town) {
+		chunk_list_remove("Town");
+		cave_free(town);
+	}
+}
+
+/**
+ * Do one complete run through the dungeon
+ */
+static void stats_do_run(u32b run, struct artifact *a_info_save)
+{
+	unsigned int i;
+
+	if (randarts)
+		for (i = 0; i < z_info->a_max; i++)
+			memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
+
+	initialize_character(run);
+	unkill_uniques();
+	reset_artifacts();
+	descend_dungeon();
+	stats_cleanup_angband_run();
+}
+
+static void stats_checkpoint(u32b run)
+{
+	int err = stats_write_db(run);
+	if (err) {
+		stats_db_close();
+		quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
+	}
+}
+
+/**
+ * Parallel runs
+ *
+ * With -jN the runs are shared out between N worker processes, forked after
+ * the game data is loaded.  Each worker collects into its own copy of
+ * level_data, and at every checkpoint sends its counts down a pipe to the
+ * parent and clears them.  The parent adds them up and writes the database
+ * as it would for a single process.  Workers also write a byte to a shared
+ * pipe for each run they finish, which drives the progress bar.
+ */
+typedef bool (*stats_counts_func)(FILE *fp, void *counts, size_t num,
+								  size_t size);
+
+/**
+ * Send an array of counts down a pipe and clear it.  All-zero arrays - most
+ * of them - are sent as a single byte.  Return whether anything was counted.
+ */
+static bool stats_send_counts(FILE *fp, void *counts, size_t num,
+							  size_t size)
+{
+	size_t i;
+	byte *bytes = counts;
+
+	for (i = 0; i < num * size; i++)
+		if (bytes[i]) break;
+
+	if (i == num * size) {
+		fputc(0, fp);
+		return false;
+	}
+
+	fputc(1, fp);
+	fwrite(counts, size, num, fp);
+	memset(counts, 0, num * size);
+	return true;
+}
+
+/**
+ * Read an array of counts sent by stats_send_counts() and add it to ours
+ */
+static bool stats_merge_counts(FILE *fp, void *counts, size_t num,
+							   size_t size)
+{
+	size_t i;
+	int c = fgetc(fp);
+
+	if (c == EOF) quit("Lost contact with a stats worker!");
+	if (!c) return false;
+
+	for (i = 0; i < num; i++) {
+		if (size == sizeof(long long)) {
+			long long n;
+			if (fread(&n, size, 1, fp) != 1)
+				quit("Lost contact with a stats worker!");
+			((long long *)counts)[i] += n;
+		} else {
+			u32b n;
+			if (fread(&n, size, 1, fp) != 1)
+				quit("Lost contact with a stats worker!");
+			((u32b *)counts)[i] += n;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Apply func to every array of counts in level_data, in a fixed order.
+ * Objects of a kind which wasn't seen have nothing else to count, so are
+ * skipped.
+ */
+static void stats_walk_counts(stats_counts_func func, FILE *fp)
+{
+	int i, j, k, l;
+
+	for (i = 0; i < LEVEL_MAX; i++) {
+		struct level_data *ld = &level_data[i];
+
+		func(fp, ld->monsters, z_info->r_max, sizeof(u32b));
+		func(fp, ld->obj_feelings, OBJ_FEEL_MAX, sizeof(u32b));
+		func(fp, ld->mon_feelings, MON_FEEL_MAX, sizeof(u32b));
+		func(fp, ld->gold, ORIGIN_STATS, sizeof(long long));
+
+		for (j = 0; j < ORIGIN_STATS; j++) {
+			func(fp, ld->artifacts[j], z_info->a_max, sizeof(u32b));
+			func(fp, ld->consumables[j], consumable_count + 1, sizeof(u32b));
+
+			for (k = 0; k < wearable_count + 1; k++) {
+				struct wearables_data *w = &ld->wearables[j][k];
+
+				if (!func(fp, &w->count, 1, sizeof(u32b))) continue;
+
+				func(fp, w->dice, TOP_DICE * TOP_SIDES, sizeof(u32b));
+				func(fp, w->ac, TOP_AC, sizeof(u32b));
+				func(fp, w->hit, TOP_PLUS, sizeof(u32b));
+				func(fp, w->dam, TOP_PLUS, sizeof(u32b));
+				func(fp, w->egos, z_info->e_max, sizeof(u32b));
+				func(fp, w->flags, OF_MAX, sizeof(u32b));
+				for (l = 0; l < TOP_MOD; l++)
+					func(fp, w->modifiers[l], OBJ_MOD_MAX + 1, sizeof(u32b));
+			}
+		}
+	}
+}
+
+/**
+ * The life of a worker: make every num_workers'th run, starting with run
+ * worker + 1, and report in at the end of each checkpoint block
+ */
+static void stats_worker(int worker, int count_fd, int progress_fd,
+						 struct artifact *a_info_save)
+{
+	FILE *fp = fdopen(count_fd, "wb");
+	u32b block, run;
+
+	if (!fp) _exit(1);
+
+	/* Leave the progress bar to the parent */
+	quiet = TRUE;
+
+	for (block = 0; block < num_runs; block += RUNS_PER_CHECKPOINT) {
+		u32b end = MIN(block + RUNS_PER_CHECKPOINT, num_runs);
+
+		for (run = block + 1; run <= end; run++) {
+			if ((run - 1) % num_workers != (u32b) worker) continue;
+
+			stats_do_run(run, a_info_save);
+			if (write(progress_fd, "", 1) != 1) _exit(1);
+		}
+
+		stats_walk_counts(stats_send_counts, fp);
+		if (fflush(fp)) _exit(1);
+	}
+
+	fclose(fp);
+	_exit(0);
+}
+
+static void stats_run_parallel(struct artifact *a_info_save, time_t start)
+{
+	pid_t *pids = mem_zalloc(num_workers * sizeof(pid_t));
+	FILE **fps = mem_zalloc(num_workers * sizeof(FILE *));
+	int progress[2];
+	u32b block, done = 0;
+	int i;
+
+	if (pipe(progress)) quit("Couldn't create a pipe!");
+
+	for (i = 0; i < num_workers; i++) {
+		int counts[2];
+
+		if (pipe(counts)) quit("Couldn't create a pipe!");
+
+		fflush(stdout);
+		pids[i] = fork();
+		if (pids[i] < 0) quit("Couldn't start a stats worker!");
+
+		if (!pids[i]) {
+			int j;
+
+			/* Workers only need their own write ends */
+			for (j = 0; j < i; j++) fclose(fps[j]);
+			close(counts[0]);
+			close(progress[0]);
+			stats_worker(i, counts[1], progress[1], a_info_save);
+		}
+
+		close(counts[1]);
+		fps[i] = fdopen(counts[0], "rb");
+		if (!fps[i]) quit("Couldn't read from a stats worker!");
+	}
+	close(progress[1]);
+
+	for (block = 0; block < num_runs; block += RUNS_PER_CHECKPOINT) {
+		u32b end = MIN(block + RUNS_PER_CHECKPOINT, num_runs);
+
+		/* Wait for all the runs in this block */
+		while (done < end) {
+			char buf[256];
+			ssize_t n = read(progress[0], buf, sizeof(buf));
+
+			if (n <= 0) quit("Lost contact with a stats worker!");
+
+			while (n--) {
+				done++;
+				if (!quiet) progress_bar(done, start);
+				if (quiet && done % 1000 == 0) {
+					printf("Finished %d runs.\n", done);
+					fflush(stdout);
+				}
+			}
+		}
+
+		/* Collect the counts, in worker order */
+		for (i = 0; i < num_workers; i++)
+			stats_walk_counts(stats_merge_counts, fps[i]);
+
+		/* The last block is written by run_stats() */
+		if (end < num_runs)
+			stats_checkpoint(end);
+	}
+
+	for (i = 0; i < num_workers; i++) {
+		int status;
+
+		fclose(fps[i]);
+		if (waitpid(pids[i], &status, 0) < 0 || !WIFEXITED(status) ||
+			WEXITSTATUS(status))
+			quit_fmt("Stats worker %d failed!", i);
+	}
+	close(progress[0]);
+
+	mem_free(fps);
+	mem_free(pids);
 }
 
 static errr run_stats(void)
 {
 	u32b run;
-	struct artifact *a_info_save;
+	struct artifact *a_info_save = NULL;
 	unsigned int i;
 	int err;
 	bool status; 
@@ -1498,38 +1796,32 @@ static errr run_stats(void)
 	status = stats_prep_db();
 	if (!status) quit("Couldn't prepare database!");
 
+	if (!seed_given) seed_base = time(NULL);
+
 	if (!quiet) {
-		printf("Beginning %d runs...\n", num_runs);
+		printf("Beginning %d runs (seed %u", num_runs, seed_base);
+		if (num_workers > 1) printf(", %d workers", num_workers);
+		printf(")...\n");
 		fflush(stdout);
 	}
 
 	start = time(NULL);
-	for (run = 1; run <= num_runs; run++) {
-		if (!quiet) progress_bar(run - 1, start);
-
-		if (randarts)
-			for (i = 0; i < z_info->a_max; i++)
-				memcpy(&a_info[i], &a_info_save[i], sizeof(struct artifact));
-
-		initialize_character();
-		unkill_uniques();
-		reset_artifacts();
-		descend_dungeon();
-		stats_cleanup_angband_run();
-
-		/* Checkpoint every so many runs */
-		if (run % RUNS_PER_CHECKPOINT == 0) {
-			err = stats_write_db(run);
-			if (err) {
-				stats_db_close();
-				quit_fmt("Problems writing to database!  sqlite3 errno %d.",
-						 err);
-			}
-		}
+	if (num_workers > 1) {
+		stats_run_parallel(a_info_save, start);
+	} else {
+		for (run = 1; run <= num_runs; run++) {
+			if (!quiet) progress_bar(run - 1, start);
+
+			stats_do_run(run, a_info_save);
 
-		if (quiet && run % 1000 == 0) {
-			printf("Finished %d runs.\n", run);
-			fflush(stdout);
+			/* Checkpoint every so many runs */
+			if (run % RUNS_PER_CHECKPOINT == 0)
+				stats_checkpoint(run);
+
+			if (quiet && run % 1000 == 0) {
+				printf("Finished %d runs.\n", run);
+				fflush(stdout);
+			}
 		}
 	}
 
@@ -1539,7 +1831,7 @@ static errr run_stats(void)
 		fflush(stdout);
 	}
 
-	err = stats_write_db(run);
+	err = stats_write_db(num_runs);
 	stats_db_close();
 	if (err) quit_fmt("Problems writing to database!  sqlite3 errno %d.", err);
 
@@ -1674,17 +1966,22 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling)";
+const char help_stats[] = "Stats mode, subopts -q(uiet) -r(andarts) -n(# of runs) -s(no selling) -j(# of workers) -S(eed) -c(ache data files)";
 
 /**
  * Usage:
  *
- * angband -mstats -- [-q] [-r] [-nNNNN] [-s]
+ * angband -mstats -- [-q] [-r] [-nNNNN] [-s] [-jNN] [-SNNNN] [-c]
  *
  *   -q      Quiet mode (turn off progress messages)
  *   -r      Turn on randarts
  *   -nNNNN  Make NNNN runs through the dungeon (default: 1)
  *   -s      Turn on no-selling
+ *   -jNN    Share the runs between NN worker processes (default: 1)
+ *   -SNNNN  Seed run n with NNNN + n, so results can be repeated; any
+ *           number, 0 included, may be given (default: the time)
+ *   -c      Keep parsed data files in the user directory, and read them
+ *           from there while the text files are unchanged
  */
 
 errr init_stats(int argc, char *argv[]) {
@@ -1708,6 +2005,19 @@ errr init_stats(int argc, char *argv[]) {
 			no_selling = 1;
 			continue;
 		}
+		if (prefix(argv[i], "-j")) {
+			num_workers = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-S")) {
+			seed_base = strtoul(&argv[i][2], NULL, 10);
+			seed_given = TRUE;
+			continue;
+		}
+		if (streq(argv[i], "-c")) {
+			parse_cache = TRUE;
+			continue;
+		}
 		printf("init-stats: bad argument '%s'\n", argv[i]);
 	}
 
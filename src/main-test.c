@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "buildid.h"
 #include "main.h"
+#include "parser.h"
 #include "player.h"
 #include "player-birth.h"
 
@@ -295,7 +296,7 @@ static void term_data_link(int i) {
 	angband_term[i] = t;
 }
 
-const char help_test[] = "Test mode, subopts -p(rompt)";
+const char help_test[] = "Test mode, subopts -p(rompt) -c(ache data files)";
 
 errr init_test(int argc, char *argv[]) {
 	int i;
@@ -306,6 +307,10 @@ errr init_test(int argc, char *argv[]) {
 			prompt = 1;
 			continue;
 		}
+		if (!strcmp(argv[i], "-c")) {
+			parse_cache = TRUE;
+			continue;
+		}
 		printf("init-test: bad argument '%s'\n", argv[i]);
 	}
 
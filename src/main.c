@@ -67,6 +67,10 @@ static const struct module modules[] =
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats },
 #endif /* USE_STATS */
+
+#ifdef USE_BENCH
+	{ "bench", help_bench, init_bench },
+#endif /* USE_BENCH */
 };
 
 static int init_sound_dummy(int argc, char *argv[]) {
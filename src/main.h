@@ -42,6 +42,7 @@ extern errr init_vcs(int argc, char **argv);
 extern errr init_sdl(int argc, char **argv);
 extern errr init_test(int argc, char **argv);
 extern errr init_stats(int argc, char **argv);
+extern errr init_bench(int argc, char **argv);
 
 
 extern const char help_lfb[];
@@ -61,6 +62,7 @@ extern const char help_dos[];
 extern const char help_sdl[];
 extern const char help_test[];
 extern const char help_stats[];
+extern const char help_bench[];
 
 //phantom server play
 extern bool arg_force_name;
@@ -24,11 +24,12 @@
 #include "init.h"
 #include "player.h"
 
+/**
+ * A message keeps its text in the queue's text arena, at text[str]
+ */
 typedef struct _message_t
 {
-	char *str;
-	struct _message_t *newer;
-	struct _message_t *older;
+	u32b str;
 	u16b type;
 	u16b count;
 } message_t;
@@ -40,17 +41,31 @@ typedef struct _msgcolor_t
 	struct _msgcolor_t *next;
 } msgcolor_t;
 
+/**
+ * The message history is a ring of max messages, oldest at ring[first].  The
+ * text lives in a circular arena; when there is no room for a new message's
+ * text, the oldest messages are dropped until there is.
+ */
 typedef struct _msgqueue_t
 {
-	message_t *head;
-	message_t *tail;
+	message_t *ring;
+	u32b first;
 	msgcolor_t *colors;
 	u32b count;
 	u32b max;
+
+	char *text;
+	u32b text_size;
+	u32b text_head;
 } msgqueue_t;
 
 static msgqueue_t *messages = NULL;
 
+/**
+ * Bytes of message text to allow for each message kept
+ */
+#define MESSAGE_TEXT_AVERAGE	80
+
 /**
  * ------------------------------------------------------------------------
  * Functions operating on the entire list
@@ -63,6 +78,9 @@ void messages_init(void)
 {
 	messages = mem_zalloc(sizeof(msgqueue_t));
 	messages->max = 2048;
+	messages->ring = mem_zalloc(messages->max * sizeof(message_t));
+	messages->text_size = messages->max * MESSAGE_TEXT_AVERAGE;
+	messages->text = mem_alloc(messages->text_size);
 }
 
 /**
@@ -72,15 +90,6 @@ void messages_free(void)
 {
 	msgcolor_t *c = messages->colors;
 	msgcolor_t *nextc;
-	message_t *m = messages->head;
-	message_t *nextm;
-
-	while (m) {
-		nextm = m->older;
-		mem_free(m->str);
-		mem_free(m);
-		m = nextm;
-	}
 
 	while (c) {
 		nextc = c->next;
@@ -88,6 +97,8 @@ void messages_free(void)
 		c = nextc;
 	}
 
+	mem_free(messages->text);
+	mem_free(messages->ring);
 	mem_free(messages);
 }
 
@@ -103,6 +114,60 @@ u16b messages_num(void)
  * ------------------------------------------------------------------------
  * Functions for individual messages
  * ------------------------------------------------------------------------ */
+/**
+ * Returns the message of age `age`.
+ */
+static message_t *message_get(u16b age)
+{
+	if (age >= messages->count)
+		return NULL;
+
+	return &messages->ring[(messages->first + messages->count - 1 - age) %
+						   messages->max];
+}
+
+/**
+ * Forget the oldest message
+ */
+static void message_drop_oldest(void)
+{
+	messages->first = (messages->first + 1) % messages->max;
+	messages->count--;
+}
+
+/**
+ * Find room for len bytes of text in the arena, dropping the oldest
+ * messages until there is some
+ */
+static u32b message_text_alloc(u32b len)
+{
+	u32b head = messages->text_head;
+
+	while (messages->count) {
+		/* Free space runs from the head round to the oldest message's text */
+		u32b tail = messages->ring[messages->first].str;
+
+		if (tail >= head) {
+			if (head + len <= tail) break;
+		} else if (head + len <= messages->text_size) {
+			break;
+		} else if (len <= tail) {
+			/* Leave the end of the arena unused and start again at 0 */
+			head = 0;
+			break;
+		}
+
+		message_drop_oldest();
+	}
+
+	/* An empty arena is all free */
+	if (!messages->count)
+		head = 0;
+
+	messages->text_head = head + len;
+	return head;
+}
+
 /**
  * Save a new message into the memory buffer, with text `str` and type `type`.
  * The type should be one of the MSG_ constants defined in message.h.
@@ -113,52 +178,31 @@ u16b messages_num(void)
  */
 void message_add(const char *str, u16b type)
 {
-	message_t *m;
+	message_t *m = message_get(0);
+	u32b len = strlen(str) + 1;
+	u32b text;
 
-	if (messages->head &&
-	    messages->head->type == type &&
-	    !strcmp(messages->head->str, str)) {
-		messages->head->count++;
+	if (m && m->type == type && !strcmp(messages->text + m->str, str)) {
+		m->count++;
 		return;
 	}
 
-	m = mem_zalloc(sizeof(message_t));
-	m->str = string_make(str);
-	m->type = type;
-	m->count = 1;
-	m->older = messages->head;
+	/* Keep the text to what the arena can hold */
+	if (len > messages->text_size)
+		len = messages->text_size;
 
-	if (messages->head)
-		messages->head->newer = m;
+	if (messages->count == messages->max)
+		message_drop_oldest();
 
-	messages->head = m;
+	/* Making room for the text may drop old messages, but never moves the
+	 * slot after the newest one */
+	text = message_text_alloc(len);
+	m = &messages->ring[(messages->first + messages->count) % messages->max];
+	m->str = text;
+	m->type = type;
+	m->count = 1;
+	my_strcpy(messages->text + text, str, len);
 	messages->count++;
-
-	if (!messages->tail)
-		messages->tail = m;
-
-	if (messages->count > messages->max) {
-		message_t *old_tail = messages->tail;
-
-		messages->tail = old_tail->newer;
-		messages->tail->older = NULL;
-		mem_free(old_tail->str);
-		mem_free(old_tail);
-		messages->count--;
-	}
-}
-
-/**
- * Returns the message of age `age`.
- */
-static message_t *message_get(u16b age)
-{
-	message_t *m = messages->head;
-
-	while (m && age--)
-		m = m->older;
-
-	return m;
 }
 
 
@@ -172,7 +216,7 @@ static message_t *message_get(u16b age)
 const char *message_str(u16b age)
 {
 	message_t *m = message_get(age);
-	return (m ? m->str : "");
+	return (m ? messages->text + m->str : "");
 }
 
 /**
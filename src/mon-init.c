@@ -922,6 +922,21 @@ static errr run_parse_monster(struct parser *p) {
 	return parse_file(p, "monster");
 }
 
+/**
+ * Allocate space for the monster lore
+ */
+static void alloc_monster_lore(void)
+{
+	int i;
+
+	l_list = mem_zalloc(z_info->r_max * sizeof(struct monster_lore));
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_lore *l = &l_list[i];
+		l->blows = mem_zalloc(z_info->mon_blows_max * sizeof(struct monster_blow));
+		l->blow_known = mem_zalloc(z_info->mon_blows_max * sizeof(bool));
+	}
+}
+
 static errr finish_parse_monster(struct parser *p) {
 	struct monster_race *r, *n;
 	size_t i;
@@ -1008,12 +1023,7 @@ static errr finish_parse_monster(struct parser *p) {
 	}
 
 	/* Allocate space for the monster lore */
-	l_list = mem_zalloc(z_info->r_max * sizeof(struct monster_lore));
-	for (i = 0; i < z_info->r_max; i++) {
-		struct monster_lore *l = &l_list[i];
-		l->blows = mem_zalloc(z_info->mon_blows_max * sizeof(struct monster_blow));
-		l->blow_known = mem_zalloc(z_info->mon_blows_max * sizeof(bool));
-	}
+	alloc_monster_lore();
 
 	/* Write new monster.txt file if requested */
 	if (arg_power || arg_rebalance)
@@ -1067,12 +1077,281 @@ static void cleanup_monster(void)
 	mem_free(r_info);
 }
 
+/**
+ * Compiled monster data.  Links to other records are written as indices:
+ * bases by their place in rb_info, races, kinds and artifacts by their index
+ * plus one.  Monster power evaluation changes the races, so a cache made with
+ * it on is never used.
+ */
+static int mon_base_index(const struct monster_base *base)
+{
+	const struct monster_base *rb;
+	int i = 1;
+
+	if (!base)
+		return 0;
+	for (rb = rb_info; rb && rb != base; rb = rb->next)
+		i++;
+	return rb ? i : 0;
+}
+
+static struct monster_base *mon_base_at(u32b idx)
+{
+	struct monster_base *rb = rb_info;
+
+	if (!idx) return NULL;
+	while (rb && --idx)
+		rb = rb->next;
+	if (!rb)
+		cache_rd_fail();
+	return rb;
+}
+
+static u32b monster_cache_layout(void)
+{
+	size_t sizes[] = {
+		sizeof(struct monster_race), sizeof(struct monster_blow),
+		sizeof(struct monster_drop), sizeof(struct monster_friends),
+		sizeof(struct monster_friends_base), sizeof(struct monster_mimic),
+		RF_SIZE, RSF_SIZE
+	};
+	return cache_layout(sizes, N_ELEMENTS(sizes));
+}
+
+/**
+ * Power evaluation changes the races after parsing, so neither use nor replace
+ * a cache when it's on
+ */
+static bool save_monster(void)
+{
+	int i;
+	size_t j;
+
+	if (arg_power || arg_rebalance)
+		return FALSE;
+
+	cache_wr_u32b(z_info->r_max);
+	cache_wr_u32b(z_info->mon_blows_max);
+
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *r = &r_info[i];
+		struct monster_drop *d;
+		struct monster_friends *f;
+		struct monster_friends_base *fb;
+		struct monster_mimic *m;
+		u32b n;
+
+		cache_wr_u32b(r->next ? r->next - r_info + 1 : 0);
+		cache_wr_u32b(r->ridx);
+		cache_wr_string(r->name);
+		cache_wr_string(r->text);
+		cache_wr_string(r->plural);
+		cache_wr_u32b(mon_base_index(r->base));
+		cache_wr_u32b(r->avg_hp);
+		cache_wr_u32b(r->ac);
+		cache_wr_u32b(r->sleep);
+		cache_wr_u32b(r->aaf);
+		cache_wr_u32b(r->speed);
+		cache_wr_u32b(r->mexp);
+		cache_wr_u32b(r->power);
+		cache_wr_u32b(r->scaled_power);
+		cache_wr_u32b(r->freq_innate);
+		cache_wr_u32b(r->freq_spell);
+		cache_wr_flags(r->flags, RF_SIZE);
+		cache_wr_flags(r->spell_flags, RSF_SIZE);
+
+		/* Unused indices have no blows */
+		cache_wr_byte(r->blow != NULL);
+		for (j = 0; r->blow && j < z_info->mon_blows_max; j++) {
+			cache_wr_byte(r->blow[j].next != NULL);
+			cache_wr_u32b(r->blow[j].method);
+			cache_wr_u32b(r->blow[j].effect);
+			cache_wr_random(r->blow[j].dice);
+			cache_wr_u32b(r->blow[j].times_seen);
+		}
+
+		cache_wr_u32b(r->level);
+		cache_wr_u32b(r->rarity);
+		cache_wr_byte(r->d_attr);
+		cache_wr_u32b(r->d_char);
+		cache_wr_byte(r->max_num);
+		cache_wr_u32b(r->cur_num);
+
+		for (n = 0, d = r->drops; d; d = d->next) n++;
+		cache_wr_u32b(n);
+		for (d = r->drops; d; d = d->next) {
+			cache_wr_u32b(d->kind ? d->kind - k_info + 1 : 0);
+			cache_wr_u32b(d->artifact ? d->artifact - a_info + 1 : 0);
+			cache_wr_u32b(d->percent_chance);
+			cache_wr_u32b(d->min);
+			cache_wr_u32b(d->max);
+		}
+
+		for (n = 0, f = r->friends; f; f = f->next) n++;
+		cache_wr_u32b(n);
+		for (f = r->friends; f; f = f->next) {
+			cache_wr_u32b(f->race ? f->race - r_info + 1 : 0);
+			cache_wr_u32b(f->percent_chance);
+			cache_wr_u32b(f->number_dice);
+			cache_wr_u32b(f->number_side);
+		}
+
+		for (n = 0, fb = r->friends_base; fb; fb = fb->next) n++;
+		cache_wr_u32b(n);
+		for (fb = r->friends_base; fb; fb = fb->next) {
+			cache_wr_u32b(mon_base_index(fb->base));
+			cache_wr_u32b(fb->percent_chance);
+			cache_wr_u32b(fb->number_dice);
+			cache_wr_u32b(fb->number_side);
+		}
+
+		for (n = 0, m = r->mimic_kinds; m; m = m->next) n++;
+		cache_wr_u32b(n);
+		for (m = r->mimic_kinds; m; m = m->next)
+			cache_wr_u32b(m->kind ? m->kind - k_info + 1 : 0);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Read a link written as an index plus one into an array of `max` records
+ */
+static u32b load_monster_link(int max)
+{
+	u32b idx = cache_rd_u32b();
+	if (idx > (u32b)max)
+		cache_rd_fail();
+	return cache_rd_ok() ? idx : 0;
+}
+
+static bool load_monster(void)
+{
+	u32b i, j, n;
+
+	if (arg_power || arg_rebalance)
+		return FALSE;
+
+	n = cache_rd_u32b();
+	z_info->mon_blows_max = cache_rd_u32b();
+	if (!n || n > 65535 || z_info->mon_blows_max > 255)
+		return FALSE;
+	z_info->r_max = n;
+
+	r_info = mem_zalloc(z_info->r_max * sizeof(*r_info));
+	for (i = 0; i < z_info->r_max && cache_rd_ok(); i++) {
+		struct monster_race *r = &r_info[i];
+		struct monster_drop **last_d = &r->drops;
+		struct monster_friends **last_f = &r->friends;
+		struct monster_friends_base **last_fb = &r->friends_base;
+		struct monster_mimic **last_m = &r->mimic_kinds;
+		u32b next;
+
+		next = load_monster_link(z_info->r_max);
+		r->next = next ? &r_info[next - 1] : NULL;
+		r->ridx = cache_rd_u32b();
+		r->name = cache_rd_string();
+		r->text = cache_rd_string();
+		r->plural = cache_rd_string();
+		r->base = mon_base_at(cache_rd_u32b());
+		r->avg_hp = cache_rd_u32b();
+		r->ac = cache_rd_u32b();
+		r->sleep = cache_rd_u32b();
+		r->aaf = cache_rd_u32b();
+		r->speed = cache_rd_u32b();
+		r->mexp = cache_rd_u32b();
+		r->power = (s32b)cache_rd_u32b();
+		r->scaled_power = (s32b)cache_rd_u32b();
+		r->freq_innate = cache_rd_u32b();
+		r->freq_spell = cache_rd_u32b();
+		cache_rd_flags(r->flags, RF_SIZE);
+		cache_rd_flags(r->spell_flags, RSF_SIZE);
+
+		if (cache_rd_byte())
+			r->blow = mem_zalloc(z_info->mon_blows_max * sizeof(*r->blow));
+		for (j = 0; r->blow && j < z_info->mon_blows_max; j++) {
+			bool more = cache_rd_byte();
+			if (more && j + 1 < z_info->mon_blows_max)
+				r->blow[j].next = &r->blow[j + 1];
+			r->blow[j].method = cache_rd_u32b();
+			r->blow[j].effect = cache_rd_u32b();
+			r->blow[j].dice = cache_rd_random();
+			r->blow[j].times_seen = cache_rd_u32b();
+		}
+
+		r->level = cache_rd_u32b();
+		r->rarity = cache_rd_u32b();
+		r->d_attr = cache_rd_byte();
+		r->d_char = cache_rd_u32b();
+		r->max_num = cache_rd_byte();
+		r->cur_num = cache_rd_u32b();
+
+		n = cache_rd_u32b();
+		for (j = 0; j < n && cache_rd_ok(); j++) {
+			struct monster_drop *d = mem_zalloc(sizeof *d);
+			u32b kidx = load_monster_link(z_info->k_max);
+			u32b aidx = load_monster_link(z_info->a_max);
+			*last_d = d;
+			last_d = &d->next;
+			d->kind = kidx ? &k_info[kidx - 1] : NULL;
+			d->artifact = aidx ? &a_info[aidx - 1] : NULL;
+			d->percent_chance = cache_rd_u32b();
+			d->min = cache_rd_u32b();
+			d->max = cache_rd_u32b();
+		}
+
+		/* Friends are kept as races; the names went in finish */
+		n = cache_rd_u32b();
+		for (j = 0; j < n && cache_rd_ok(); j++) {
+			struct monster_friends *f = mem_zalloc(sizeof *f);
+			u32b ridx = load_monster_link(z_info->r_max);
+			*last_f = f;
+			last_f = &f->next;
+			f->race = ridx ? &r_info[ridx - 1] : NULL;
+			f->percent_chance = cache_rd_u32b();
+			f->number_dice = cache_rd_u32b();
+			f->number_side = cache_rd_u32b();
+		}
+
+		n = cache_rd_u32b();
+		for (j = 0; j < n && cache_rd_ok(); j++) {
+			struct monster_friends_base *fb = mem_zalloc(sizeof *fb);
+			*last_fb = fb;
+			last_fb = &fb->next;
+			fb->base = mon_base_at(cache_rd_u32b());
+			fb->percent_chance = cache_rd_u32b();
+			fb->number_dice = cache_rd_u32b();
+			fb->number_side = cache_rd_u32b();
+		}
+
+		n = cache_rd_u32b();
+		for (j = 0; j < n && cache_rd_ok(); j++) {
+			struct monster_mimic *m = mem_zalloc(sizeof *m);
+			u32b kidx = load_monster_link(z_info->k_max);
+			*last_m = m;
+			last_m = &m->next;
+			m->kind = kidx ? &k_info[kidx - 1] : NULL;
+		}
+	}
+
+	if (!cache_rd_done()) {
+		cleanup_monster();
+		return FALSE;
+	}
+
+	alloc_monster_lore();
+	return TRUE;
+}
+
 struct file_parser monster_parser = {
 	"monster",
 	init_parse_monster,
 	run_parse_monster,
 	finish_parse_monster,
-	cleanup_monster
+	cleanup_monster,
+	save_monster,
+	load_monster,
+	monster_cache_layout
 };
 
 /* Parsing functions for lore.txt */
@@ -18,6 +18,7 @@
  */
 
 #include "game-world.h"
+#include "init.h"
 #include "mon-desc.h"
 #include "mon-list.h"
 #include "project.h"
@@ -42,6 +43,7 @@ monster_list_t *monster_list_new(void)
 	}
 
 	list->entries_size = size;
+	list->race_entries = mem_zalloc(z_info->r_max * sizeof(u16b));
 
 	return list;
 }
@@ -59,6 +61,7 @@ void monster_list_free(monster_list_t *list)
 		list->entries = NULL;
 	}
 
+	mem_free(list->race_entries);
 	mem_free(list);
 	list = NULL;
 }
@@ -68,6 +71,99 @@ void monster_list_free(monster_list_t *list)
  */
 static monster_list_t *monster_list_subwindow = NULL;
 
+/**
+ * Indices of the monsters in the current cave which were visible when the
+ * list was last collected, followed by those which have become visible since
+ * (see monster_list_note_visible()).  Monsters which have since stopped being
+ * visible, died or been moved about are weeded out on collection; if the
+ * monster list has been moved about wholesale, the list is stale, and is made
+ * again by looking at every monster.
+ */
+static s16b *visible_midx = NULL;
+static int visible_count = 0;
+static int visible_max = 0;
+static bool visible_stale = TRUE;
+
+static void visible_add(int midx)
+{
+	if (visible_count == visible_max) {
+		visible_max = visible_max ? visible_max * 2 : 64;
+		visible_midx = mem_realloc(visible_midx,
+								   visible_max * sizeof(*visible_midx));
+	}
+	visible_midx[visible_count++] = midx;
+}
+
+/**
+ * Note that a monster has just become visible, so that the list need not look
+ * at every monster to find it.  Called from update_mon().
+ */
+void monster_list_note_visible(const struct monster *mon)
+{
+	if (visible_stale)
+		return;
+
+	/* Only so many can be worth keeping before the next collection */
+	if (visible_count >= 2 * z_info->level_monster_max)
+		monster_list_forget_visible();
+	else
+		visible_add(mon->midx);
+}
+
+/**
+ * Forget which monsters are visible, after the monster list has been moved
+ * about or replaced; they are found again by looking at every monster.
+ */
+void monster_list_forget_visible(void)
+{
+	visible_count = 0;
+	visible_stale = TRUE;
+}
+
+static int cmp_visible_midx(const void *a, const void *b)
+{
+	return *(const s16b *)a - *(const s16b *)b;
+}
+
+/**
+ * Bring the visible monster indices up to date, in increasing order
+ */
+static void monster_list_update_visible(void)
+{
+	int i, kept = 0;
+
+	if (visible_stale) {
+		visible_count = 0;
+		for (i = 1; i < cave_monster_max(cave); i++) {
+			struct monster *mon = cave_monster(cave, i);
+
+			if (mon->race && mflag_has(mon->mflag, MFLAG_VISIBLE))
+				visible_add(i);
+		}
+		visible_stale = FALSE;
+		return;
+	}
+
+	if (visible_count > 1)
+		sort(visible_midx, visible_count, sizeof(*visible_midx),
+			 cmp_visible_midx);
+
+	/* Keep each monster which is still visible once */
+	for (i = 0; i < visible_count; i++) {
+		int midx = visible_midx[i];
+		struct monster *mon;
+
+		if (midx <= 0 || midx >= cave_monster_max(cave)) continue;
+		if (kept && visible_midx[kept - 1] == midx) continue;
+
+		mon = cave_monster(cave, midx);
+		if (!mon->race || !mflag_has(mon->mflag, MFLAG_VISIBLE)) continue;
+
+		visible_midx[kept++] = midx;
+	}
+	visible_count = kept;
+}
+
 /**
  * Initialize the monster list module.
  */
@@ -82,6 +178,10 @@ void monster_list_init(void)
 void monster_list_finalize(void)
 {
 	monster_list_free(monster_list_subwindow);
+	mem_free(visible_midx);
+	visible_midx = NULL;
+	visible_count = visible_max = 0;
+	visible_stale = TRUE;
 }
 
 /**
@@ -110,11 +210,14 @@ static bool monster_list_needs_update(const monster_list_t *list)
 }
 
 /**
- * Zero out the contents of a monster list. If needed, this function will
- * reallocate the entry list if the number of monsters has changed.
+ * Zero out the counts of a monster list, ready for them to be collected again.
+ * If needed, this function will reallocate the entry list if the number of
+ * monsters has changed.
  */
 void monster_list_reset(monster_list_t *list)
 {
+	int i;
+
 	if (list == NULL || list->entries == NULL)
 		return;
 
@@ -124,56 +227,81 @@ void monster_list_reset(monster_list_t *list)
 	if ((int)list->entries_size < cave_monster_max(cave)) {
 		list->entries = mem_realloc(list->entries, sizeof(list->entries[0])
 									* cave_monster_max(cave));
+		memset(list->entries + list->entries_size, 0,
+			   (cave_monster_max(cave) - list->entries_size) *
+			   sizeof(monster_list_entry_t));
 		list->entries_size = cave_monster_max(cave);
 	}
 
-	memset(list->entries, 0, list->entries_size * sizeof(monster_list_entry_t));
+	/* Keep the races, which are likely to be seen again, in their order, but
+	 * count their monsters afresh */
+	for (i = 0; i < list->distinct_entries; i++) {
+		monster_list_entry_t *entry = &list->entries[i];
+
+		memset(entry->count, 0, sizeof(entry->count));
+		memset(entry->asleep, 0, sizeof(entry->asleep));
+	}
 	memset(list->total_entries, 0, MONSTER_LIST_SECTION_MAX * sizeof(u16b));
 	memset(list->total_monsters, 0, MONSTER_LIST_SECTION_MAX * sizeof(u16b));
-	list->distinct_entries = 0;
 	list->creation_turn = 0;
+}
+
+/**
+ * Find the list entry for a monster race, adding one at the end if asked
+ */
+static monster_list_entry_t *monster_list_entry(monster_list_t *list,
+												struct monster_race *race,
+												bool add)
+{
+	monster_list_entry_t *entry;
+	u16b index = list->race_entries[race->ridx];
+
+	if (index)
+		return &list->entries[index - 1];
+
+	if (!add || list->distinct_entries >= list->entries_size)
+		return NULL;
+
+	/* New races go at the end, and the list needs sorting again */
+	entry = &list->entries[list->distinct_entries++];
+	memset(entry, 0, sizeof(monster_list_entry_t));
+	entry->race = race;
+	list->race_entries[race->ridx] = list->distinct_entries;
 	list->sorted = FALSE;
+
+	return entry;
 }
 
 /**
  * Collect monster information from the current cave's monster list.
+ *
+ * Only the monsters known to be visible are looked at, and entries for races
+ * still in view are kept from one collection to the next, so the list only
+ * needs sorting again when a new race turns up.
  */
 void monster_list_collect(monster_list_t *list)
 {
-	int i;
+	int i, kept;
+	bool update;
 
 	if (list == NULL || list->entries == NULL)
 		return;
 
-	/* Use cave_monster_max() here in case the monster list isn't compacted. */
-	for (i = 1; i < cave_monster_max(cave); i++) {
-		struct monster *mon = cave_monster(cave, i);
-		monster_list_entry_t *entry = NULL;
-		int j, field;
+	update = monster_list_needs_update(list);
+	monster_list_update_visible();
+
+	for (i = 0; i < visible_count; i++) {
+		struct monster *mon = cave_monster(cave, visible_midx[i]);
+		monster_list_entry_t *entry;
+		int field;
 		bool los = FALSE;
 
-		/* Only consider visible, known monsters */
-		if (!mflag_has(mon->mflag, MFLAG_VISIBLE) ||
-			mflag_has(mon->mflag, MFLAG_UNAWARE))
+		/* Only consider known monsters */
+		if (mflag_has(mon->mflag, MFLAG_UNAWARE))
 			continue;
 
-		/* Find or add a list entry. */
-		for (j = 0; j < (int)list->entries_size; j++) {
-			if (list->entries[j].race == NULL) {
-				/* We found an empty slot, so add this race here. */
-				entry = &list->entries[j];
-				memset(entry, 0, sizeof(monster_list_entry_t));
-				entry->race = mon->race;
-
-				break;
-			}
-			else if (list->entries[j].race == mon->race) {
-				/* We found a matching race and we'll use that. */
-				entry = &list->entries[j];
-				break;
-			}
-		}
-
+		/* Find or add a list entry, only adding when recounting */
+		entry = monster_list_entry(list, mon->race, update);
 		if (entry == NULL)
 			continue;
 
@@ -183,7 +311,7 @@ void monster_list_collect(monster_list_t *list)
 		entry->attr = mon->attr;
 
 		/* Skip the projection and location checks if nothing has changed. */
-		if (!monster_list_needs_update(list))
+		if (!update)
 			continue;
 
 		/*
@@ -208,14 +336,32 @@ void monster_list_collect(monster_list_t *list)
 
 	/* Skip calculations if nothing has changed, otherwise this will yield
 	 * incorrect numbers. */
-	if (!monster_list_needs_update(list))
+	if (!update)
 		return;
 
-	/* Collect totals for easier calculations of the list. */
-	for (i = 0; i < (int)list->entries_size; i++) {
-		if (list->entries[i].race == NULL)
+	/* Drop the races no longer seen, keeping the rest in order */
+	for (i = 0, kept = 0; i < list->distinct_entries; i++) {
+		monster_list_entry_t *entry = &list->entries[i];
+
+		if (!entry->count[MONSTER_LIST_SECTION_LOS] &&
+			!entry->count[MONSTER_LIST_SECTION_ESP]) {
+			list->race_entries[entry->race->ridx] = 0;
 			continue;
+		}
 
+		if (kept != i) {
+			list->entries[kept] = *entry;
+			list->race_entries[entry->race->ridx] = kept + 1;
+		}
+		kept++;
+	}
+	if (kept < list->distinct_entries)
+		memset(&list->entries[kept], 0,
+			   (list->distinct_entries - kept) * sizeof(monster_list_entry_t));
+	list->distinct_entries = kept;
+
+	/* Collect totals for easier calculations of the list. */
+	for (i = 0; i < list->distinct_entries; i++) {
 		if (list->entries[i].count[MONSTER_LIST_SECTION_LOS] > 0)
 			list->total_entries[MONSTER_LIST_SECTION_LOS]++;
 
@@ -226,11 +372,9 @@ void monster_list_collect(monster_list_t *list)
 			list->entries[i].count[MONSTER_LIST_SECTION_LOS];
 		list->total_monsters[MONSTER_LIST_SECTION_ESP] +=
 			list->entries[i].count[MONSTER_LIST_SECTION_ESP];
-		list->distinct_entries++;
 	}
 
 	list->creation_turn = turn;
-	list->sorted = FALSE;
 }
 
 /**
@@ -260,6 +404,13 @@ int monster_list_standard_compare(const void *a, const void *b)
 	if (ar->power < br->power)
 		return 1;
 
+	/* Keep races which rank the same in a fixed order */
+	if (ar->ridx < br->ridx)
+		return -1;
+
+	if (ar->ridx > br->ridx)
+		return 1;
+
 	return 0;
 }
 
@@ -269,7 +420,7 @@ int monster_list_standard_compare(const void *a, const void *b)
 void monster_list_sort(monster_list_t *list,
 					   int (*compare)(const void *, const void *))
 {
-	size_t elements;
+	size_t elements, i;
 
 	if (list == NULL || list->entries == NULL)
 		return;
@@ -283,6 +434,8 @@ void monster_list_sort(monster_list_t *list,
 		return;
 
 	sort(list->entries, elements, sizeof(list->entries[0]), compare);
+	for (i = 0; i < elements; i++)
+		list->race_entries[list->entries[i].race->ridx] = i + 1;
 	list->sorted = TRUE;
 }
 
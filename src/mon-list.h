@@ -39,6 +39,7 @@ typedef struct monster_list_entry_s {
 typedef struct monster_list_s {
 	monster_list_entry_t *entries;
 	size_t entries_size;
+	u16b *race_entries;	/* Index into entries plus one, by race index */
 	u16b distinct_entries;
 	s32b creation_turn;
 	bool sorted;
@@ -53,6 +54,8 @@ void monster_list_finalize(void);
 monster_list_t *monster_list_shared_instance(void);
 void monster_list_reset(monster_list_t *list);
 void monster_list_collect(monster_list_t *list);
+void monster_list_note_visible(const struct monster *mon);
+void monster_list_forget_visible(void);
 int monster_list_standard_compare(const void *a, const void *b);
 void monster_list_sort(monster_list_t *list,
 					   int (*compare)(const void *, const void *));
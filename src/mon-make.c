@@ -19,10 +19,13 @@
 #include "angband.h"
 #include "alloc.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-desc.h"
+#include "mon-list.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "mon-timed.h"
 #include "mon-util.h"
 #include "obj-identify.h"
@@ -39,6 +42,7 @@ s16b num_repro;
 
 static s16b alloc_race_size;
 static struct alloc_entry *alloc_race_table;
+static long *alloc_race_total;
 
 static void init_race_allocs(void) {
 	int i;
@@ -77,8 +81,9 @@ static void init_race_allocs(void) {
 
 	/*** Initialize monster allocation info ***/
 
-	/* Allocate the alloc_race_table */
+	/* Allocate the alloc_race_table, and the running totals for it */
 	alloc_race_table = mem_zalloc(alloc_race_size * sizeof(alloc_entry));
+	alloc_race_total = mem_zalloc(alloc_race_size * sizeof(long));
 
 	/* Get the table entry */
 	table = alloc_race_table;
@@ -120,6 +125,7 @@ static void init_race_allocs(void) {
 }
 
 static void cleanup_race_allocs(void) {
+	mem_free(alloc_race_total);
 	mem_free(alloc_race_table);
 }
 
@@ -157,6 +163,7 @@ void delete_monster_idx(int m_idx)
 
 	/* Monster is gone */
 	cave->squares[y][x].mon = 0;
+	mon_buckets_remove(cave, mon);
 
 	/* Delete objects */
 	obj = mon->held_obj;
@@ -334,6 +341,11 @@ void compact_monsters(int num_to_compact)
 		/* Compress "cave->mon_max" */
 		cave->mon_max--;
 	}
+
+	/* Monsters have moved about */
+	mon_sched_invalidate(cave);
+	mon_buckets_invalidate(cave);
+	monster_list_forget_visible();
 }
 
 
@@ -382,6 +394,9 @@ void wipe_mon_list(struct chunk *c, struct player *p)
 
 	/* Reset "cave->mon_max" */
 	c->mon_max = 1;
+	mon_sched_invalidate(c);
+	mon_buckets_invalidate(c);
+	monster_list_forget_visible();
 
 	/* Reset "mon_cnt" */
 	c->mon_cnt = 0;
@@ -472,28 +487,30 @@ void get_mon_num_prep(bool (*get_mon_num_hook)(struct monster_race *race))
 }
 
 /**
- * Helper function for get_mon_num(). Scans the prepared monster allocation
- * table and picks a random monster. Returns the index of a monster in
- * `table`.
+ * Helper function for get_mon_num(). Picks a random monster from the first
+ * `num` entries of the prepared monster allocation table, using the running
+ * totals of their "prob3" fields in `totals`.
  */
-static struct monster_race *get_mon_race_aux(long total,
-											 const alloc_entry *table)
+static struct monster_race *get_mon_race_aux(long total, int num,
+											 const alloc_entry *table,
+											 const long *totals)
 {
-	int i;
+	int low = 0, high = num - 1;
 
 	/* Pick a monster */
 	long value = randint0(total);
 
-	/* Find the monster */
-	for (i = 0; i < alloc_race_size; i++) {
-		/* Found the entry */
-		if (value < table[i].prob3) break;
+	/* Find the first entry whose running total exceeds the value */
+	while (low < high) {
+		int mid = (low + high) / 2;
 
-		/* Decrement */
-		value -= table[i].prob3;
+		if (totals[mid] > value)
+			high = mid;
+		else
+			low = mid + 1;
 	}
-	
-	return &r_info[table[i].index];
+
+	return &r_info[table[low].index];
 }
 
 /**
@@ -528,6 +545,12 @@ struct monster_race *get_mon_num(int level)
 
 	alloc_entry *table = alloc_race_table;
 
+	/* Check the date once, rather than for every monster */
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+	bool christmas = date->tm_mon == 11 && date->tm_mday >= 24 &&
+		date->tm_mday <= 26;
+
 	/* Occasionally produce a nastier monster in the dungeon */
 	if (level > 0 && one_in_(z_info->ood_monster_chance))
 		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
@@ -536,14 +559,12 @@ struct monster_race *get_mon_num(int level)
 
 	/* Process probabilities */
 	for (i = 0; i < alloc_race_size; i++) {
-		time_t cur_time = time(NULL);
-		struct tm *date = localtime(&cur_time);
-
 		/* Monsters are sorted by depth */
 		if (table[i].level > level) break;
 
 		/* Default */
 		table[i].prob3 = 0;
+		alloc_race_total[i] = total;
 
 		/* No town monsters in dungeon */
 		if ((level > 0) && (table[i].level <= 0)) continue;
@@ -552,8 +573,7 @@ struct monster_race *get_mon_num(int level)
 		race = &r_info[table[i].index];
 
 		/* No seasonal monsters outside of Christmas */
-		if (rf_has(race->flags, RF_SEASONAL) && 
-			!(date->tm_mon == 11 && date->tm_mday >= 24 && date->tm_mday <= 26))
+		if (rf_has(race->flags, RF_SEASONAL) && !christmas)
 			continue;
 
 		/* Only one copy of a a unique must be around at the same time */
@@ -570,13 +590,14 @@ struct monster_race *get_mon_num(int level)
 
 		/* Total */
 		total += table[i].prob3;
+		alloc_race_total[i] = total;
 	}
 
 	/* No legal monsters */
 	if (total <= 0) return NULL;
 
 	/* Pick a monster */
-	race = get_mon_race_aux(total, table);
+	race = get_mon_race_aux(total, i, table, alloc_race_total);
 
 	/* Try for a "harder" monster once (50%) or twice (10%) */
 	p = randint0(100);
@@ -585,7 +606,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a new monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(total, i, table, alloc_race_total);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -596,7 +617,7 @@ struct monster_race *get_mon_num(int level)
 		struct monster_race *old = race;
 
 		/* Pick a monster */
-		race = get_mon_race_aux(total, table);
+		race = get_mon_race_aux(total, i, table, alloc_race_total);
 
 		/* Keep the deepest one */
 		if (race->level < old->level) race = old;
@@ -784,6 +805,10 @@ s16b place_monster(struct chunk *c, int y, int x, struct monster *mon,
 	new_mon->fy = y;
 	new_mon->fx = x;
 	assert(square_monster(c, y, x) == new_mon);
+	mon_buckets_add(c, new_mon);
+
+	/* Work out when it moves */
+	mon_sched_start(c, new_mon);
 
 	update_mon(new_mon, c, TRUE);
 
@@ -1262,12 +1287,21 @@ bool place_new_monster(struct chunk *c, int y, int x, struct monster_race *race,
 bool pick_and_place_monster(struct chunk *c, int y, int x, int depth,
 							bool sleep, bool group_okay, byte origin)
 {
+	struct monster_race *race;
+	bool placed = FALSE;
+
+	gen_phase_begin(GEN_PHASE_MONSTERS);
+
 	/* Pick a monster race */
-	struct monster_race *race = get_mon_num(depth);
-	if (!race) return (FALSE);
+	race = get_mon_num(depth);
 
 	/* Attempt to place the monster */
-	return (place_new_monster(c, y, x, race, sleep, group_okay, origin));
+	if (race)
+		placed = place_new_monster(c, y, x, race, sleep, group_okay, origin);
+
+	gen_phase_end();
+
+	return placed;
 }
 
 
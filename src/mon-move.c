@@ -42,6 +42,7 @@
 #include "player-calcs.h"
 #include "player-util.h"
 #include "project.h"
+#include "test-hooks.h"
 #include "trap.h"
 
 
@@ -245,8 +246,8 @@ static bool near_permwall(const struct monster *mon, struct chunk *c)
  * through obstacles.
  *
  * Monsters first try to use up-to-date distance information ('sound') as
- * saved in cave->squares[y][x].cost.  Failing that, they'll try using scent
- * ('when') which is just old cost information.
+ * given by cave_flow_cost().  Failing that, they'll try using scent
+ * ('when', from cave_flow_when()) which is just old cost information.
  *
  * Tracking by 'scent' means that monsters end up near enough the player to
  * switch to 'sound' (cost), or they end up somewhere the player left via 
@@ -274,13 +275,13 @@ static bool get_moves_flow(struct chunk *c, struct monster *mon)
 		return (FALSE);
 
 	/* The player is not currently near the monster grid */
-	if (c->squares[my][mx].when < c->squares[py][px].when)
+	if (cave_flow_when(c, my, mx) < cave_flow_when(c, py, px))
 		/* If the player has never been near this grid, abort */
-		if (c->squares[my][mx].when == 0) return FALSE;
+		if (cave_flow_when(c, my, mx) == 0) return FALSE;
 
 	/* Monster is too far away to notice the player */
-	if (c->squares[my][mx].cost > z_info->max_flow_depth) return FALSE;
-	if (c->squares[my][mx].cost > mon->race->aaf) return FALSE;
+	if (cave_flow_cost(c, my, mx) > z_info->max_flow_depth) return FALSE;
+	if (cave_flow_cost(c, my, mx) > mon->race->aaf) return FALSE;
 
 	/* If the player can see monster, set target and run towards them */
 	if (square_isview(c, my, mx)) {
@@ -295,22 +296,25 @@ static bool get_moves_flow(struct chunk *c, struct monster *mon)
 		/* Get the location */
 		int y = my + ddy_ddd[i];
 		int x = mx + ddx_ddd[i];
+		int when, cost;
 
 		/* Bounds check */
 		if (!square_in_bounds(c, y, x)) continue;
+		when = cave_flow_when(c, y, x);
+		cost = cave_flow_cost(c, y, x);
 
 		/* Ignore unvisited/unpassable locations */
-		if (c->squares[y][x].when == 0) continue;
+		if (when == 0) continue;
 
 		/* Ignore locations whose data is more stale */
-		if (c->squares[y][x].when < best_when) continue;
+		if (when < best_when) continue;
 
 		/* Ignore locations which are farther away */
-		if (c->squares[y][x].cost > best_cost) continue;
+		if (cost > best_cost) continue;
 
 		/* Save the cost and time */
-		best_when = c->squares[y][x].when;
-		best_cost = c->squares[y][x].cost;
+		best_when = when;
+		best_cost = cost;
 		best_direction = i;
 		found_direction = TRUE;
 	}
@@ -353,16 +357,16 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 	int my = mon->fy, mx = mon->fx;
 
 	/* If the player is not currently near the monster, no reason to flow */
-	if (c->squares[my][mx].when < c->squares[py][px].when)
+	if (cave_flow_when(c, my, mx) < cave_flow_when(c, py, px))
 		return FALSE;
 
 	/* Monster is too far away to use flow information */
-	if (c->squares[my][mx].cost > z_info->max_flow_depth) return FALSE;
-	if (c->squares[my][mx].cost > mon->race->aaf) return FALSE;
+	if (cave_flow_cost(c, my, mx) > z_info->max_flow_depth) return FALSE;
+	if (cave_flow_cost(c, my, mx) > mon->race->aaf) return FALSE;
 
 	/* Check nearby grids, diagonals first */
 	for (i = 7; i >= 0; i--) {
-		int dis, score;
+		int dis, score, when;
 
 		/* Get the location */
 		int y = my + ddy_ddd[i];
@@ -370,9 +374,10 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 
 		/* Bounds check */
 		if (!square_in_bounds(c, y, x)) continue;
+		when = cave_flow_when(c, y, x);
 
 		/* Ignore illegal & older locations */
-		if (c->squares[y][x].when == 0 || c->squares[y][x].when < best_when)
+		if (when == 0 || when < best_when)
 			continue;
 
 		/* Calculate distance of this grid from our target */
@@ -382,7 +387,7 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		 * First half of calculation is inversely proportional to distance
 		 * Second half is inversely proportional to grid's distance from player
 		 */
-		score = 5000 / (dis + 3) - 500 / (c->squares[y][x].cost + 1);
+		score = 5000 / (dis + 3) - 500 / (cave_flow_cost(c, y, x) + 1);
 
 		/* No negative scores */
 		if (score < 0) score = 0;
@@ -391,7 +396,7 @@ static bool get_moves_fear(struct chunk *c, struct monster *mon)
 		if (score < best_score) continue;
 
 		/* Save the score and time */
-		best_when = c->squares[y][x].when;
+		best_when = when;
 		best_score = score;
 
 		/* Save the location */
@@ -590,10 +595,10 @@ static bool find_safety(struct chunk *c, struct monster *mon)
 			if (!square_ispassable(cave, y, x)) continue;
 
 			/* Ignore grids very far from the player */
-			if (c->squares[y][x].when < c->squares[py][px].when) continue;
+			if (cave_flow_when(c, y, x) < cave_flow_when(c, py, px)) continue;
 
 			/* Ignore too-distant grids */
-			if (c->squares[y][x].cost > c->squares[fy][fx].cost + 2 * d)
+			if (cave_flow_cost(c, y, x) > cave_flow_cost(c, fy, fx) + 2 * d)
 				continue;
 
 			/* Check for absence of shot (more or less) */
@@ -902,35 +907,46 @@ static bool monster_can_flow(struct chunk *c, struct monster *mon)
 	assert(c);
 
 	/* Check the flow (normal aaf is about 20) */
-	if ((c->squares[fy][fx].when == c->squares[player->py][player->px].when) &&
-	    (c->squares[fy][fx].cost < z_info->max_flow_depth) &&
-	    (c->squares[fy][fx].cost < mon->race->aaf))
+	if ((cave_flow_when(c, fy, fx) ==
+		 cave_flow_when(c, player->py, player->px)) &&
+	    (cave_flow_cost(c, fy, fx) < z_info->max_flow_depth) &&
+	    (cave_flow_cost(c, fy, fx) < mon->race->aaf))
 		return TRUE;
 	return FALSE;
 }
 
 /**
- * Determine whether a monster is active or passive
+ * Whether a monster is close enough to the player to be active
  */
-static bool monster_check_active(struct chunk *c, struct monster *mon)
+static bool monster_is_active(struct chunk *c, struct monster *mon)
 {
 	/* Character is inside scanning range */
 	if (mon->cdis <= mon->race->aaf)
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+		return TRUE;
 
 	/* Monster is hurt */
-	else if (mon->hp < mon->maxhp)
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+	if (mon->hp < mon->maxhp)
+		return TRUE;
 
 	/* Monster can "see" the player (checked backwards) */
-	else if (square_isview(c, mon->fy, mon->fx))
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+	if (square_isview(c, mon->fy, mon->fx))
+		return TRUE;
 
 	/* Monster can "smell" the player from far away (flow) */
-	else if (monster_can_flow(c, mon))
-		mflag_on(mon->mflag, MFLAG_ACTIVE);
+	if (monster_can_flow(c, mon))
+		return TRUE;
 
 	/* Otherwise go passive */
+	return FALSE;
+}
+
+/**
+ * Determine whether a monster is active or passive
+ */
+static bool monster_check_active(struct chunk *c, struct monster *mon)
+{
+	if (monster_is_active(c, mon))
+		mflag_on(mon->mflag, MFLAG_ACTIVE);
 	else
 		mflag_off(mon->mflag, MFLAG_ACTIVE);
 
@@ -1534,7 +1550,7 @@ static void process_monster(struct chunk *c, struct monster *mon)
 /**
  * Monster regeneration of HPs.
  */
-static void regen_monster(struct monster *mon)
+void regen_monster(struct monster *mon)
 {
 	/* Regenerate (if needed) */
 	if (mon->hp < mon->maxhp) {
@@ -1560,6 +1576,487 @@ static void regen_monster(struct monster *mon)
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Monster turn scheduling
+ *
+ * Rather than hand every monster its energy on every game turn, each monster
+ * keeps the game turn its energy has been counted up to (energy_turn), and
+ * sits in a heap keyed on the game turn it will next have enough energy to
+ * move (due_turn).  The energy it would have had from a visit every game turn
+ * is made up from its speed whenever it is needed, so each call to
+ * process_monsters() only has to look at the monsters which actually move.
+ *
+ * A monster has had its energy for the current game turn once it has been
+ * handled, or once the minimum_energy 0 pass of process_monsters() has gone
+ * past its index (as a visit to every monster on every turn would have done).
+ * ------------------------------------------------------------------------ */
+
+/**
+ * due_turn of a monster which is due this game turn and waiting to move
+ */
+#define DUE_READY	-1
+
+/**
+ * How far ahead to look for monsters which will never get enough energy
+ */
+#define DUE_NEVER	1000
+
+struct sched_entry {
+	s32b due;
+	s16b midx;
+};
+
+struct monster_schedule {
+	struct sched_entry *heap;	/**< Monsters by the game turn they move */
+	int heap_count;
+	int heap_max;
+
+	s16b *ready;				/**< Monsters due this game turn */
+	int ready_count;
+	int ready_max;
+
+	s16b *handled;				/**< Monsters with MFLAG_HANDLED set */
+	int handled_count;
+	int handled_max;
+
+	bool stale;					/**< Indices have moved; rebuild from scratch */
+
+	s32b sweep_turn;			/**< Game turn of the last minimum 0 pass */
+	int sweep_pos;				/**< Monsters above this have had that turn */
+};
+
+static struct monster_schedule *sched_get(struct chunk *c)
+{
+	if (!c->sched) {
+		c->sched = mem_zalloc(sizeof(*c->sched));
+		c->sched->stale = TRUE;
+	}
+	return c->sched;
+}
+
+/**
+ * Add a monster index to one of the schedule's index lists
+ */
+static void sched_list_add(s16b **list, int *count, int *max, int midx)
+{
+	if (*count == *max) {
+		*max = *max ? *max * 2 : 64;
+		*list = mem_realloc(*list, *max * sizeof(**list));
+	}
+	(*list)[(*count)++] = midx;
+}
+
+static bool sched_entry_before(const struct sched_entry *a,
+							   const struct sched_entry *b)
+{
+	return a->due < b->due || (a->due == b->due && a->midx > b->midx);
+}
+
+static void sched_sift_down(struct monster_schedule *s, int i)
+{
+	while (TRUE) {
+		int l = 2 * i + 1, r = l + 1, best = i;
+		struct sched_entry tmp;
+
+		if (l < s->heap_count && sched_entry_before(&s->heap[l], &s->heap[best]))
+			best = l;
+		if (r < s->heap_count && sched_entry_before(&s->heap[r], &s->heap[best]))
+			best = r;
+		if (best == i) return;
+
+		tmp = s->heap[i];
+		s->heap[i] = s->heap[best];
+		s->heap[best] = tmp;
+		i = best;
+	}
+}
+
+static void sched_push(struct monster_schedule *s, s32b due, int midx)
+{
+	int i;
+
+	if (s->heap_count == s->heap_max) {
+		s->heap_max = s->heap_max ? s->heap_max * 2 : 64;
+		s->heap = mem_realloc(s->heap, s->heap_max * sizeof(*s->heap));
+	}
+
+	/* Sift up */
+	i = s->heap_count++;
+	s->heap[i].due = due;
+	s->heap[i].midx = midx;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		struct sched_entry tmp;
+
+		if (!sched_entry_before(&s->heap[i], &s->heap[parent])) break;
+		tmp = s->heap[i];
+		s->heap[i] = s->heap[parent];
+		s->heap[parent] = tmp;
+		i = parent;
+	}
+}
+
+static struct sched_entry sched_pop(struct monster_schedule *s)
+{
+	struct sched_entry top = s->heap[0];
+
+	s->heap[0] = s->heap[--s->heap_count];
+	sched_sift_down(s, 0);
+	return top;
+}
+
+/**
+ * The net speed of a monster, with timed effects
+ */
+static int monster_net_speed(const struct monster *mon)
+{
+	int mspeed = mon->mspeed;
+
+	if (mon->m_timed[MON_TMD_FAST])
+		mspeed += 10;
+	if (mon->m_timed[MON_TMD_SLOW])
+		mspeed -= 10;
+
+	return mspeed;
+}
+
+/**
+ * Whether a monster has already had its energy for the current game turn
+ */
+static bool sched_had_turn(struct chunk *c, const struct monster *mon)
+{
+	if (mflag_has(mon->mflag, MFLAG_HANDLED))
+		return TRUE;
+
+	return c->sched && c->sched->sweep_turn == turn &&
+		mon->midx > c->sched->sweep_pos;
+}
+
+/**
+ * The game turn on which a monster will next have enough energy to move
+ */
+static s32b sched_due(const struct monster *mon)
+{
+	int need = z_info->move_energy - mon->energy;
+	int gain;
+
+	if (need <= 0)
+		return mon->energy_turn;
+
+	/* Look again later if this monster is too slow to ever move */
+	gain = turn_energy(monster_net_speed(mon));
+	if (gain <= 0)
+		return mon->energy_turn + DUE_NEVER;
+
+	return mon->energy_turn + (need + gain - 1) / gain;
+}
+
+/**
+ * Work out when a monster next moves, and queue it for then
+ */
+static void sched_queue(struct chunk *c, struct monster *mon)
+{
+	struct monster_schedule *s = sched_get(c);
+
+	mon->due_turn = sched_due(mon);
+	if (s->stale) return;
+
+	/* Entries for dead or rescheduled monsters are only dropped when they
+	 * come up, so start again if there are too many of them */
+	if (s->heap_count > 4 * cave_monster_max(c) + 64)
+		s->stale = TRUE;
+	else
+		sched_push(s, mon->due_turn, mon->midx);
+}
+
+/**
+ * Rebuild the whole schedule from the monsters themselves, after the monster
+ * list has been moved about
+ */
+static void sched_rebuild(struct chunk *c)
+{
+	struct monster_schedule *s = sched_get(c);
+	int i;
+
+	s->heap_count = 0;
+	s->ready_count = 0;
+	s->handled_count = 0;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+
+		if (mflag_has(mon->mflag, MFLAG_HANDLED))
+			sched_list_add(&s->handled, &s->handled_count, &s->handled_max, i);
+
+		if (mon->due_turn == DUE_READY) {
+			sched_list_add(&s->ready, &s->ready_count, &s->ready_max, i);
+		} else {
+			mon->due_turn = sched_due(mon);
+			sched_push(s, mon->due_turn, i);
+		}
+	}
+
+	s->stale = FALSE;
+}
+
+/**
+ * Bring a monster's energy up to date with the current game turn, as if it
+ * had been visited on every turn so far.
+ */
+void mon_sched_settle(struct chunk *c, struct monster *mon)
+{
+	s32b target = turn + (sched_had_turn(c, mon) ? 1 : 0);
+
+	if (mon->energy_turn >= target) return;
+
+	mon->energy += (target - mon->energy_turn) *
+		turn_energy(monster_net_speed(mon));
+	mon->energy_turn = target;
+}
+
+/**
+ * Bring the energy of every monster in a chunk up to date
+ */
+void mon_sched_settle_all(struct chunk *c)
+{
+	int i;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race)
+			mon_sched_settle(c, mon);
+	}
+}
+
+/**
+ * Start scheduling a monster which has just been put into a chunk, with
+ * whatever energy it came with.
+ */
+void mon_sched_start(struct chunk *c, struct monster *mon)
+{
+	struct monster_schedule *s = sched_get(c);
+
+	mon->energy_turn = turn + (sched_had_turn(c, mon) ? 1 : 0);
+
+	if (mflag_has(mon->mflag, MFLAG_HANDLED) && !s->stale)
+		sched_list_add(&s->handled, &s->handled_count, &s->handled_max,
+					   mon->midx);
+
+	sched_queue(c, mon);
+}
+
+/**
+ * Reschedule a monster whose speed has changed; the caller should have
+ * settled its energy at the old speed first.
+ */
+void mon_sched_update(struct chunk *c, struct monster *mon)
+{
+	/* It will be dealt with this turn anyway */
+	if (mon->due_turn == DUE_READY) return;
+
+	sched_queue(c, mon);
+}
+
+/**
+ * Set a monster's energy as of now
+ */
+void monster_set_energy(struct chunk *c, struct monster *mon, byte energy)
+{
+	mon_sched_settle(c, mon);
+	mon->energy = energy;
+	sched_queue(c, mon);
+}
+
+/**
+ * Forget the schedule after monster indices have changed; it is rebuilt when
+ * next needed.
+ */
+void mon_sched_invalidate(struct chunk *c)
+{
+	if (c->sched)
+		c->sched->stale = TRUE;
+}
+
+void mon_sched_free(struct chunk *c)
+{
+	if (!c->sched) return;
+
+	mem_free(c->sched->heap);
+	mem_free(c->sched->ready);
+	mem_free(c->sched->handled);
+	mem_free(c->sched);
+	c->sched = NULL;
+}
+
+/**
+ * The first game turn from now on which process_monsters() may do more than
+ * hand out energy
+ */
+s32b mon_sched_next_turn(struct chunk *c)
+{
+	struct monster_schedule *s = c->sched;
+	s32b next;
+
+	/* No telling */
+	if (!s || s->stale || s->ready_count)
+		return turn;
+
+	/* Every monster is visited on the regeneration turns */
+	if (turn % 100 == 0)
+		return turn;
+	next = turn - turn % 100 + 100;
+
+	/* Otherwise it's the first monster due (or a dead one, which is fine) */
+	if (s->heap_count && s->heap[0].due < next)
+		next = MAX(s->heap[0].due, turn);
+
+	return next;
+}
+
+/**
+ * Let the monsters go through the game turns from now until just before the
+ * given one, if all that any of them would do is gain energy and use it up
+ * again.  That is so for passive monsters and mimics (see
+ * process_monster_turn()), and nothing can make them active while the player
+ * stays where they are and no monster moves, so the turns are counted out
+ * without visiting every monster on every one.  The caller must make sure nothing else happens on
+ * those turns, and that none of them is a regeneration turn.
+ *
+ * Returns FALSE, having changed nothing, if some monster would act.
+ */
+bool mon_sched_pass_turns(struct chunk *c, s32b until)
+{
+	struct monster_schedule *s = sched_get(c);
+	int i;
+
+	if (s->ready_count || s->handled_count)
+		return FALSE;
+	if (s->stale)
+		sched_rebuild(c);
+
+	/* Every monster due to move before then must have nothing to do */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race || mon->due_turn >= until) continue;
+
+		if (!is_mimicking(mon) && monster_is_active(c, mon))
+			return FALSE;
+	}
+
+	/* Count out their turns */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		int gain;
+		s32b t;
+
+		if (!mon->race || mon->due_turn >= until) continue;
+
+		mon_sched_settle(c, mon);
+		gain = turn_energy(monster_net_speed(mon));
+		for (t = mon->energy_turn; t < until; t++) {
+			bool moving = mon->energy >= z_info->move_energy ? TRUE : FALSE;
+
+			mon->energy += gain;
+			if (moving) {
+				mon->energy -= z_info->move_energy;
+				if (!is_mimicking(mon))
+					mflag_off(mon->mflag, MFLAG_ACTIVE);
+			}
+		}
+		mon->energy_turn = until;
+		sched_queue(c, mon);
+	}
+
+	return TRUE;
+}
+
+/**
+ * The monsters the minimum_energy 0 pass didn't get to before it had to stop
+ * get no energy for this game turn.
+ */
+static void sched_skip_turn(struct chunk *c)
+{
+	struct monster_schedule *s = c->sched;
+	int i;
+
+	for (i = 1; i < s->sweep_pos && i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race || mflag_has(mon->mflag, MFLAG_HANDLED)) continue;
+
+		mon_sched_settle(c, mon);
+		mon->energy_turn = turn + 1;
+		sched_queue(c, mon);
+	}
+}
+
+/**
+ * Let a monster which has just used up the energy for a move take its turn
+ */
+void monster_take_turn(struct chunk *c, struct monster *mon)
+{
+	/* Mimics lie in wait */
+	if (is_mimicking(mon)) return;
+
+	/* Check if the monster is active */
+	if (monster_check_active(c, mon)) {
+		/* Process timed effects - skip turn if necessary */
+		if (process_monster_timed(c, mon))
+			return;
+
+		/* Set this monster to be the current actor */
+		c->mon_current = mon->midx;
+
+		/* Process the monster */
+		process_monster(c, mon);
+
+		/* Monster is no longer current */
+		c->mon_current = -1;
+	}
+}
+
+/**
+ * Give a monster its energy for the game turn, and let it move if it had
+ * enough energy to start with.
+ */
+static void process_monster_turn(struct chunk *c, struct monster *mon,
+								 bool regen)
+{
+	struct monster_schedule *s = c->sched;
+	bool moving;
+
+	/* Does this monster have enough energy to move? */
+	moving = mon->energy >= z_info->move_energy ? TRUE : FALSE;
+
+	/* Prevent reprocessing */
+	mflag_on(mon->mflag, MFLAG_HANDLED);
+	sched_list_add(&s->handled, &s->handled_count, &s->handled_max,
+				   mon->midx);
+
+	/* Handle monster regeneration if requested */
+	if (regen)
+		regen_monster(mon);
+
+	/* Give this monster some energy */
+	mon->energy += turn_energy(monster_net_speed(mon));
+	mon->energy_turn = turn + 1;
+
+	/* End the turn of monsters without enough energy to move */
+	if (!moving)
+		return;
+
+	/* Use up "some" energy */
+	mon->energy -= z_info->move_energy;
+
+	monster_take_turn(c, mon);
+}
+
+static int sched_compare_midx(const void *a, const void *b)
+{
+	return *(const s16b *)b - *(const s16b *)a;
+}
+
 /**
  * Process all the "live" monsters, once per game turn.
  *
@@ -1567,14 +2064,18 @@ static void regen_monster(struct monster *mon)
  * (backwards, so we can excise any "freshly dead" monsters), energizing each
  * monster, and allowing fully energized monsters to move, attack, pass, etc.
  *
- * This function and its children are responsible for a considerable fraction
- * of the processor time in normal situations, greater if the character is
- * resting.
+ * Only monsters with at least minimum_energy get a go, so the player can be
+ * fitted in between faster monsters and slower ones.
+ *
+ * Monsters which would only be given energy are left to the schedule above,
+ * so only the monsters due to move on this game turn are visited, in the same
+ * order as a loop over every monster.  Every monster is still visited every
+ * 100 game turns, when they all regenerate.
  */
 void process_monsters(struct chunk *c, int minimum_energy)
 {
-	int i;
-	int mspeed;
+	struct monster_schedule *s;
+	int i, kept = 0;
 
 	/* Only process some things every so often */
 	bool regen = FALSE;
@@ -1583,73 +2084,118 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	if (turn % 100 == 0)
 		regen = TRUE;
 
-	/* Process the monsters (backwards) */
-	for (i = cave_monster_max(c) - 1; i >= 1; i--)
-	{
-		struct monster *mon;
-		bool moving;
-
-		/* Handle "leaving" */
-		if (player->is_dead || player->upkeep->generate_level) break;
-
-		/* Get a 'live' monster */
-		mon = cave_monster(cave, i);
-		if (!mon->race) continue;
-
-		/* Ignore monsters that have already been handled */
-		if (mflag_has(mon->mflag, MFLAG_HANDLED))
-			continue;
+	s = sched_get(c);
+	if (s->stale)
+		sched_rebuild(c);
 
-		/* Not enough energy to move yet */
-		if (mon->energy < minimum_energy) continue;
+	/* This pass gives every monster its energy for the turn */
+	if (minimum_energy <= 0) {
+		s->sweep_turn = turn;
+		s->sweep_pos = cave_monster_max(c);
+	}
 
-		/* Does this monster have enough energy to move? */
-		moving = mon->energy >= z_info->move_energy ? TRUE : FALSE;
+	if (regen) {
+		/* Process the monsters (backwards) */
+		for (i = cave_monster_max(c) - 1; i >= 1; i--) {
+			struct monster *mon;
 
-		/* Prevent reprocessing */
-		mflag_on(mon->mflag, MFLAG_HANDLED);
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) {
+				if (minimum_energy <= 0)
+					sched_skip_turn(c);
+				break;
+			}
+			if (minimum_energy <= 0)
+				s->sweep_pos = i;
 
-		/* Handle monster regeneration if requested */
-		if (regen)
-			regen_monster(mon);
+			/* Get a 'live' monster */
+			mon = cave_monster(c, i);
+			if (!mon->race) continue;
 
-		/* Calculate the net speed */
-		mspeed = mon->mspeed;
-		if (mon->m_timed[MON_TMD_FAST])
-			mspeed += 10;
-		if (mon->m_timed[MON_TMD_SLOW])
-			mspeed -= 10;
+			/* Ignore monsters that have already been handled */
+			if (mflag_has(mon->mflag, MFLAG_HANDLED))
+				continue;
 
-		/* Give this monster some energy */
-		mon->energy += turn_energy(mspeed);
+			/* Not enough energy to move yet */
+			mon_sched_settle(c, mon);
+			if (mon->energy < minimum_energy) continue;
 
-		/* End the turn of monsters without enough energy to move */
-		if (!moving)
-			continue;
+			process_monster_turn(c, mon, regen);
 
-		/* Use up "some" energy */
-		mon->energy -= z_info->move_energy;
+			/* The whole schedule gets rebuilt afterwards */
+			if (mon->race)
+				mon->due_turn = sched_due(mon);
+		}
 
-		/* Mimics lie in wait */
-		if (is_mimicking(mon)) continue;
+		s->ready_count = 0;
+		s->stale = TRUE;
+	} else {
+		/* Collect the monsters due to move this turn */
+		while (s->heap_count && s->heap[0].due <= turn) {
+			struct sched_entry next = sched_pop(s);
+			struct monster *mon;
+
+			if (next.midx >= cave_monster_max(c)) continue;
+			mon = cave_monster(c, next.midx);
+			if (!mon->race || mon->due_turn != next.due) continue;
+
+			mon->due_turn = DUE_READY;
+			sched_list_add(&s->ready, &s->ready_count, &s->ready_max,
+						   next.midx);
+		}
+		sort(s->ready, s->ready_count, sizeof(*s->ready), sched_compare_midx);
+
+		/* Process them (backwards) */
+		for (i = 0; i < s->ready_count; i++) {
+			int midx = s->ready[i];
+			struct monster *mon;
+
+			/* Handle "leaving" */
+			if (player->is_dead || player->upkeep->generate_level) {
+				if (minimum_energy <= 0) {
+					sched_skip_turn(c);
+					kept = 0;
+				} else {
+					/* Keep the rest for later */
+					memmove(s->ready + kept, s->ready + i,
+							(s->ready_count - i) * sizeof(*s->ready));
+					kept += s->ready_count - i;
+				}
+				break;
+			}
 
-		/* Check if the monster is active */
-		if (monster_check_active(c, mon)) {
-			/* Process timed effects - skip turn if necessary */
-			if (process_monster_timed(c, mon))
+			/* Skip duplicates and monsters that have died or been put off */
+			if (i && midx == s->ready[i - 1]) continue;
+			if (midx >= cave_monster_max(c)) continue;
+			mon = cave_monster(c, midx);
+			if (!mon->race || mon->due_turn != DUE_READY) continue;
+			if (mflag_has(mon->mflag, MFLAG_HANDLED)) {
+				sched_queue(c, mon);
 				continue;
+			}
 
-			/* Set this monster to be the current actor */
-			c->mon_current = i;
+			if (minimum_energy <= 0)
+				s->sweep_pos = midx;
 
-			/* Process the monster */
-			process_monster(c, mon);
+			/* Not enough energy to move yet */
+			mon_sched_settle(c, mon);
+			if (mon->energy < minimum_energy) {
+				s->ready[kept++] = midx;
+				continue;
+			}
 
-			/* Monster is no longer current */
-			c->mon_current = -1;
+			process_monster_turn(c, mon, FALSE);
+			if (mon->race)
+				sched_queue(c, mon);
 		}
+
+		s->ready_count = kept;
 	}
 
+	/* Every monster has now had this turn's energy */
+	if (minimum_energy <= 0)
+		s->sweep_pos = 0;
+
 	/* Update monster visibility after this */
 	/* XXX This may not be necessary */
 	player->upkeep->update |= PU_MONSTERS;
@@ -1662,9 +2208,23 @@ void process_monsters(struct chunk *c, int minimum_energy)
  */
 void reset_monsters(void)
 {
+	struct monster_schedule *s;
 	int i;
 	struct monster *mon;
 
+	s = sched_get(cave);
+
+	/* Only the handled monsters need to be looked at */
+	if (!s->stale) {
+		for (i = 0; i < s->handled_count; i++) {
+			if (s->handled[i] >= cave_monster_max(cave)) continue;
+			mon = cave_monster(cave, s->handled[i]);
+			mflag_off(mon->mflag, MFLAG_HANDLED);
+		}
+		s->handled_count = 0;
+		return;
+	}
+
 	/* Process the monsters (backwards) */
 	for (i = cave_monster_max(cave) - 1; i >= 1; i--) {
 		/* Access the monster */
@@ -1673,4 +2233,5 @@ void reset_monsters(void)
 		/* Monster is ready to go again */
 		mflag_off(mon->mflag, MFLAG_HANDLED);
 	}
+	s->handled_count = 0;
 }
@@ -18,7 +18,15 @@
 #ifndef MONSTER_MOVE_H
 #define MONSTER_MOVE_H
 
-
+void mon_sched_settle(struct chunk *c, struct monster *mon);
+void mon_sched_settle_all(struct chunk *c);
+void mon_sched_start(struct chunk *c, struct monster *mon);
+void mon_sched_update(struct chunk *c, struct monster *mon);
+void monster_set_energy(struct chunk *c, struct monster *mon, byte energy);
+s32b mon_sched_next_turn(struct chunk *c);
+bool mon_sched_pass_turns(struct chunk *c, s32b until);
+void mon_sched_invalidate(struct chunk *c);
+void mon_sched_free(struct chunk *c);
 bool multiply_monster(const struct monster *m);
 void process_monsters(struct chunk *c, int minimum_energy);
 void reset_monsters(void);
@@ -20,6 +20,7 @@
 #include "mon-desc.h"
 #include "mon-lore.h"
 #include "mon-msg.h"
+#include "mon-move.h"
 #include "mon-spell.h"
 #include "mon-timed.h"
 #include "mon-util.h"
@@ -204,7 +205,12 @@ static bool mon_set_timed(struct monster *mon, int ef_idx, int timer,
 
 	if (resisted)
 		m_note = MON_MSG_UNAFFECTED;
-	else
+	else if (ef_idx == MON_TMD_FAST || ef_idx == MON_TMD_SLOW) {
+		/* Speed changes move the monster's next turn */
+		mon_sched_settle(cave, mon);
+		mon->m_timed[ef_idx] = timer;
+		mon_sched_update(cave, mon);
+	} else
 		mon->m_timed[ef_idx] = timer;
 
 	if (player->upkeep->health_who == mon)
@@ -33,8 +33,45 @@
 #include "player-calcs.h"
 #include "player-timed.h"
 #include "player-util.h"
+#include "z-index.h"
 
 
+/**
+ * Indexes of races and bases by name, built once the game data has been
+ * parsed.  Lookups made while parsing search the lists directly.
+ */
+static struct name_index *race_names;
+static struct name_index *base_names;
+
+static void init_mon_lookup(void)
+{
+	struct monster_base *base;
+	int i;
+
+	race_names = name_index_new();
+	for (i = 0; i < z_info->r_max; i++)
+		if (r_info[i].name)
+			name_index_add(race_names, r_info[i].name, &r_info[i]);
+
+	base_names = name_index_new();
+	for (base = rb_info; base; base = base->next)
+		name_index_add(base_names, base->name, base);
+}
+
+static void cleanup_mon_lookup(void)
+{
+	name_index_free(race_names);
+	race_names = NULL;
+	name_index_free(base_names);
+	base_names = NULL;
+}
+
+struct init_module mon_lookup_module = {
+	.name = "monster/mon-util",
+	.init = init_mon_lookup,
+	.cleanup = cleanup_mon_lookup
+};
+
 /**
  * Returns the monster with the given name. If no monster has the exact name
  * given, returns the first monster with the given name as a (case-insensitive)
@@ -44,6 +81,12 @@ struct monster_race *lookup_monster(const char *name)
 {
 	int i;
 	struct monster_race *closest = NULL;
+
+	/* Look it up */
+	if (race_names) {
+		struct monster_race *race = name_index_get(race_names, name);
+		return race ? race : name_index_search(race_names, name);
+	}
 	
 	/* Look for it */
 	for (i = 0; i < z_info->r_max; i++) {
@@ -71,6 +114,10 @@ struct monster_base *lookup_monster_base(const char *name)
 {
 	struct monster_base *base;
 
+	/* Look it up */
+	if (base_names)
+		return name_index_get(base_names, name);
+
 	/* Look for it */
 	for (base = rb_info; base; base = base->next) {
 		if (streq(name, base->name))
@@ -230,9 +277,11 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 	/* Detected */
 	if (mflag_has(mon->mflag, MFLAG_MARK)) flag = TRUE;
 
-	/* Check if telepathy works */
+	/* Check if telepathy works (the player may still be placed off the
+	 * bounds of a level which is being generated) */
 	if (square_isno_esp(c, fy, fx) ||
-		square_isno_esp(c, player->py, player->px))
+		(square_in_bounds(c, player->py, player->px) &&
+		 square_isno_esp(c, player->py, player->px)))
 		telepathy_ok = FALSE;
 
 	/* Nearby */
@@ -329,6 +378,8 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 		if (!mflag_has(mon->mflag, MFLAG_VISIBLE)) {
 			/* Mark as visible */
 			mflag_on(mon->mflag, MFLAG_VISIBLE);
+			if (c == cave)
+				monster_list_note_visible(mon);
 
 			/* Draw the monster */
 			square_light_spot(c, fy, fx);
@@ -405,6 +456,10 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 
 /**
  * Updates all the (non-dead) monsters via update_mon().
+ *
+ * Monster AI needs every monster's distance from the player, so every one is
+ * visited, but update_mon() can do nothing for a monster out of sight range
+ * which isn't detected or marked as seen, so all those get is their distance.
  */
 void update_monsters(bool full)
 {
@@ -414,9 +469,22 @@ void update_monsters(bool full)
 	for (i = 1; i < cave_monster_max(cave); i++) {
 		struct monster *mon = cave_monster(cave, i);
 
-		/* Update the monster if alive */
-		if (mon->race)
-			update_mon(mon, cave, full);
+		/* Skip dead monsters */
+		if (!mon->race) continue;
+
+		/* Compute distance, as update_mon() would */
+		if (full)
+			mon->cdis = MIN(distance(player->py, player->px, mon->fy,
+									 mon->fx), 255);
+
+		/* Skip monsters which can't be seen and weren't */
+		if (mon->cdis > z_info->max_sight &&
+			!mflag_has(mon->mflag, MFLAG_MARK) &&
+			!mflag_has(mon->mflag, MFLAG_VISIBLE) &&
+			!mflag_has(mon->mflag, MFLAG_VIEW))
+			continue;
+
+		update_mon(mon, cave, FALSE);
 	}
 }
 
@@ -459,6 +527,28 @@ bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj)
 	return TRUE;
 }
 
+/**
+ * How far from the player a monster's light can reach into their view.
+ * Monsters light the grids around them, which can be up to two nearer the
+ * player than the monster itself.
+ */
+int monster_light_view_range(void)
+{
+	return z_info->max_sight + 2;
+}
+
+/**
+ * Whether a monster with light moving between two grids could change the
+ * player's view.
+ */
+static bool monster_light_in_view(int y1, int x1, int y2, int x2)
+{
+	int range = monster_light_view_range();
+
+	return distance(player->py, player->px, y1, x1) <= range ||
+		distance(player->py, player->px, y2, x2) <= range;
+}
+
 /**
  * Swap the players/monsters (if any) at two locations.
  */
@@ -483,12 +573,14 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		/* Move monster */
 		mon->fy = y2;
 		mon->fx = x2;
+		mon_buckets_move(cave, mon, y1, x1);
 
 		/* Update monster */
 		update_mon(mon, cave, TRUE);
 
 		/* Radiate light? */
-		if (rf_has(mon->race->flags, RF_HAS_LIGHT))
+		if (rf_has(mon->race->flags, RF_HAS_LIGHT) &&
+			monster_light_in_view(y1, x1, y2, x2))
 			player->upkeep->update |= PU_UPDATE_VIEW;
 
 		/* Redraw monster list */
@@ -524,12 +616,14 @@ void monster_swap(int y1, int x1, int y2, int x2)
 		/* Move monster */
 		mon->fy = y1;
 		mon->fx = x1;
+		mon_buckets_move(cave, mon, y2, x2);
 
 		/* Update monster */
 		update_mon(mon, cave, TRUE);
 
 		/* Radiate light? */
-		if (rf_has(mon->race->flags, RF_HAS_LIGHT))
+		if (rf_has(mon->race->flags, RF_HAS_LIGHT) &&
+			monster_light_in_view(y1, x1, y2, x2))
 			player->upkeep->update |= PU_UPDATE_VIEW;
 
 		/* Redraw monster list */
@@ -674,3 +768,234 @@ void update_smart_learn(struct monster *m, struct player *p, int flag,
 		m->known_pstate.el_info[element].res_level
 			= player->state.el_info[element].res_level;
 }
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Monsters by area
+ *
+ * Each chunk can keep its monsters in buckets, one for each square block of
+ * MON_BUCKET_SIZE grids on a side, so that the monsters in or near some part
+ * of the level can be found without looking at every monster.  The buckets
+ * follow monsters as they are placed, moved by monster_swap() and deleted;
+ * when the monster list is moved about they are marked stale and rebuilt from
+ * the monsters on the next query.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Width and height of the area covered by each bucket, as a power of two
+ */
+#define MON_BUCKET_SHIFT	3
+#define MON_BUCKET_SIZE		(1 << MON_BUCKET_SHIFT)
+
+struct mon_bucket {
+	s16b *midx;
+	int count;
+	int max;
+};
+
+struct monster_buckets {
+	struct mon_bucket *buckets;
+	int rows;
+	int cols;
+
+	bool stale;		/**< Indices have moved; rebuild from scratch */
+};
+
+static struct monster_buckets *buckets_get(struct chunk *c)
+{
+	if (!c->mon_buckets) {
+		struct monster_buckets *b = mem_zalloc(sizeof(*b));
+
+		b->rows = (c->height + MON_BUCKET_SIZE - 1) >> MON_BUCKET_SHIFT;
+		b->cols = (c->width + MON_BUCKET_SIZE - 1) >> MON_BUCKET_SHIFT;
+		b->buckets = mem_zalloc(b->rows * b->cols * sizeof(*b->buckets));
+		b->stale = TRUE;
+		c->mon_buckets = b;
+	}
+	return c->mon_buckets;
+}
+
+static struct mon_bucket *bucket_at(struct monster_buckets *b, int y, int x)
+{
+	return &b->buckets[(y >> MON_BUCKET_SHIFT) * b->cols +
+					   (x >> MON_BUCKET_SHIFT)];
+}
+
+static void bucket_add(struct mon_bucket *bucket, int midx)
+{
+	if (bucket->count == bucket->max) {
+		bucket->max = bucket->max ? bucket->max * 2 : 8;
+		bucket->midx = mem_realloc(bucket->midx,
+								   bucket->max * sizeof(*bucket->midx));
+	}
+	bucket->midx[bucket->count++] = midx;
+}
+
+static void bucket_remove(struct mon_bucket *bucket, int midx)
+{
+	int i;
+
+	for (i = 0; i < bucket->count; i++) {
+		if (bucket->midx[i] != midx) continue;
+		bucket->midx[i] = bucket->midx[--bucket->count];
+		return;
+	}
+}
+
+/**
+ * Put every monster back in its bucket, after the monster list has been
+ * moved about
+ */
+static void buckets_rebuild(struct chunk *c)
+{
+	struct monster_buckets *b = buckets_get(c);
+	int i;
+
+	for (i = 0; i < b->rows * b->cols; i++)
+		b->buckets[i].count = 0;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		bucket_add(bucket_at(b, mon->fy, mon->fx), i);
+	}
+
+	b->stale = FALSE;
+}
+
+/**
+ * Note a monster which has just been put on the level
+ */
+void mon_buckets_add(struct chunk *c, struct monster *mon)
+{
+	struct monster_buckets *b = buckets_get(c);
+
+	if (!b->stale)
+		bucket_add(bucket_at(b, mon->fy, mon->fx), mon->midx);
+}
+
+/**
+ * Note a monster which is about to be taken off the level
+ */
+void mon_buckets_remove(struct chunk *c, struct monster *mon)
+{
+	struct monster_buckets *b = c->mon_buckets;
+
+	if (b && !b->stale)
+		bucket_remove(bucket_at(b, mon->fy, mon->fx), mon->midx);
+}
+
+/**
+ * Note a monster which has just moved from (y, x)
+ */
+void mon_buckets_move(struct chunk *c, struct monster *mon, int y, int x)
+{
+	struct monster_buckets *b = c->mon_buckets;
+	struct mon_bucket *from, *to;
+
+	if (!b || b->stale) return;
+
+	from = bucket_at(b, y, x);
+	to = bucket_at(b, mon->fy, mon->fx);
+	if (from == to) return;
+
+	bucket_remove(from, mon->midx);
+	bucket_add(to, mon->midx);
+}
+
+/**
+ * Forget the buckets after monster indices have changed; they are rebuilt
+ * when next needed.
+ */
+void mon_buckets_invalidate(struct chunk *c)
+{
+	if (c->mon_buckets)
+		c->mon_buckets->stale = TRUE;
+}
+
+void mon_buckets_free(struct chunk *c)
+{
+	int i;
+
+	if (!c->mon_buckets) return;
+
+	for (i = 0; i < c->mon_buckets->rows * c->mon_buckets->cols; i++)
+		mem_free(c->mon_buckets->buckets[i].midx);
+	mem_free(c->mon_buckets->buckets);
+	mem_free(c->mon_buckets);
+	c->mon_buckets = NULL;
+}
+
+static int cmp_midx(const void *a, const void *b)
+{
+	return *(const s16b *)a - *(const s16b *)b;
+}
+
+/**
+ * Find the monsters in the rectangle from (y1, x1) to (y2, x2) inclusive,
+ * which is clipped to the chunk.
+ *
+ * Returns the number found, and puts their indices in *found in increasing
+ * order, which is the order a scan of the monster list would find them in.
+ * The caller frees *found with mem_free().
+ */
+int mon_buckets_rect(struct chunk *c, int y1, int x1, int y2, int x2,
+					 s16b **found)
+{
+	struct monster_buckets *b = buckets_get(c);
+	int by, bx, i, n = 0, max = 0;
+
+	*found = NULL;
+
+	if (b->stale)
+		buckets_rebuild(c);
+
+	y1 = MAX(y1, 0);
+	x1 = MAX(x1, 0);
+	y2 = MIN(y2, c->height - 1);
+	x2 = MIN(x2, c->width - 1);
+	if (y1 > y2 || x1 > x2) return 0;
+
+	for (by = y1 >> MON_BUCKET_SHIFT; by <= y2 >> MON_BUCKET_SHIFT; by++) {
+		for (bx = x1 >> MON_BUCKET_SHIFT; bx <= x2 >> MON_BUCKET_SHIFT; bx++) {
+			struct mon_bucket *bucket = &b->buckets[by * b->cols + bx];
+
+			for (i = 0; i < bucket->count; i++) {
+				struct monster *mon = cave_monster(c, bucket->midx[i]);
+
+				if (!mon->race || mon->fy < y1 || mon->fy > y2 ||
+					mon->fx < x1 || mon->fx > x2)
+					continue;
+
+				if (n == max) {
+					max = max ? max * 2 : 16;
+					*found = mem_realloc(*found, max * sizeof(**found));
+				}
+				(*found)[n++] = bucket->midx[i];
+			}
+		}
+	}
+
+	if (n > 1)
+		sort(*found, n, sizeof(**found), cmp_midx);
+	return n;
+}
+
+/**
+ * Find the monsters within distance() r of (y, x), as mon_buckets_rect()
+ */
+int mon_buckets_near(struct chunk *c, int y, int x, int r, s16b **found)
+{
+	int i, n, kept = 0;
+
+	n = mon_buckets_rect(c, y - r, x - r, y + r, x + r, found);
+	for (i = 0; i < n; i++) {
+		struct monster *mon = cave_monster(c, (*found)[i]);
+
+		if (distance(y, x, mon->fy, mon->fx) <= r)
+			(*found)[kept++] = (*found)[i];
+	}
+
+	return kept;
+}
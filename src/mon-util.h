@@ -30,10 +30,19 @@ bool match_monster_bases(const struct monster_base *base, ...);
 void update_mon(struct monster *mon, struct chunk *c, bool full);
 void update_monsters(bool full);
 bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj);
+int monster_light_view_range(void);
 void monster_swap(int y1, int x1, int y2, int x2);
 void become_aware(struct monster *m);
 bool is_mimicking(struct monster *m);
 void update_smart_learn(struct monster *m, struct player *p, int flag,
 						int pflag, int element);
+void mon_buckets_add(struct chunk *c, struct monster *mon);
+void mon_buckets_remove(struct chunk *c, struct monster *mon);
+void mon_buckets_move(struct chunk *c, struct monster *mon, int y, int x);
+void mon_buckets_invalidate(struct chunk *c);
+void mon_buckets_free(struct chunk *c);
+int mon_buckets_rect(struct chunk *c, int y1, int x1, int y2, int x2,
+					 s16b **found);
+int mon_buckets_near(struct chunk *c, int y, int x, int r, s16b **found);
 
 #endif /* MONSTER_UTILITIES_H */
@@ -323,6 +323,8 @@ struct monster {
 
 	byte mspeed;		/* Monster "speed" */
 	byte energy;		/* Monster "energy" */
+	s32b energy_turn;	/* Game turn "energy" is counted up to */
+	s32b due_turn;		/* Game turn of the next move, if queued */
 
 	byte cdis;			/* Current dis from player */
 
@@ -29,12 +29,28 @@
 #include "obj-tval.h"
 #include "obj-util.h"
 
-/** Arrays holding an index of objects to generate for a given level */
+/**
+ * Arrays holding an index of objects to generate for a given level.  For
+ * each level, obj_alloc holds the running total of the allocation
+ * probabilities of object kinds 1 to k_max - 1, so that a kind can be picked
+ * by binary search; obj_total is the overall total for the level.
+ */
 static u32b *obj_total;
-static byte *obj_alloc;
+static u32b *obj_alloc;
 
 static u32b *obj_total_great;
-static byte *obj_alloc_great;
+static u32b *obj_alloc_great;
+
+/**
+ * The same information again for choosing an object of a given tval.
+ * obj_tval_kinds lists the object kinds grouped by tval, with the kinds for
+ * tval t at positions obj_tval_start[t] to obj_tval_start[t + 1] - 1; the
+ * running totals in obj_alloc_tval are over these groups.
+ */
+static int *obj_tval_kinds;
+static int *obj_tval_start;
+static u32b *obj_alloc_tval;
+static u32b *obj_alloc_tval_great;
 
 static s16b alloc_ego_size = 0;
 static alloc_entry *alloc_ego_table;
@@ -47,6 +63,17 @@ struct money {
 static struct money *money_type;
 static int num_money_types;
 
+/**
+ * The allocation probability of an object kind at a given level, in either
+ * the standard table or the "great" table
+ */
+static int obj_alloc_rarity(const struct object_kind *kind, int lev, bool great)
+{
+	if ((lev < kind->alloc_min) || (lev > kind->alloc_max)) return 0;
+	if (great && !kind_is_good(kind)) return 0;
+	return kind->alloc_prob;
+}
+
 static void init_obj_make(void) {
 	int i, item, lev;
 	int k_max = z_info->k_max;
@@ -59,34 +86,55 @@ static void init_obj_make(void) {
 	/*** Initialize object allocation info ***/
 
 	/* Allocate and wipe */
-	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
-	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(byte));
+	obj_alloc = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_alloc_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
 	obj_total = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
 	obj_total_great = mem_zalloc((z_info->max_obj_depth + 1) * sizeof(u32b));
+	obj_alloc_tval = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_alloc_tval_great = mem_zalloc((z_info->max_obj_depth + 1) * k_max * sizeof(u32b));
+	obj_tval_kinds = mem_zalloc(k_max * sizeof(int));
+	obj_tval_start = mem_zalloc((TV_MAX + 1) * sizeof(int));
+
+	/* Group the object kinds by tval, keeping them in order within a tval */
+	for (item = 1; item < k_max; item++)
+		obj_tval_start[k_info[item].tval + 1]++;
+	for (i = 1; i <= TV_MAX; i++)
+		obj_tval_start[i] += obj_tval_start[i - 1];
+	aux = mem_zalloc(TV_MAX * sizeof(s16b));
+	for (item = 1; item < k_max; item++) {
+		int tval = k_info[item].tval;
+		obj_tval_kinds[obj_tval_start[tval] + aux[tval]++] = item;
+	}
+	mem_free(aux);
 
 	/* Init allocation data */
-	for (item = 1; item < k_max; item++) {
-		const struct object_kind *kind = &k_info[item];
+	for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
+		int ind = lev * k_max;
 
-		int min = kind->alloc_min;
-		int max = kind->alloc_max;
+		/* Running totals over all kinds */
+		for (item = 1; item < k_max; item++) {
+			int rarity = obj_alloc_rarity(&k_info[item], lev, FALSE);
+			int great = obj_alloc_rarity(&k_info[item], lev, TRUE);
 
-		/* If an item doesn't have a rarity, move on */
-		if (!kind->alloc_prob) continue;
+			obj_total[lev] += rarity;
+			obj_alloc[ind + item] = obj_total[lev];
+			obj_total_great[lev] += great;
+			obj_alloc_great[ind + item] = obj_total_great[lev];
+		}
 
-		/* Go through all the dungeon levels */
-		for (lev = 0; lev <= z_info->max_obj_depth; lev++) {
-			int rarity = kind->alloc_prob;
+		/* Running totals within each tval */
+		for (i = 0; i < TV_MAX; i++) {
+			u32b total = 0, total_great = 0;
+			int pos;
 
-			/* Save the probability in the standard table */
-			if ((lev < min) || (lev > max)) rarity = 0;
-			obj_total[lev] += rarity;
-			obj_alloc[(lev * k_max) + item] = rarity;
+			for (pos = obj_tval_start[i]; pos < obj_tval_start[i + 1]; pos++) {
+				const struct object_kind *kind = &k_info[obj_tval_kinds[pos]];
 
-			/* Save the probability in the "great" table if relevant */
-			if (!kind_is_good(kind)) rarity = 0;
-			obj_total_great[lev] += rarity;
-			obj_alloc_great[(lev * k_max) + item] = rarity;
+				total += obj_alloc_rarity(kind, lev, FALSE);
+				obj_alloc_tval[ind + pos] = total;
+				total_great += obj_alloc_rarity(kind, lev, TRUE);
+				obj_alloc_tval_great[ind + pos] = total_great;
+			}
 		}
 	}
 
@@ -179,6 +227,10 @@ static void cleanup_obj_make(void) {
 	}
 	mem_free(money_type);
 	mem_free(alloc_ego_table);
+	mem_free(obj_tval_start);
+	mem_free(obj_tval_kinds);
+	mem_free(obj_alloc_tval_great);
+	mem_free(obj_alloc_tval);
 	mem_free(obj_total_great);
 	mem_free(obj_total);
 	mem_free(obj_alloc_great);
@@ -965,39 +1017,46 @@ bool kind_is_good(const struct object_kind *kind)
 }
 
 
+/**
+ * Find the first of the running totals totals[first] to totals[last - 1]
+ * which is greater than value, or last if there is no such total.
+ */
+static int alloc_search(const u32b *totals, int first, int last, u32b value)
+{
+	while (first < last) {
+		int mid = (first + last) / 2;
+
+		if (totals[mid] > value)
+			last = mid;
+		else
+			first = mid + 1;
+	}
+
+	return first;
+}
+
 /**
  * Choose an object kind of a given tval given a dungeon level.
  */
 static struct object_kind *get_obj_num_by_kind(int level, bool good, int tval)
 {
-	/* This is the base index into obj_alloc for this dlev */
-	size_t ind, item;
+	/* This is the base index into obj_alloc_tval for this dlev */
+	size_t ind;
+	int first = obj_tval_start[tval], last = obj_tval_start[tval + 1];
 	u32b value;
-	int total = 0;
-	byte *objects = good ? obj_alloc_great : obj_alloc;
+	u32b *objects = good ? obj_alloc_tval_great : obj_alloc_tval;
 
 	/* Pick an object */
 	ind = level * z_info->k_max;
 
-	/* Get new total */
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval)
-			total += objects[ind + item];
-
 	/* No appropriate items of that tval */
-	if (!total) return NULL;
-	
-	value = randint0(total);
-	
-	for (item = 1; item < z_info->k_max; item++)
-		if (objkind_byid(item)->tval == tval) {
-			if (value < objects[ind + item]) break;
+	if (first == last || !objects[ind + last - 1]) return NULL;
 
-			value -= objects[ind + item];
-		}
+	value = randint0(objects[ind + last - 1]);
 
 	/* Return the item index */
-	return objkind_byid(item);
+	return objkind_byid(obj_tval_kinds[alloc_search(objects + ind, first,
+													last, value)]);
 }
 
 /**
@@ -1028,22 +1087,10 @@ struct object_kind *get_obj_num(int level, bool good, int tval)
 	
 	if (!good) {
 		value = randint0(obj_total[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc[ind + item];
-		}
+		item = alloc_search(obj_alloc + ind, 1, z_info->k_max, value);
 	} else {
 		value = randint0(obj_total_great[level]);
-		for (item = 1; item < z_info->k_max; item++) {
-			/* Found it */
-			if (value < obj_alloc_great[ind + item]) break;
-
-			/* Decrement */
-			value -= obj_alloc_great[ind + item];
-		}
+		item = alloc_search(obj_alloc_great + ind, 1, z_info->k_max, value);
 	}
 
 	/* Return the item index */
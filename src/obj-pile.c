@@ -635,11 +635,11 @@ struct object *floor_object_for_use(struct object *obj, int num, bool message,
 /**
  * Find and return the oldest object on the given grid marked as "ignore".
  */
-static struct object *floor_get_oldest_ignored(int y, int x)
+static struct object *floor_get_oldest_ignored(struct chunk *c, int y, int x)
 {
 	struct object *obj, *ignore = NULL;
 
-	for (obj = square_object(cave, y, x); obj; obj = obj->next)
+	for (obj = square_object(c, y, x); obj; obj = obj->next)
 		if (ignore_item_ok(obj))
 			ignore = obj;
 
@@ -656,7 +656,7 @@ static struct object *floor_get_oldest_ignored(int y, int x)
 bool floor_carry(struct chunk *c, int y, int x, struct object *drop, bool last)
 {
 	int n = 0;
-	struct object *obj, *ignore = floor_get_oldest_ignored(y, x);
+	struct object *obj, *ignore = floor_get_oldest_ignored(c, y, x);
 
 	/* Scan objects in that grid for combination */
 	for (obj = square_object(c, y, x); obj; obj = obj->next) {
@@ -818,7 +818,7 @@ void drop_near(struct chunk *c, struct object *dropped, int chance, int y,
 
 			/* Paranoia? */
 			if ((k + n) > z_info->floor_size &&
-				!floor_get_oldest_ignored(ty, tx)) continue;
+				!floor_get_oldest_ignored(c, ty, tx)) continue;
 
 			/* Calculate score */
 			s = 1000 - (d + k * 5);
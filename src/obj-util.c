@@ -40,6 +40,7 @@
 #include "player-spell.h"
 #include "player-util.h"
 #include "randname.h"
+#include "z-index.h"
 #include "z-queue.h"
 
 struct object_base *kb_info;
@@ -313,17 +314,98 @@ unsigned check_for_inscrip(const struct object *obj, const char *inscrip)
 /*** Object kind lookup functions ***/
 
 /**
- * Return the object kind with the given `tval` and `sval`, or NULL.
+ * Indexes for the lookups below, built once the game data has been parsed.
+ * Lookups made while parsing search k_info directly.
  */
-struct object_kind *lookup_kind(int tval, int sval)
+static struct object_kind **kind_svals[TV_MAX];
+static int kind_svals_max[TV_MAX];
+static struct name_index *sval_names;
+
+/**
+ * Make the key for `name` in sval_names; names are matched ignoring case
+ */
+static void sval_key(char *buf, size_t max, int tval, const char *name)
+{
+	size_t i;
+
+	strnfmt(buf, max, "%d:%s", tval, name);
+	for (i = 0; buf[i]; i++)
+		buf[i] = toupper((unsigned char)buf[i]);
+}
+
+static void init_obj_lookup(void)
 {
 	int k;
 
-	/* Look for it */
+	/* Table kinds by tval and sval, preferring the first */
 	for (k = 0; k < z_info->k_max; k++) {
 		struct object_kind *kind = &k_info[k];
-		if (kind->tval == tval && kind->sval == sval)
-			return kind;
+		if (kind->tval < 0 || kind->tval >= TV_MAX || kind->sval < 0)
+			continue;
+		if (kind->sval >= kind_svals_max[kind->tval]) {
+			int old = kind_svals_max[kind->tval];
+			kind_svals_max[kind->tval] = kind->sval + 1;
+			kind_svals[kind->tval] = mem_realloc(kind_svals[kind->tval],
+				kind_svals_max[kind->tval] * sizeof(kind));
+			memset(kind_svals[kind->tval] + old, 0,
+				(kind_svals_max[kind->tval] - old) * sizeof(kind));
+		}
+		if (!kind_svals[kind->tval][kind->sval])
+			kind_svals[kind->tval][kind->sval] = kind;
+	}
+
+	/* Index the names as lookup_sval() compares them */
+	sval_names = name_index_new();
+	for (k = 0; k < z_info->k_max; k++) {
+		struct object_kind *kind = &k_info[k];
+		char name[1024], key[1024];
+
+		if (!kind->name) continue;
+
+		obj_desc_name_format(name, sizeof name, 0, kind->name, 0, FALSE);
+		sval_key(key, sizeof key, kind->tval, name);
+		name_index_add(sval_names, key, kind);
+	}
+}
+
+static void cleanup_obj_lookup(void)
+{
+	int i;
+
+	for (i = 0; i < TV_MAX; i++) {
+		mem_free(kind_svals[i]);
+		kind_svals[i] = NULL;
+		kind_svals_max[i] = 0;
+	}
+	name_index_free(sval_names);
+	sval_names = NULL;
+}
+
+struct init_module obj_lookup_module = {
+	.name = "object/obj-util",
+	.init = init_obj_lookup,
+	.cleanup = cleanup_obj_lookup
+};
+
+/**
+ * Return the object kind with the given `tval` and `sval`, or NULL.
+ */
+struct object_kind *lookup_kind(int tval, int sval)
+{
+	int k;
+
+	/* Look it up */
+	if (sval_names) {
+		if (tval >= 0 && tval < TV_MAX && sval >= 0 &&
+			sval < kind_svals_max[tval] && kind_svals[tval][sval])
+			return kind_svals[tval][sval];
+	} else {
+		/* Look for it */
+		for (k = 0; k < z_info->k_max; k++) {
+			struct object_kind *kind = &k_info[k];
+			if (kind->tval == tval && kind->sval == sval)
+				return kind;
+		}
 	}
 
 	/* Failure */
@@ -379,6 +461,16 @@ int lookup_sval(int tval, const char *name)
 	if (sscanf(name, "%u", &r) == 1)
 		return r;
 
+	/* Look it up */
+	if (sval_names) {
+		char key[1024];
+		struct object_kind *kind;
+
+		sval_key(key, sizeof key, tval, name);
+		kind = name_index_get(sval_names, key);
+		return kind ? kind->sval : -1;
+	}
+
 	/* Look for it */
 	for (k = 0; k < z_info->k_max; k++) {
 		struct object_kind *kind = &k_info[k];
@@ -16,6 +16,7 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 
+#include "buildid.h"
 #include "init.h"
 #include "game-event.h"
 #include "message.h"
@@ -59,7 +60,7 @@ struct parser_spec {
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	const struct parser_spec *spec;
 	union {
 		wchar_t cval;
 		int ival;
@@ -77,14 +78,29 @@ struct parser_hook {
 	struct parser_spec *ftail;
 };
 
+/**
+ * Hooks are found through an open-addressed hash table on their directive,
+ * kept at most half full.
+ *
+ * The values for the current line live in an array that is reused from line
+ * to line; strings point into the parser's copy of the line, so none of them
+ * are allocated separately.  They last until the next line is parsed, as
+ * they always have.
+ */
 struct parser {
 	enum parser_error error;
 	unsigned int lineno;
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook **hook_table;
+	size_t hook_table_size;
+	size_t hook_count;
+	struct parser_value *vals;
+	size_t nvals;
+	size_t vals_max;
+	char *line;
+	size_t line_max;
 	void *priv;
 };
 
@@ -96,26 +112,57 @@ struct parser *parser_new(void) {
 	return p;
 }
 
-static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
-	while (h) {
-		if (!strcmp(h->dir, dir))
-			break;
-		h = h->next;
+/**
+ * FNV-1a hash of a directive
+ */
+static u32b hook_hash(const char *dir) {
+	u32b h = 2166136261UL;
+	while (*dir) {
+		h ^= (unsigned char)*dir++;
+		h *= 16777619UL;
 	}
 	return h;
 }
 
-static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
+/**
+ * Return the slot in the hook table for `dir`, which is either empty or holds
+ * the hook for `dir`
+ */
+static size_t hook_slot(struct parser *p, const char *dir) {
+	size_t i = hook_hash(dir) & (p->hook_table_size - 1);
+	while (p->hook_table[i] && strcmp(p->hook_table[i]->dir, dir))
+		i = (i + 1) & (p->hook_table_size - 1);
+	return i;
+}
+
+static struct parser_hook *findhook(struct parser *p, const char *dir) {
+	if (!p->hook_table_size)
+		return NULL;
+	return p->hook_table[hook_slot(p, dir)];
+}
+
+/**
+ * Put `h` in the hook table, superseding any hook for the same directive
+ */
+static void addhook(struct parser *p, struct parser_hook *h) {
+	size_t i;
+
+	if (2 * (p->hook_count + 1) > p->hook_table_size) {
+		struct parser_hook **old = p->hook_table;
+		size_t old_size = p->hook_table_size;
+
+		p->hook_table_size = old_size ? old_size * 2 : 32;
+		p->hook_table = mem_zalloc(p->hook_table_size * sizeof(*old));
+		for (i = 0; i < old_size; i++)
+			if (old[i])
+				p->hook_table[hook_slot(p, old[i]->dir)] = old[i];
+		mem_free(old);
 	}
+
+	i = hook_slot(p, h->dir);
+	if (!p->hook_table[i])
+		p->hook_count++;
+	p->hook_table[i] = h;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -215,16 +262,14 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	struct parser_spec *s;
 	struct parser_value *v;
 	char *sp = NULL;
+	size_t len;
 
 	assert(p);
 	assert(line);
 
-	parser_freeold(p);
-
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
+	p->nvals = 0;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -232,11 +277,16 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* Copy the line into the parser's buffer, which the values point into */
+	len = strlen(line) + 1;
+	if (len > p->line_max) {
+		p->line_max = MAX(len, 2 * p->line_max);
+		p->line = mem_realloc(p->line, p->line_max);
+	}
+	cline = memcpy(p->line, line, len);
 
 	tok = strtok(cline, ":");
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -245,7 +295,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -275,25 +324,24 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Take the next value slot. */
+		if (p->nvals == p->vals_max) {
+			p->vals_max = p->vals_max ? p->vals_max * 2 : 8;
+			p->vals = mem_realloc(p->vals, p->vals_max * sizeof(*v));
+		}
+		v = &p->vals[p->nvals];
+		v->spec = s;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -302,8 +350,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -311,27 +357,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->nvals++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -389,7 +426,9 @@ static void clean_specs(struct parser_hook *h) {
  */
 void parser_destroy(struct parser *p) {
 	struct parser_hook *h;
-	parser_freeold(p);
+	mem_free(p->vals);
+	mem_free(p->line);
+	mem_free(p->hook_table);
 	while (p->hooks) {
 		h = p->hooks->next;
 		clean_specs(p->hooks);
@@ -494,6 +533,7 @@ errr parser_reg(struct parser *p, const char *fmt,
 	}
 
 	p->hooks = h;
+	addhook(p, h);
 	mem_free(cfmt);
 	return 0;
 }
@@ -511,19 +551,19 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
+	size_t i;
+	for (i = 0; i < p->nvals; i++) {
+		if (!strcmp(p->vals[i].spec->name, name))
 			return TRUE;
 	}
 	return FALSE;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
-			return v;
+	size_t i;
+	for (i = 0; i < p->nvals; i++) {
+		if (!strcmp(p->vals[i].spec->name, name)) {
+			return &p->vals[i];
 		}
 	}
 	quit_fmt("parser_getval error: name is %s\n", name);
@@ -535,7 +575,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -544,7 +584,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -553,7 +593,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -562,7 +602,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -571,7 +611,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -580,7 +620,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->spec->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
@@ -620,21 +660,439 @@ static void print_error(struct file_parser *fp, struct parser *p) {
 	quit_fmt("Parse error in %s line %d column %d.", fp->name, s.line, s.col);
 }
 
+/**
+ * Per-file parse times, recorded by run_parser() while parse_timing is set
+ */
+bool parse_timing = FALSE;
+struct parse_time parse_times[PARSE_TIMES_MAX];
+int parse_times_count = 0;
+
+/**
+ * ------------------------------------------------------------------------
+ * Compiled data file cache
+ *
+ * A file parser with cache_save and cache_load hooks can have what it parsed
+ * written to <name>.cache in the user directory, and read back on later runs
+ * instead of parsing the text again; cache_save returns FALSE if what was
+ * parsed this time shouldn't be kept.  The cache starts with a header naming
+ * the game version and the hash and length of the text file it was made
+ * from, so any change to the text (or a user override of it) is noticed and
+ * the cache remade.  The text files are always the source of truth.
+ *
+ * What a file parses to can also depend on the files parsed before it; the
+ * artifacts name object kinds and activations, monsters name bases, kinds
+ * and artifacts, and so on.  So the header also holds a hash of every data
+ * file read since parse_cache_begin(), and a change to any earlier file
+ * remakes the cache too.  Links to records from other files are written as
+ * indices and turned back into pointers on load.
+ *
+ * The loaders fill structs field by field and read flag sets and arrays
+ * whole, so a cache written by a build with different structs or flag lists
+ * would load wrongly.  A parser's cache_layout hook fingerprints what its
+ * loader expects with cache_layout(), and the header holds that too.
+ * ------------------------------------------------------------------------ */
+
+bool parse_cache = FALSE;
+
+#define CACHE_MAGIC		"ANGCACHE"
+#define CACHE_FORMAT	4
+
+/* Hash of the data files read so far, and the last one parse_file() read */
+static u32b cache_deps;
+static char cache_last_path[1024];
+
+static byte *cache_buf;
+static size_t cache_len;
+static size_t cache_size;
+static size_t cache_pos;
+static bool cache_bad;
+
+static void cache_wr_bytes(const void *data, size_t n) {
+	if (cache_len + n > cache_size) {
+		cache_size = MAX(cache_len + n, cache_size ? 2 * cache_size : 4096);
+		cache_buf = mem_realloc(cache_buf, cache_size);
+	}
+	memcpy(cache_buf + cache_len, data, n);
+	cache_len += n;
+}
+
+void cache_wr_byte(byte v) {
+	cache_wr_bytes(&v, 1);
+}
+
+void cache_wr_u32b(u32b v) {
+	byte b[4];
+	b[0] = v & 0xFF;
+	b[1] = (v >> 8) & 0xFF;
+	b[2] = (v >> 16) & 0xFF;
+	b[3] = (v >> 24) & 0xFF;
+	cache_wr_bytes(b, 4);
+}
+
+/**
+ * Write a string, which may be NULL
+ */
+void cache_wr_string(const char *str) {
+	if (!str) {
+		cache_wr_u32b(0);
+		return;
+	}
+	cache_wr_u32b(strlen(str) + 1);
+	cache_wr_bytes(str, strlen(str));
+}
+
+static const byte *cache_rd_bytes(size_t n) {
+	const byte *data = cache_buf + cache_pos;
+	if (cache_bad || n > cache_len - cache_pos) {
+		cache_bad = TRUE;
+		return NULL;
+	}
+	cache_pos += n;
+	return data;
+}
+
+byte cache_rd_byte(void) {
+	const byte *b = cache_rd_bytes(1);
+	return b ? b[0] : 0;
+}
+
+u32b cache_rd_u32b(void) {
+	const byte *b = cache_rd_bytes(4);
+	if (!b)
+		return 0;
+	return b[0] | ((u32b)b[1] << 8) | ((u32b)b[2] << 16) | ((u32b)b[3] << 24);
+}
+
+/**
+ * Read a string written by cache_wr_string(), as a new string or NULL
+ */
+char *cache_rd_string(void) {
+	u32b len = cache_rd_u32b();
+	const byte *data;
+	char *str;
+
+	if (!len)
+		return NULL;
+	data = cache_rd_bytes(len - 1);
+	if (!data)
+		return NULL;
+
+	str = mem_alloc(len);
+	memcpy(str, data, len - 1);
+	str[len - 1] = '\0';
+	return str;
+}
+
+void cache_wr_random(random_value v) {
+	cache_wr_u32b(v.base);
+	cache_wr_u32b(v.dice);
+	cache_wr_u32b(v.sides);
+	cache_wr_u32b(v.m_bonus);
+}
+
+random_value cache_rd_random(void) {
+	random_value v;
+	v.base = (s32b)cache_rd_u32b();
+	v.dice = (s32b)cache_rd_u32b();
+	v.sides = (s32b)cache_rd_u32b();
+	v.m_bonus = (s32b)cache_rd_u32b();
+	return v;
+}
+
+void cache_wr_flags(const bitflag *flags, size_t size) {
+	cache_wr_bytes(flags, size);
+}
+
+void cache_rd_flags(bitflag *flags, size_t size) {
+	const byte *b = cache_rd_bytes(size);
+	if (b)
+		memcpy(flags, b, size);
+}
+
+/**
+ * Whether everything read so far was in the cache; loaders should check
+ * this before trusting what they read
+ */
+bool cache_rd_ok(void) {
+	return !cache_bad;
+}
+
+/**
+ * Mark the cache as bad, for a loader that finds something it can't use
+ */
+void cache_rd_fail(void) {
+	cache_bad = TRUE;
+}
+
+/**
+ * Whether the whole cache has been read, and was good; loaders that change
+ * data owned by other parsers should check this before doing so
+ */
+bool cache_rd_done(void) {
+	return !cache_bad && cache_pos == cache_len;
+}
+
+/**
+ * Find the text file parse_file() will read for `filename`
+ */
+static void parse_file_path(char *path, size_t len, const char *filename) {
+	/* The player can put a customised file in the user directory */
+	path_build(path, len, ANGBAND_DIR_USER, format("%s.txt", filename));
+	if (!file_exists(path))
+		path_build(path, len, ANGBAND_DIR_GAMEDATA,
+				   format("%s.txt", filename));
+}
+
+/**
+ * Hash the file at `path`, with its length, so a cache can be matched to it
+ */
+static bool cache_hash_file(const char *path, u32b *hash, u32b *len) {
+	char buf[4096];
+	ang_file *fh;
+	int n;
+
+	fh = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!fh)
+		return FALSE;
+
+	/* FNV-1a */
+	*hash = 2166136261UL;
+	*len = 0;
+	while ((n = file_read(fh, buf, sizeof(buf))) > 0) {
+		int i;
+		for (i = 0; i < n; i++) {
+			*hash ^= (byte)buf[i];
+			*hash *= 16777619UL;
+		}
+		*len += n;
+	}
+	file_close(fh);
+
+	return n == 0;
+}
+
+/**
+ * Hash the text file parse_file() will read for `filename`
+ */
+static bool cache_hash_text(const char *filename, u32b *hash, u32b *len) {
+	char path[1024];
+
+	parse_file_path(path, sizeof(path), filename);
+	return cache_hash_file(path, hash, len);
+}
+
+/**
+ * Add a data file to the hash of those read so far
+ */
+static void cache_deps_add(u32b hash, u32b len) {
+	cache_deps = (cache_deps ^ hash) * 16777619UL;
+	cache_deps = (cache_deps ^ len) * 16777619UL;
+}
+
+/**
+ * Start a new run of data files; caches made from here on depend on every
+ * file parsed after this
+ */
+void parse_cache_begin(void) {
+	cache_deps = 2166136261UL;
+}
+
+/**
+ * Fingerprint the sizes of the structs, flag sets and arrays a cache loader
+ * reads into
+ */
+u32b cache_layout(const size_t *sizes, size_t n) {
+	u32b layout = 2166136261UL;
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		layout = (layout ^ (u32b)sizes[i]) * 16777619UL;
+	return layout;
+}
+
+static u32b cache_layout_of(struct file_parser *fp) {
+	return fp->cache_layout ? fp->cache_layout() : 0;
+}
+
+static void cache_wr_header(struct file_parser *fp, u32b hash, u32b len) {
+	cache_wr_bytes(CACHE_MAGIC, strlen(CACHE_MAGIC));
+	cache_wr_u32b(CACHE_FORMAT);
+	cache_wr_u32b(cache_layout_of(fp));
+	cache_wr_string(VERSION_STRING);
+	cache_wr_u32b(hash);
+	cache_wr_u32b(len);
+	cache_wr_u32b(cache_deps);
+}
+
+static bool cache_rd_header(struct file_parser *fp, u32b hash, u32b len) {
+	const byte *magic = cache_rd_bytes(strlen(CACHE_MAGIC));
+	char *version;
+	bool ok;
+
+	if (!magic || memcmp(magic, CACHE_MAGIC, strlen(CACHE_MAGIC)))
+		return FALSE;
+	if (cache_rd_u32b() != CACHE_FORMAT)
+		return FALSE;
+	if (cache_rd_u32b() != cache_layout_of(fp))
+		return FALSE;
+
+	version = cache_rd_string();
+	ok = version && streq(version, VERSION_STRING);
+	mem_free(version);
+
+	return ok && cache_rd_u32b() == hash && cache_rd_u32b() == len &&
+		cache_rd_u32b() == cache_deps && cache_rd_ok();
+}
+
+static void cache_reset(void) {
+	mem_free(cache_buf);
+	cache_buf = NULL;
+	cache_len = cache_size = cache_pos = 0;
+	cache_bad = FALSE;
+}
+
+/**
+ * Fill the globals of `fp` from its cache, if there's one for this text
+ */
+static bool cache_load(struct file_parser *fp, u32b hash, u32b len) {
+	char path[1024];
+	ang_file *fh;
+	bool ok = FALSE;
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER,
+			   format("%s.cache", fp->name));
+	fh = file_open(path, MODE_READ, FTYPE_RAW);
+	if (!fh)
+		return FALSE;
+
+	/* Read the whole image, then check and unpack it */
+	cache_reset();
+	while (TRUE) {
+		int n;
+		if (cache_len == cache_size) {
+			cache_size = cache_size ? 2 * cache_size : 65536;
+			cache_buf = mem_realloc(cache_buf, cache_size);
+		}
+		n = file_read(fh, (char *)cache_buf + cache_len,
+					  cache_size - cache_len);
+		if (n <= 0) {
+			ok = (n == 0);
+			break;
+		}
+		cache_len += n;
+	}
+	file_close(fh);
+
+	/* cache_load() cleans up after itself if it fails; anything left over
+	 * means the cache wasn't what it seemed, so throw it all away */
+	ok = ok && cache_rd_header(fp, hash, len) && fp->cache_load();
+	if (ok && (!cache_rd_ok() || cache_pos != cache_len)) {
+		fp->cleanup();
+		ok = FALSE;
+	}
+	cache_reset();
+
+	return ok;
+}
+
+/**
+ * Write the cache for `fp`, through a temporary file so a reader never sees
+ * half of one.  The temporary name is picked as the savefile's is, so two
+ * games starting at once don't write into the same file.
+ */
+static void cache_save(struct file_parser *fp, u32b hash, u32b len) {
+	char path[1024], temp[1024];
+	ang_file *fh;
+	bool ok;
+	int count = 0;
+
+	cache_reset();
+	cache_wr_header(fp, hash, len);
+	if (!fp->cache_save()) {
+		cache_reset();
+		return;
+	}
+
+	path_build(path, sizeof(path), ANGBAND_DIR_USER,
+			   format("%s.cache", fp->name));
+	strnfmt(temp, sizeof(temp), "%s%u.new", path, Rand_simple(1000000));
+	while (file_exists(temp) && (count++ < 100))
+		strnfmt(temp, sizeof(temp), "%s%u%u.new", path, Rand_simple(1000000),
+				count);
+
+	fh = file_open(temp, MODE_WRITE, FTYPE_RAW);
+	if (fh) {
+		ok = file_write(fh, (const char *)cache_buf, cache_len);
+		ok = file_close(fh) && ok;
+		if (ok && !file_move(temp, path)) {
+			ok = FALSE;
+#ifdef WINDOWS
+			/* rename() won't replace an existing file here */
+			if (file_exists(path) && file_delete(path))
+				ok = file_move(temp, path);
+#endif /* WINDOWS */
+		}
+		if (!ok)
+			file_delete(temp);
+	}
+
+	cache_reset();
+}
+
 errr run_parser(struct file_parser *fp) {
-	struct parser *p = fp->init();
+	clock_t start = clock();
+	struct parser *p;
+	unsigned int lines = 0;
+	bool use_cache = FALSE, from_cache = FALSE;
+	u32b hash = 0, len = 0;
 	errr r;
-	if (!p) {
-		return PARSE_ERROR_GENERIC;
+
+	/* Use the compiled form if it's still good */
+	if (parse_cache && fp->cache_load && fp->cache_save)
+		use_cache = cache_hash_text(fp->name, &hash, &len);
+	if (use_cache)
+		from_cache = cache_load(fp, hash, len);
+
+	if (!from_cache) {
+		p = fp->init();
+		if (!p) {
+			return PARSE_ERROR_GENERIC;
+		}
+		cache_last_path[0] = '\0';
+		r = fp->run(p);
+		if (r) {
+			print_error(fp, p);
+			return r;
+		}
+
+		/* finish() usually destroys the parser */
+		lines = p->lineno;
+		r = fp->finish(p);
+		if (r) {
+			print_error(fp, p);
+			return r;
+		}
+
+		/* Keep the compiled form for next time */
+		if (use_cache)
+			cache_save(fp, hash, len);
 	}
-	r = fp->run(p);
-	if (r) {
-		print_error(fp, p);
-		return r;
+
+	/* Later caches depend on this file */
+	if (use_cache)
+		cache_deps_add(hash, len);
+	else if (parse_cache && cache_last_path[0] &&
+			 cache_hash_file(cache_last_path, &hash, &len))
+		cache_deps_add(hash, len);
+
+	if (parse_timing && parse_times_count < PARSE_TIMES_MAX) {
+		struct parse_time *t = &parse_times[parse_times_count++];
+		t->name = fp->name;
+		t->lines = lines;
+		t->cached = from_cache;
+		t->time = clock() - start;
 	}
-	r = fp->finish(p);
-	if (r)
-		print_error(fp, p);
-	return r;
+	return 0;
 }
 
 /**
@@ -665,6 +1123,7 @@ errr parse_file(struct parser *p, const char *filename) {
 		else
 			quit(format("Cannot open '%s.txt'", filename));
 	}
+	my_strcpy(cache_last_path, path, sizeof(cache_last_path));
 
 	/* Parse it */
 	while (file_getl(fh, buf, sizeof(buf))) {
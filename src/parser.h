@@ -53,10 +53,32 @@ struct file_parser {
 	errr (*run)(struct parser *p);
 	errr (*finish)(struct parser *p);
 	void (*cleanup)(void);
+
+	/* Optional; see "Compiled data file cache" in parser.c */
+	bool (*cache_save)(void);
+	bool (*cache_load)(void);
+	u32b (*cache_layout)(void);
 };
 
 extern const char *parser_error_str[PARSE_ERROR_MAX];
 
+/**
+ * Time taken by run_parser() to read one data file
+ */
+struct parse_time {
+	const char *name;
+	unsigned int lines;
+	bool cached;
+	clock_t time;
+};
+
+#define PARSE_TIMES_MAX	64
+
+extern bool parse_timing;
+extern struct parse_time parse_times[PARSE_TIMES_MAX];
+extern int parse_times_count;
+extern bool parse_cache;
+
 extern struct parser *parser_new(void);
 extern enum parser_error parser_parse(struct parser *p, const char *line);
 extern void parser_destroy(struct parser *p);
@@ -76,6 +98,21 @@ extern int parser_getstate(struct parser *p, struct parser_state *s);
 extern void parser_setstate(struct parser *p, unsigned int col, const char *msg);
 
 errr run_parser(struct file_parser *fp);
+void parse_cache_begin(void);
+void cache_wr_byte(byte v);
+void cache_wr_u32b(u32b v);
+void cache_wr_string(const char *str);
+byte cache_rd_byte(void);
+u32b cache_rd_u32b(void);
+char *cache_rd_string(void);
+void cache_wr_random(random_value v);
+random_value cache_rd_random(void);
+void cache_wr_flags(const bitflag *flags, size_t size);
+void cache_rd_flags(bitflag *flags, size_t size);
+bool cache_rd_ok(void);
+void cache_rd_fail(void);
+bool cache_rd_done(void);
+u32b cache_layout(const size_t *sizes, size_t n);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
 int lookup_flag(const char **flag_table, const char *flag_name);
@@ -582,19 +582,20 @@ static int spell_value_base_food_starve(void)
 	return PY_FOOD_STARVE;
 }
 
+static const struct value_base_s {
+	const char *name;
+	expression_base_value_f function;
+} value_bases[] = {
+	{ "MONSTER_LEVEL", spell_value_base_monster_level },
+	{ "PLAYER_LEVEL", spell_value_base_player_level },
+	{ "MAX_SIGHT", spell_value_base_max_sight },
+	{ "FOOD_FAINT", spell_value_base_food_faint },
+	{ "FOOD_STARVE", spell_value_base_food_starve },
+	{ NULL, NULL },
+};
+
 expression_base_value_f spell_value_base_by_name(const char *name)
 {
-	static const struct value_base_s {
-		const char *name;
-		expression_base_value_f function;
-	} value_bases[] = {
-		{ "MONSTER_LEVEL", spell_value_base_monster_level },
-		{ "PLAYER_LEVEL", spell_value_base_player_level },
-		{ "MAX_SIGHT", spell_value_base_max_sight },
-		{ "FOOD_FAINT", spell_value_base_food_faint },
-		{ "FOOD_STARVE", spell_value_base_food_starve },
-		{ NULL, NULL },
-	};
 	const struct value_base_s *current = value_bases;
 
 	while (current->name != NULL && current->function != NULL) {
@@ -606,3 +607,20 @@ expression_base_value_f spell_value_base_by_name(const char *name)
 
 	return NULL;
 }
+
+/**
+ * Return the name spell_value_base_by_name() knows `function` by, or NULL
+ */
+const char *spell_value_base_name(expression_base_value_f function)
+{
+	const struct value_base_s *current = value_bases;
+
+	while (current->name != NULL && current->function != NULL) {
+		if (current->function == function)
+			return current->name;
+
+		current++;
+	}
+
+	return NULL;
+}
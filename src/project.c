@@ -26,6 +26,7 @@
 #include "player-calcs.h"
 #include "player-timed.h"
 #include "project.h"
+#include "test-hooks.h"
 
 /*
  * Specify attr/char pairs for visual special effects for project()
@@ -74,7 +75,8 @@ wchar_t gf_to_char[GF_MAX][BOLT_MAX];
  * This algorithm is similar to, but slightly different from, the one used
  * by "update_view_los()", and very different from the one used by "los()".
  */
-int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int flg)
+static int calc_path(struct loc *gp, int range, int y1, int x1, int y2, int x2,
+					 int flg)
 {
 	int y, x;
 
@@ -271,6 +273,178 @@ int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int
 }
 
 
+/**
+ * ------------------------------------------------------------------------
+ * Projection paths and scratch space
+ *
+ * The same paths are worked out over and over - for every monster deciding
+ * whether it can cast at the player, for every grid the targeting code looks
+ * at - and they only change when the terrain does.  Each chunk keeps its most
+ * recent paths in a small direct-mapped cache, keyed on the two ends of the
+ * path, its range, whether it goes through its destination, and the chunk's
+ * terrain generation, which square_set_feat() bumps whenever a grid changes.
+ *
+ * Paths are cached as if no monster stopped them; a path with PROJECT_STOP
+ * is exactly the same path cut short at the first grid with a monster in it,
+ * so monsters moving about never make a cached path wrong.
+ *
+ * The chunk also holds the working space project() needs, so that a
+ * projection doesn't have to allocate anything.
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Number of paths cached, as a power of two
+ */
+#define PATH_CACHE_SHIFT	10
+#define PATH_CACHE_SLOTS	(1 << PATH_CACHE_SHIFT)
+
+/**
+ * Longest path that is cached; longer ranges are always worked out afresh
+ */
+#define PATH_CACHE_GRIDS	32
+
+/**
+ * Grids are kept as offsets from the start of the path, plus PATH_CACHE_GRIDS
+ * so that they fit in a byte
+ */
+struct path_cache_entry {
+	u32b feat_gen;
+	s16b y1, x1;
+	s16b y2, x2;
+	byte range;
+	bool thru;
+	bool valid;
+	byte n;
+	byte dy[PATH_CACHE_GRIDS];
+	byte dx[PATH_CACHE_GRIDS];
+};
+
+struct projection_cache {
+	struct path_cache_entry paths[PATH_CACHE_SLOTS];
+
+	/* Damage at each distance from the centre of a project() */
+	int *dam_at_dist;
+};
+
+/**
+ * Work out every path afresh, for checking the cache against (see
+ * test-hooks.h)
+ */
+bool project_path_uncached = FALSE;
+
+static struct projection_cache *projection_cache_get(struct chunk *c)
+{
+	if (!c->proj_cache) {
+		c->proj_cache = mem_zalloc(sizeof(*c->proj_cache));
+		c->proj_cache->dam_at_dist = mem_zalloc((z_info->max_range + 1) *
+									sizeof(*c->proj_cache->dam_at_dist));
+	}
+	return c->proj_cache;
+}
+
+/**
+ * Free a chunk's cached paths and scratch space
+ */
+void projection_cache_free(struct chunk *c)
+{
+	if (!c->proj_cache) return;
+	mem_free(c->proj_cache->dam_at_dist);
+	mem_free(c->proj_cache);
+	c->proj_cache = NULL;
+}
+
+static int path_cache_slot(int y1, int x1, int y2, int x2)
+{
+	u32b h = ((u32b)y1 << 24) ^ ((u32b)x1 << 16) ^ ((u32b)y2 << 8) ^ x2;
+
+	h *= 0x9E3779B1;
+	return h >> (32 - PATH_CACHE_SHIFT);
+}
+
+/**
+ * Find a path in the current level's cache, working it out and keeping it if
+ * it isn't there; returns NULL for paths which aren't cached at all
+ */
+static const struct path_cache_entry *path_cache_find(int range, int y1,
+													  int x1, int y2, int x2,
+													  int flg)
+{
+	struct path_cache_entry *entry;
+	bool thru = (flg & (PROJECT_THRU)) ? TRUE : FALSE;
+
+	/* Paths too long to keep, or with nowhere to keep them */
+	if (project_path_uncached || !cave || (range < 1) ||
+		(range > PATH_CACHE_GRIDS))
+		return NULL;
+
+	entry = &projection_cache_get(cave)->paths[path_cache_slot(y1, x1, y2,
+															   x2)];
+	if (!entry->valid || (entry->feat_gen != cave->feat_gen) ||
+		(entry->y1 != y1) || (entry->x1 != x1) || (entry->y2 != y2) ||
+		(entry->x2 != x2) || (entry->range != range) || (entry->thru != thru)) {
+		struct loc grids[PATH_CACHE_GRIDS];
+		int i;
+
+		entry->n = calc_path(grids, range, y1, x1, y2, x2,
+							 flg & ~(PROJECT_STOP));
+		for (i = 0; i < entry->n; i++) {
+			entry->dy[i] = grids[i].y - y1 + PATH_CACHE_GRIDS;
+			entry->dx[i] = grids[i].x - x1 + PATH_CACHE_GRIDS;
+		}
+		entry->feat_gen = cave->feat_gen;
+		entry->y1 = y1;
+		entry->x1 = x1;
+		entry->y2 = y2;
+		entry->x2 = x2;
+		entry->range = range;
+		entry->thru = thru;
+		entry->valid = TRUE;
+	}
+
+	return entry;
+}
+
+/**
+ * Length of a cached path, stopping after the first monster if need be; the
+ * last grid ends the path anyway, and may be out of bounds
+ */
+static int path_cache_length(const struct path_cache_entry *entry, int flg)
+{
+	int i;
+
+	if (flg & (PROJECT_STOP))
+		for (i = 0; i + 1 < entry->n; i++) {
+			int y = entry->y1 + entry->dy[i] - PATH_CACHE_GRIDS;
+			int x = entry->x1 + entry->dx[i] - PATH_CACHE_GRIDS;
+
+			if (cave->squares[y][x].mon != 0)
+				return i + 1;
+		}
+
+	return entry->n;
+}
+
+/**
+ * Determine the path taken by a projection, as described above calc_path(),
+ * using the current level's cache of paths where possible.
+ */
+int project_path(struct loc *gp, int range, int y1, int x1, int y2, int x2, int flg)
+{
+	const struct path_cache_entry *entry = path_cache_find(range, y1, x1, y2,
+														   x2, flg);
+	int i, n;
+
+	if (!entry)
+		return calc_path(gp, range, y1, x1, y2, x2, flg);
+
+	n = path_cache_length(entry, flg);
+	for (i = 0; i < n; i++)
+		gp[i] = loc(x1 + entry->dx[i] - PATH_CACHE_GRIDS,
+					y1 + entry->dy[i] - PATH_CACHE_GRIDS);
+	return n;
+}
+
+
 /**
  * Determine if a bolt spell cast from (y1,x1) to (y2,x2) will arrive
  * at the final destination, assuming that no monster gets in the way,
@@ -287,16 +461,29 @@ bool projectable(struct chunk *c, int y1, int x1, int y2, int x2, int flg)
 
 	int grid_n = 0;
 	struct loc grid_g[512];
+	const struct path_cache_entry *entry;
+
+	/* No path gets further than one grid beyond its range */
+	if (distance(y1, x1, y2, x2) > z_info->max_range + 1) return (FALSE);
 
-	/* Check the projection path */
-	grid_n = project_path(grid_g, z_info->max_range, y1, x1, y2, x2, flg);
+	/* Check the projection path, from the cache if it's there */
+	entry = path_cache_find(z_info->max_range, y1, x1, y2, x2, flg);
+	if (entry)
+		grid_n = path_cache_length(entry, flg);
+	else
+		grid_n = calc_path(grid_g, z_info->max_range, y1, x1, y2, x2, flg);
 
 	/* No grid is ever projectable from itself */
 	if (!grid_n) return (FALSE);
 
 	/* Final grid */
-	y = grid_g[grid_n - 1].y;
-	x = grid_g[grid_n - 1].x;
+	if (entry) {
+		y = y1 + entry->dy[grid_n - 1] - PATH_CACHE_GRIDS;
+		x = x1 + entry->dx[grid_n - 1] - PATH_CACHE_GRIDS;
+	} else {
+		y = grid_g[grid_n - 1].y;
+		x = grid_g[grid_n - 1].x;
+	}
 
 	/* May not end in a wall grid */
 	if (!square_ispassable(c, y, x)) return (FALSE);
@@ -624,7 +811,7 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	bool player_sees_grid[256];
 
 	/* Precalculated damage values for each distance. */
-	int *dam_at_dist = malloc((z_info->max_range + 1) * sizeof(*dam_at_dist));
+	int *dam_at_dist = projection_cache_get(cave)->dam_at_dist;
 
 	/* Flush any pending output */
 	handle_stuff(player);
@@ -1071,8 +1258,6 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg,
 	if (player->upkeep->update)
 		update_stuff(player);
 
-	free(dam_at_dist);
-
 	/* Return "something was noticed" */
 	return (notice);
 }
@@ -19,9 +19,11 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-lore.h"
 #include "mon-make.h"
+#include "mon-move.h"
 #include "monster.h"
 #include "object.h"
 #include "obj-pile.h"
@@ -106,14 +108,9 @@ static void wr_item(const struct object *obj)
 	wr_u16b(obj->origin_xtra);
 	wr_byte(obj->ignore);
 
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(obj->flags[i]);
-
-	for (i = 0; i < OF_SIZE; i++)
-		wr_byte(obj->known_flags[i]);
-
-	for (i = 0; i < ID_SIZE; i++)
-		wr_byte(obj->id_flags[i]);
+	wr_bytes(obj->flags, OF_SIZE);
+	wr_bytes(obj->known_flags, OF_SIZE);
+	wr_bytes(obj->id_flags, ID_SIZE);
 
 	for (i = 0; i < OBJ_MOD_MAX; i++) {
 		wr_s16b(obj->modifiers[i]);
@@ -187,11 +184,8 @@ static void wr_monster(const struct monster *mon)
 	for (j = 0; j < MON_TMD_MAX; j++)
 		wr_s16b(mon->m_timed[j]);
 
-	for (j = 0; j < MFLAG_SIZE; j++)
-		wr_byte(mon->mflag[j]);
-
-	for (j = 0; j < OF_SIZE; j++)
-		wr_byte(mon->known_pstate.flags[j]);
+	wr_bytes(mon->mflag, MFLAG_SIZE);
+	wr_bytes(mon->known_pstate.flags, OF_SIZE);
 
 	for (j = 0; j < ELEM_MAX; j++)
 		wr_s16b(mon->known_pstate.el_info[j].res_level);
@@ -216,15 +210,12 @@ static void wr_monster(const struct monster *mon)
  */
 static void wr_trap(struct trap *trap)
 {
-    size_t i;
-
     wr_byte(trap->t_idx);
     wr_byte(trap->fy);
     wr_byte(trap->fx);
     wr_byte(trap->xtra);
 
-    for (i = 0; i < TRF_SIZE; i++)
-		wr_byte(trap->flags[i]);
+    wr_bytes(trap->flags, TRF_SIZE);
 }
 
 /**
@@ -245,9 +236,9 @@ void wr_randomizer(void)
 	wr_u32b(state_i);
 
 	/* RNG variables */
-	wr_u32b(z0);
-	wr_u32b(z1);
-	wr_u32b(z2);
+	wr_u32b(Rand_context->z0);
+	wr_u32b(Rand_context->z1);
+	wr_u32b(Rand_context->z2);
 
 	/* RNG state */
 	for (i = 0; i < RAND_DEG; i++)
@@ -621,80 +612,151 @@ void wr_stores(void)
 
 
 /**
- * Write the current dungeon terrain features and info flags
+ * ------------------------------------------------------------------------
+ * Grid planes
  *
- * Note that the cost and when fields of c->squares[y][x] are not saved
+ * Each info byte of the squares, and then the terrain, is written as one
+ * plane of height * width bytes.  A plane is a series of runs, each headed by
+ * a count stored 7 bits to the byte; the low two bits of the count give the
+ * kind of run:
+ * - PLANE_REPEAT: one byte, repeated count times
+ * - PLANE_LITERAL: count bytes, as they are
+ * - PLANE_SAME: count bytes copied from the same plane of a reference chunk,
+ *   which is how cave_k is stored against cave
+ * - PLANE_ABOVE: count bytes copied from the row above
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Write a run header
  */
-static void wr_dungeon_aux(struct chunk *c)
+static void wr_plane_run(u32b count, byte kind)
 {
-	int y, x;
-	size_t i;
+	u32b v = (count << 2) | kind;
 
-	byte tmp8u;
+	while (v >= 0x80) {
+		wr_byte((byte)(v & 0x7F) | 0x80);
+		v >>= 7;
+	}
+	wr_byte((byte)v);
+}
 
-	byte count;
-	byte prev_char;
+/**
+ * Count how many bytes of plane from i on match guess
+ */
+static u32b plane_match(const byte *plane, const byte *guess, u32b i, u32b len)
+{
+	u32b j;
 
-	/* Dungeon specific info follows */
-	wr_string(c->name ? c->name : "Blank");
-	wr_u16b(c->height);
-	wr_u16b(c->width);
+	for (j = i; j < len && plane[j] == guess[j]; j++) ;
+	return j - i;
+}
 
-	/* Run length encoding of c->squares[y][x].info */
-	for (i = 0; i < SQUARE_SIZE; i++) {
-		count = 0;
-		prev_char = 0;
-
-		/* Dump for each grid */
-		for (y = 0; y < c->height; y++) {
-			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = c->squares[y][x].info[i];
-
-				/* If the run is broken, or too full, flush it */
-				if ((tmp8u != prev_char) || (count == MAX_UCHAR)) {
-					wr_byte((byte)count);
-					wr_byte((byte)prev_char);
-					prev_char = tmp8u;
-					count = 1;
-				} else /* Continue the run */
-					count++;
-			}
+/**
+ * Write `len` bytes of plane, `width` to a row, using ref (if any) as a guess
+ * at each byte
+ */
+static void wr_plane(const byte *plane, const byte *ref, u32b len, u32b width)
+{
+	u32b i = 0, j;
+
+	while (i < len) {
+		u32b same = ref ? plane_match(plane, ref, i, len) : 0;
+		u32b above = (i >= width) ?
+			plane_match(plane, plane - width, i, len) : 0;
+		u32b repeat;
+
+		for (j = i + 1; j < len && plane[j] == plane[i]; j++) ;
+		repeat = j - i;
+
+		/* Matching the reference is free */
+		if (same && same >= above && same >= repeat) {
+			wr_plane_run(same, PLANE_SAME);
+			i += same;
+			continue;
+		}
+
+		/* Rooms and corridors tend to look like the row before */
+		if (above > 1 && above >= repeat) {
+			wr_plane_run(above, PLANE_ABOVE);
+			i += above;
+			continue;
+		}
+
+		/* Runs of a byte, as in most of the info planes */
+		if (repeat > 1) {
+			wr_plane_run(repeat, PLANE_REPEAT);
+			wr_byte(plane[i]);
+			i += repeat;
+			continue;
 		}
 
-		/* Flush the data (if any) */
-		if (count) {
-			wr_byte((byte)count);
-			wr_byte((byte)prev_char);
+		/* Otherwise take bytes as they come until a run starts */
+		for (j = i + 1; j < len; j++) {
+			if (j + 1 < len && plane[j] == plane[j + 1]) break;
+			if (ref && plane[j] == ref[j]) break;
+			if (j >= width && j + 1 < len && plane[j] == plane[j - width] &&
+				plane[j + 1] == plane[j + 1 - width]) break;
 		}
+		wr_plane_run(j - i, PLANE_LITERAL);
+		wr_bytes(plane + i, j - i);
+		i = j;
 	}
+}
 
-	/* Now the terrain */
-	count = 0;
-	prev_char = 0;
+/**
+ * Gather info byte n of every square of c, or the terrain if n is
+ * SQUARE_SIZE, into plane
+ */
+static void chunk_get_plane(const struct chunk *c, size_t n, byte *plane)
+{
+	int y, x;
 
-	/* Dump for each grid */
 	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			/* Extract a byte */
-			tmp8u = c->squares[y][x].feat;
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR)) {
-				wr_byte((byte)count);
-				wr_byte((byte)prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			} else /* Continue the run */
-				count++;
-		}
+		const struct square *sq = c->squares[y];
+
+		if (n < SQUARE_SIZE)
+			for (x = 0; x < c->width; x++)
+				*plane++ = sq[x].info[n];
+		else
+			for (x = 0; x < c->width; x++)
+				*plane++ = sq[x].feat;
 	}
+}
 
-	/* Flush the data (if any) */
-	if (count) {
-		wr_byte((byte)count);
-		wr_byte((byte)prev_char);
+/**
+ * Write the current dungeon terrain features and info flags, as differences
+ * from ref if it is given
+ *
+ * Note that the cost and when fields of c->squares[y][x] are not saved
+ */
+static void wr_dungeon_aux(struct chunk *c, struct chunk *ref)
+{
+	u32b len = c->height * c->width;
+	byte *plane, *ref_plane = NULL;
+	size_t n;
+
+	/* Dungeon specific info follows */
+	wr_string(c->name ? c->name : "Blank");
+	wr_u16b(c->height);
+	wr_u16b(c->width);
+
+	/* Only a chunk of the same shape can be used for reference */
+	if (ref && (ref->height != c->height || ref->width != c->width))
+		ref = NULL;
+	wr_byte(ref ? 1 : 0);
+
+	/* The info planes, then the terrain */
+	plane = mem_alloc(len);
+	if (ref)
+		ref_plane = mem_alloc(len);
+	for (n = 0; n <= SQUARE_SIZE; n++) {
+		chunk_get_plane(c, n, plane);
+		if (ref)
+			chunk_get_plane(ref, n, ref_plane);
+		wr_plane(plane, ref_plane, len, c->width);
 	}
+	mem_free(ref_plane);
+	mem_free(plane);
 
 	/* Write feeling */
 	wr_byte(c->feeling);
@@ -789,9 +851,9 @@ void wr_dungeon(void)
 	wr_u16b(player->px);
 	wr_byte(SQUARE_SIZE);
 
-	/* Write caves */
-	wr_dungeon_aux(cave);
-	wr_dungeon_aux(cave_k);
+	/* Write caves, with the known cave as a difference from the real one */
+	wr_dungeon_aux(cave, NULL);
+	wr_dungeon_aux(cave_k, cave);
 
 	/* Compact the monsters */
 	compact_monsters(0);
@@ -806,6 +868,8 @@ void wr_objects(void)
 
 void wr_monsters(void)
 {
+	/* Write the energy each monster would have had by now */
+	mon_sched_settle_all(cave);
 	wr_monsters_aux(cave);
 	wr_monsters_aux(cave_k);
 }
@@ -818,6 +882,10 @@ void wr_traps(void)
 
 /*
  * Write the chunk list
+ *
+ * Each chunk is headed by its name and size, so the loader can keep it
+ * aside without reading it.  Chunks that were kept aside and never wanted
+ * are written back as they came.
  */
 void wr_chunks(void)
 {
@@ -826,14 +894,18 @@ void wr_chunks(void)
 	if (player->is_dead)
 		return;
 
-	wr_u16b(chunk_list_max);
+	wr_u16b(chunk_list_max + chunk_stored_max);
 
 	/* Now write each chunk */
 	for (j = 0; j < chunk_list_max; j++) {
 		struct chunk *c = chunk_list[j];
+		u32b mark;
+
+		wr_string(c->name ? c->name : "Blank");
+		mark = wr_size_begin();
 
 		/* Write the terrain and info */
-		wr_dungeon_aux(c);
+		wr_dungeon_aux(c, NULL);
 
 		/* Write the objects */
 		wr_objects_aux(c);
@@ -843,6 +915,17 @@ void wr_chunks(void)
 
 		/* Write the traps */
 		wr_traps_aux(c);
+
+		wr_size_end(mark);
+	}
+
+	/* And the ones which haven't been read back */
+	for (j = 0; j < chunk_stored_max; j++) {
+		struct chunk_stored *stored = &chunk_stored_list[j];
+
+		wr_string(stored->name);
+		wr_u32b(stored->len);
+		wr_bytes(stored->data, stored->len);
 	}
 }
 
@@ -21,6 +21,10 @@
 #include "init.h"
 #include "savefile.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
+
 /**
  * The savefile code.
  *
@@ -49,8 +53,9 @@
  * lots of code with "if (version > 3)" and its like everywhere.
  *
  * Savefile loading and saving is done by keeping the current block in
- * memory, which is accessed using the wr_* and rd_* functions.  This is
- * then written out, whole, to disk, with the appropriate header.
+ * memory, which is accessed using the wr_* and rd_* functions.  When saving,
+ * every block goes into one image of the whole file, with the appropriate
+ * headers, which is then written out to disk in one go.
  *
  *
  * So, if you want to make a savefile compat-breaking change, then there are
@@ -113,11 +118,11 @@ static const struct {
 	{ "player spells", wr_player_spells, 1 },
 	{ "gear", wr_gear, 1 },
 	{ "stores", wr_stores, 1 },
-	{ "dungeon", wr_dungeon, 1 },
+	{ "dungeon", wr_dungeon, 2 },
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
 	{ "traps", wr_traps, 1 },
-	{ "chunks", wr_chunks, 1 },
+	{ "chunks", wr_chunks, 3 },
 	{ "history", wr_history, 1 },
 };
 
@@ -140,11 +145,14 @@ static const struct blockinfo loaders[] = {
 	{ "player spells", rd_player_spells, 1 },
 	{ "gear", rd_gear, 1 },	
 	{ "stores", rd_stores, 1 },	
-	{ "dungeon", rd_dungeon, 1 },
+	{ "dungeon", rd_dungeon_1, 1 },
+	{ "dungeon", rd_dungeon, 2 },
 	{ "objects", rd_objects, 1 },	
 	{ "monsters", rd_monsters, 1 },
 	{ "traps", rd_traps, 1 },
-	{ "chunks", rd_chunks, 1 },
+	{ "chunks", rd_chunks_1, 1 },
+	{ "chunks", rd_chunks_2, 2 },
+	{ "chunks", rd_chunks, 3 },
 	{ "history", rd_history, 1 },
 };
 
@@ -153,10 +161,8 @@ static const struct blockinfo loaders[] = {
 static byte *buffer;
 static u32b buffer_size;
 static u32b buffer_pos;
-static u32b buffer_check;
 
 #define BUFFER_INITIAL_SIZE		1024
-#define BUFFER_BLOCK_INCREMENT	1024
 
 #define SAVEFILE_HEAD_SIZE		28
 
@@ -179,33 +185,60 @@ void note(const char *message)
 /**
  * ------------------------------------------------------------------------
  * Base put/get
+ *
+ * Values go in and out of the buffer in spans rather than byte by byte, so
+ * a wr_u32b() is one bounds check and four stores.  The block checksum is
+ * summed once over each finished block in try_save().
  * ------------------------------------------------------------------------ */
 
-static void sf_put(byte v)
+/**
+ * Make room for `len` more bytes, doubling the buffer as often as needed
+ */
+static byte *sf_put_span(u32b len)
 {
+	byte *span;
+
 	assert(buffer != NULL);
 	assert(buffer_size > 0);
 
-	if (buffer_size == buffer_pos)
-	{
-		buffer_size += BUFFER_BLOCK_INCREMENT;
+	if (buffer_size - buffer_pos < len) {
+		while (buffer_size - buffer_pos < len)
+			buffer_size *= 2;
 		buffer = mem_realloc(buffer, buffer_size);
 	}
 
-	assert(buffer_pos < buffer_size);
-
-	buffer[buffer_pos++] = v;
-	buffer_check += v;
+	span = buffer + buffer_pos;
+	buffer_pos += len;
+	return span;
 }
 
-static byte sf_get(void)
+/**
+ * Take the next `len` bytes of the buffer
+ */
+static const byte *sf_get_span(u32b len)
 {
-	if ((buffer == NULL) || (buffer_size <= 0) || (buffer_pos >= buffer_size))
+	const byte *span;
+
+	if ((buffer == NULL) || (buffer_pos > buffer_size) ||
+			(buffer_size - buffer_pos < len))
 		quit("Broken savefile - probably from a development version");
 
-	buffer_check += buffer[buffer_pos];
+	span = buffer + buffer_pos;
+	buffer_pos += len;
+	return span;
+}
+
+/**
+ * Sum the bytes of the block that starts at `from`
+ */
+static u32b sf_checksum(u32b from)
+{
+	u32b i, check = 0;
+
+	for (i = from; i < buffer_pos; i++)
+		check += buffer[i];
 
-	return buffer[buffer_pos++];
+	return check;
 }
 
 
@@ -214,15 +247,22 @@ static byte sf_get(void)
  * Accessor functions
  * ------------------------------------------------------------------------ */
 
+void wr_bytes(const void *data, size_t len)
+{
+	if (len) memcpy(sf_put_span(len), data, len);
+}
+
 void wr_byte(byte v)
 {
-	sf_put(v);
+	*sf_put_span(1) = v;
 }
 
 void wr_u16b(u16b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
+	byte *span = sf_put_span(2);
+
+	span[0] = (byte)(v & 0xFF);
+	span[1] = (byte)((v >> 8) & 0xFF);
 }
 
 void wr_s16b(s16b v)
@@ -232,10 +272,12 @@ void wr_s16b(s16b v)
 
 void wr_u32b(u32b v)
 {
-	sf_put((byte)(v & 0xFF));
-	sf_put((byte)((v >> 8) & 0xFF));
-	sf_put((byte)((v >> 16) & 0xFF));
-	sf_put((byte)((v >> 24) & 0xFF));
+	byte *span = sf_put_span(4);
+
+	span[0] = (byte)(v & 0xFF);
+	span[1] = (byte)((v >> 8) & 0xFF);
+	span[2] = (byte)((v >> 16) & 0xFF);
+	span[3] = (byte)((v >> 24) & 0xFF);
 }
 
 void wr_s32b(s32b v)
@@ -245,24 +287,26 @@ void wr_s32b(s32b v)
 
 void wr_string(const char *str)
 {
-	while (*str)
-	{
-		wr_byte(*str);
-		str++;
-	}
-	wr_byte(*str);
+	wr_bytes(str, strlen(str) + 1);
 }
 
 
+void rd_bytes(void *data, size_t len)
+{
+	if (len) memcpy(data, sf_get_span(len), len);
+}
+
 void rd_byte(byte *ip)
 {
-	*ip = sf_get();
+	*ip = *sf_get_span(1);
 }
 
 void rd_u16b(u16b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u16b)(sf_get()) << 8);
+	const byte *span = sf_get_span(2);
+
+	(*ip) = span[0];
+	(*ip) |= ((u16b)(span[1]) << 8);
 }
 
 void rd_s16b(s16b *ip)
@@ -272,10 +316,12 @@ void rd_s16b(s16b *ip)
 
 void rd_u32b(u32b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u32b)(sf_get()) << 8);
-	(*ip) |= ((u32b)(sf_get()) << 16);
-	(*ip) |= ((u32b)(sf_get()) << 24);
+	const byte *span = sf_get_span(4);
+
+	(*ip) = span[0];
+	(*ip) |= ((u32b)(span[1]) << 8);
+	(*ip) |= ((u32b)(span[2]) << 16);
+	(*ip) |= ((u32b)(span[3]) << 24);
 }
 
 void rd_s32b(s32b *ip)
@@ -285,28 +331,73 @@ void rd_s32b(s32b *ip)
 
 void rd_string(char *str, int max)
 {
-	byte tmp8u;
-	int i = 0;
-
-	do {
-		rd_byte(&tmp8u);
+	const byte *end = NULL;
+	u32b len;
 
-		if (i < max) str[i] = tmp8u;
-		if (!tmp8u) break;
-	} while (++i);
+	/* Find the terminator; a string running off the block is broken */
+	if (buffer && buffer_pos < buffer_size)
+		end = memchr(buffer + buffer_pos, 0, buffer_size - buffer_pos);
+	len = end ? (u32b)(end - (buffer + buffer_pos)) + 1 : buffer_size + 1;
 
+	memcpy(str, sf_get_span(len), MIN(len, (u32b)max));
 	str[max - 1] = '\0';
 }
 
 void strip_bytes(int n)
 {
-	byte tmp8u;
-	while (n--) rd_byte(&tmp8u);
+	sf_get_span(n);
 }
 
 void pad_bytes(int n)
 {
-	while (n--) wr_byte(0);
+	if (n > 0) memset(sf_put_span(n), 0, n);
+}
+
+/**
+ * Leave a u32b to be filled in by wr_size_end() with the number of bytes
+ * written in between, so a reader can skip or keep them whole
+ */
+u32b wr_size_begin(void)
+{
+	pad_bytes(4);
+	return buffer_pos;
+}
+
+void wr_size_end(u32b mark)
+{
+	u32b v = buffer_pos - mark;
+	byte *span = buffer + mark - 4;
+
+	span[0] = (byte)(v & 0xFF);
+	span[1] = (byte)((v >> 8) & 0xFF);
+	span[2] = (byte)((v >> 16) & 0xFF);
+	span[3] = (byte)((v >> 24) & 0xFF);
+}
+
+/**
+ * Run reader over data kept back from a savefile, such as a stored chunk, so
+ * it can use the rd_* functions; all of data must be used
+ */
+int rd_kept(const byte *data, u32b len, int (*reader)(void *), void *user)
+{
+	byte *old_buffer = buffer;
+	u32b old_size = buffer_size;
+	u32b old_pos = buffer_pos;
+	int ret;
+
+	buffer = (byte *)data;
+	buffer_size = len;
+	buffer_pos = 0;
+
+	ret = reader(user);
+	if (!ret && buffer_pos != len)
+		ret = -1;
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+
+	return ret;
 }
 
 
@@ -316,25 +407,43 @@ void pad_bytes(int n)
  * ------------------------------------------------------------------------ */
 
 
-static bool try_save(ang_file *file)
+/**
+ * Serialise the whole savefile, header and all blocks, into `buffer`
+ *
+ * This touches nothing but memory, so it is quick, and once it returns the
+ * image no longer depends on the game state and can be written at leisure.
+ */
+static void try_save(void)
 {
-	byte savefile_head[SAVEFILE_HEAD_SIZE];
-	size_t i, pos;
+	size_t i;
 
 	/* Start off the buffer */
 	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
 	buffer_size = BUFFER_INITIAL_SIZE;
+	buffer_pos = 0;
+
+	wr_bytes(savefile_magic, 4);
+	wr_bytes(savefile_name, 4);
 
 	for (i = 0; i < N_ELEMENTS(savers); i++) {
-		buffer_pos = 0;
-		buffer_check = 0;
+		u32b head_pos, block_pos, block_size, check;
+		byte *savefile_head;
+		size_t pos;
+
+		/* Leave room for the header, which needs the finished block */
+		head_pos = buffer_pos;
+		pad_bytes(SAVEFILE_HEAD_SIZE);
+		block_pos = buffer_pos;
 
 		savers[i].save();
+		block_size = buffer_pos - block_pos;
+		check = sf_checksum(block_pos);
 
 		/* 16-byte block name */
+		savefile_head = buffer + head_pos;
 		pos = my_strcpy((char *)savefile_head,
 				savers[i].name,
-				sizeof savefile_head);
+				16);
 		while (pos < 16)
 			savefile_head[pos++] = 0;
 
@@ -345,94 +454,274 @@ static bool try_save(ang_file *file)
 		savefile_head[pos++] = ((v >> 24) & 0xFF);
 
 		SAVE_U32B(savers[i].version);
-		SAVE_U32B(buffer_pos);
-		SAVE_U32B(buffer_check);
+		SAVE_U32B(block_size);
+		SAVE_U32B(check);
 
 		assert(pos == SAVEFILE_HEAD_SIZE);
 
-		file_write(file, (char *)savefile_head, SAVEFILE_HEAD_SIZE);
-		file_write(file, (char *)buffer, buffer_pos);
-
 		/* pad to 4 byte multiples */
-		if (buffer_pos % 4)
-			file_write(file, "xxx", 4 - (buffer_pos % 4));
+		if (block_size % 4)
+			wr_bytes("xxx", 4 - (block_size % 4));
 	}
+}
 
-	mem_free(buffer);
 
-	return TRUE;
-}
+/**
+ * ------------------------------------------------------------------------
+ * Writing savefile images
+ *
+ * A save is split in two: try_save() snapshots the game into a save_job on
+ * the game thread, then savefile_write() puts it on disk.  Autosaves do the
+ * second half on a background thread, where there is one.
+ * ------------------------------------------------------------------------ */
+
 
 /**
- * Attempt to save the player in a savefile
+ * A savefile image waiting to be written out.  Opening the temporary file and
+ * moving it into place both need the game's privileges, so they happen on the
+ * game thread; the background thread only writes and syncs the file.
  */
-bool savefile_save(const char *path)
-{
+struct save_job {
+	char path[1024];
+	char new_savefile[1024];
+
 	ang_file *file;
+	byte *image;
+	u32b image_len;
+
+	bool success;
+};
+
+/**
+ * The save being written in the background, if any
+ */
+static struct save_job *pending_save;
+
+#ifdef HAVE_PTHREAD_H
+static pthread_t save_thread;
+static pthread_mutex_t save_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool save_finished;
+#endif /* HAVE_PTHREAD_H */
+
+
+/**
+ * Snapshot the game, pick the temporary filename and open it, all on the game
+ * thread since Rand_simple() is not safe to share
+ */
+static struct save_job *save_job_new(const char *path)
+{
+	struct save_job *job = mem_zalloc(sizeof(*job));
 	int count = 0;
-	char new_savefile[1024];
-	char old_savefile[1024];
+
+	my_strcpy(job->path, path, sizeof(job->path));
 
 	/* New savefile */
-	strnfmt(old_savefile, sizeof(old_savefile), "%s%u.old", path,
+	strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u.new", path,
 			Rand_simple(1000000));
-	while (file_exists(old_savefile) && (count++ < 100))
-		strnfmt(old_savefile, sizeof(old_savefile), "%s%u%u.old", path,
-				Rand_simple(1000000),count);
+	while (file_exists(job->new_savefile) && (count++ < 100))
+		strnfmt(job->new_savefile, sizeof(job->new_savefile), "%s%u%u.new",
+				path, Rand_simple(1000000),count);
 
-	count = 0;
+	/* Take the image out of the buffer */
+	try_save();
+	job->image = buffer;
+	job->image_len = buffer_pos;
+	buffer = NULL;
+	buffer_size = buffer_pos = 0;
 
 	/* Open the savefile */
 	safe_setuid_grab();
-	strnfmt(new_savefile, sizeof(new_savefile), "%s%u.new", path,
-			Rand_simple(1000000));
-	while (file_exists(new_savefile) && (count++ < 100))
-		strnfmt(new_savefile, sizeof(new_savefile), "%s%u%u.new", path,
-				Rand_simple(1000000),count);
-
-	file = file_open(new_savefile, MODE_WRITE, FTYPE_SAVE);
+	job->file = file_open(job->new_savefile, MODE_WRITE, FTYPE_SAVE);
 	safe_setuid_drop();
 
-	if (file) {
-		file_write(file, (char *) &savefile_magic, 4);
-		file_write(file, (char *) &savefile_name, 4);
+	return job;
+}
 
-		character_saved = try_save(file);
-		file_close(file);
-	}
+static void save_job_free(struct save_job *job)
+{
+	mem_free(job->image);
+	mem_free(job);
+}
 
-	if (character_saved) {
-		bool err = FALSE;
+/**
+ * Write a savefile image to its temporary file and make sure it is on the
+ * disk.  Touches no game state, and needs no privileges.
+ */
+static bool savefile_write(struct save_job *job)
+{
+	bool err = FALSE;
 
-		safe_setuid_grab();
+	if (!job->file)
+		return FALSE;
 
-		if (file_exists(path) && !file_move(path, old_savefile))
-			err = TRUE;
+	if (!file_write(job->file, (char *)job->image, job->image_len))
+		err = TRUE;
+	if (!file_sync(job->file))
+		err = TRUE;
+	if (!file_close(job->file))
+		err = TRUE;
+	job->file = NULL;
 
-		if (!err) {
-			if (!file_move(new_savefile, path))
-				err = TRUE;
+	return err ? FALSE : TRUE;
+}
 
-			if (err)
-				file_move(old_savefile, path);
-			else
-				file_delete(old_savefile);
-		} 
+/**
+ * Move a written savefile over the old one in a single rename, so that there
+ * is always a whole savefile at the path, or throw it away if writing failed
+ */
+static bool savefile_commit(struct save_job *job, bool written)
+{
+	bool success = FALSE;
 
-		safe_setuid_drop();
+	safe_setuid_grab();
 
-		return err ? FALSE : TRUE;
+	if (written) {
+		success = file_move(job->new_savefile, job->path);
+
+#ifdef WINDOWS
+		/* rename() won't replace an existing file here, so move the old
+		 * savefile aside, and put it back if the new one still won't go */
+		if (!success && file_exists(job->path)) {
+			char old_savefile[1024];
+			int count = 0;
+
+			strnfmt(old_savefile, sizeof(old_savefile), "%s%u.old", job->path,
+					Rand_simple(1000000));
+			while (file_exists(old_savefile) && (count++ < 100))
+				strnfmt(old_savefile, sizeof(old_savefile), "%s%u%u.old",
+						job->path, Rand_simple(1000000), count);
+
+			if (file_move(job->path, old_savefile)) {
+				success = file_move(job->new_savefile, job->path);
+				if (success)
+					file_delete(old_savefile);
+				else
+					file_move(old_savefile, job->path);
+			}
+		}
+#endif /* WINDOWS */
 	}
 
-	/* Delete temp file if the save failed */
-	if (file) {
-		/* File is no longer valid, but it still points to a non zero
-		 * value if the file was created above */
-		safe_setuid_grab();
-		file_delete(new_savefile);
-		safe_setuid_drop();
-	}
-	return FALSE;
+	/* Delete temp file if the save failed, unless it is all that's left */
+	if (!success && (!written || file_exists(job->path)))
+		file_delete(job->new_savefile);
+
+	safe_setuid_drop();
+
+	return success;
+}
+
+/**
+ * Hand back a finished background save and tell the game how it went
+ */
+static void savefile_finish(void)
+{
+	struct save_job *job = pending_save;
+
+	pending_save = NULL;
+	job->success = savefile_commit(job, job->success);
+
+	/* The character is only safe if the image made it to the disk */
+	if (!job->success)
+		character_saved = FALSE;
+
+	event_signal_flag(EVENT_SAVE_DONE, job->success);
+	save_job_free(job);
+}
+
+#ifdef HAVE_PTHREAD_H
+static void *savefile_write_thread(void *data)
+{
+	struct save_job *job = data;
+	bool success = savefile_write(job);
+
+	pthread_mutex_lock(&save_lock);
+	job->success = success;
+	save_finished = TRUE;
+	pthread_mutex_unlock(&save_lock);
+
+	return NULL;
+}
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * Check on the background save, reporting it if it has finished
+ */
+void savefile_poll(void)
+{
+#ifdef HAVE_PTHREAD_H
+	bool finished;
+
+	if (!pending_save) return;
+
+	pthread_mutex_lock(&save_lock);
+	finished = save_finished;
+	pthread_mutex_unlock(&save_lock);
+
+	if (!finished) return;
+
+	pthread_join(save_thread, NULL);
+	savefile_finish();
+#endif /* HAVE_PTHREAD_H */
+}
+
+/**
+ * Wait for the background save, if any, to reach the disk
+ */
+void savefile_wait(void)
+{
+#ifdef HAVE_PTHREAD_H
+	if (!pending_save) return;
+
+	pthread_join(save_thread, NULL);
+	savefile_finish();
+#endif /* HAVE_PTHREAD_H */
+}
+
+/**
+ * Attempt to save the player in a savefile
+ */
+bool savefile_save(const char *path)
+{
+	struct save_job *job;
+	bool success;
+
+	/* Don't let an older save land on top of this one */
+	savefile_wait();
+
+	job = save_job_new(path);
+	success = savefile_commit(job, savefile_write(job));
+	save_job_free(job);
+
+	character_saved = success;
+	return success;
+}
+
+/**
+ * Snapshot the player now and write the savefile in the background
+ */
+void savefile_save_async(const char *path)
+{
+	struct save_job *job;
+
+	savefile_wait();
+
+	job = save_job_new(path);
+	character_saved = TRUE;
+
+#ifdef HAVE_PTHREAD_H
+	save_finished = FALSE;
+	pending_save = job;
+	if (pthread_create(&save_thread, NULL, savefile_write_thread, job) == 0)
+		return;
+
+	/* No thread to be had, so just write it here */
+	pending_save = NULL;
+#endif /* HAVE_PTHREAD_H */
+
+	job->success = savefile_write(job);
+	pending_save = job;
+	savefile_finish();
 }
 
 
@@ -515,7 +804,6 @@ static bool load_block(ang_file *f, struct blockheader *b, loader_t loader)
 	/* Allocate space for the buffer */
 	buffer = mem_alloc(b->size);
 	buffer_pos = 0;
-	buffer_check = 0;
 
 	buffer_size = file_read(f, (char *) buffer, b->size);
 	if (buffer_size != b->size ||
@@ -616,7 +904,12 @@ const char *savefile_get_description(const char *path) {
 bool savefile_load(const char *path, bool cheat_death)
 {
 	bool ok;
-	ang_file *f = file_open(path, MODE_READ, FTYPE_TEXT);
+	ang_file *f;
+
+	/* Make sure any save in progress has reached the disk */
+	savefile_wait();
+
+	f = file_open(path, MODE_READ, FTYPE_TEXT);
 	if (!f) {
 		note("Couldn't open savefile.");
 		return FALSE;
@@ -21,6 +21,16 @@
 #define FINISHED_CODE 255
 #define ITEM_VERSION	5
 
+/**
+ * Kinds of run in a grid plane of the dungeon; see wr_plane()
+ */
+enum {
+	PLANE_REPEAT = 0,
+	PLANE_LITERAL,
+	PLANE_SAME,
+	PLANE_ABOVE
+};
+
 /**
  * ------------------------------------------------------------------------
  * Savefile API
@@ -32,6 +42,20 @@
  */
 bool savefile_save(const char *path);
 
+/**
+ * Snapshot the game and write it to the given location in the background.
+ * EVENT_SAVE_DONE is signalled, from savefile_poll() or savefile_wait(), with
+ * the outcome.
+ */
+void savefile_save_async(const char *path);
+
+/**
+ * Report on the background save if it has finished; savefile_wait() blocks
+ * until it has.
+ */
+void savefile_poll(void);
+void savefile_wait(void);
+
 /**
  * Load the savefile given.  Returns TRUE on succcess, FALSE otherwise.
  */
@@ -60,6 +84,9 @@ void wr_u32b(u32b v);
 void wr_s32b(s32b v);
 void wr_string(const char *str);
 void pad_bytes(int n);
+void wr_bytes(const void *data, size_t len);
+u32b wr_size_begin(void);
+void wr_size_end(u32b mark);
 
 /* Reading bits */
 void rd_byte(byte *ip);
@@ -69,6 +96,8 @@ void rd_u32b(u32b *ip);
 void rd_s32b(s32b *ip);
 void rd_string(char *str, int max);
 void strip_bytes(int n);
+void rd_bytes(void *data, size_t len);
+int rd_kept(const byte *data, u32b len, int (*reader)(void *), void *user);
 
 
 
@@ -87,8 +116,12 @@ int rd_player_hp(void);
 int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
+int rd_dungeon_1(void);
 int rd_dungeon(void);
+int rd_chunks_1(void);
+int rd_chunks_2(void);
 int rd_chunks(void);
+struct chunk *chunk_read_stored(const byte *data, u32b len);
 int rd_objects(void);
 int rd_monsters(void);
 int rd_history(void);
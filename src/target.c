@@ -414,6 +414,19 @@ bool target_sighted(void)
 
 #define TS_INITIAL_SIZE	20
 
+/**
+ * Sort comparator putting grids in the order they are met row by row
+ */
+static int cmp_grid_order(const void *a, const void *b)
+{
+	const struct loc *pa = a;
+	const struct loc *pb = b;
+
+	if (pa->y != pb->y)
+		return pa->y - pb->y;
+	return pa->x - pb->x;
+}
+
 /**
  * Return a target set of target_able monsters.
  */
@@ -426,6 +439,41 @@ struct point_set *target_get_monsters(int mode)
 	/* Get the current panel */
 	get_panel(&min_y, &min_x, &max_y, &max_x);
 
+	/* Only monsters will do, so only look where there are monsters */
+	if (mode & (TARGET_KILL)) {
+		s16b *found;
+		int i, n = mon_buckets_rect(cave, min_y, min_x, max_y - 1, max_x - 1,
+									&found);
+
+		for (i = 0; i < n; i++) {
+			struct monster *mon = cave_monster(cave, found[i]);
+
+			y = mon->fy;
+			x = mon->fx;
+
+			/* Check bounds */
+			if (!square_in_bounds_fully(cave, y, x)) continue;
+
+			/* Require "interesting" contents */
+			if (!target_accept(y, x)) continue;
+
+			/* Must be a targettable monster */
+			if (!target_able(mon)) continue;
+
+			/* Save the location */
+			add_to_point_set(targets, y, x);
+		}
+		mem_free(found);
+
+		/* Put them in the order a scan of the panel would have, so that
+		 * monsters at the same distance come out in the same order */
+		sort(targets->pts, point_set_size(targets), sizeof(*(targets->pts)),
+			 cmp_grid_order);
+		sort(targets->pts, point_set_size(targets), sizeof(*(targets->pts)),
+			 cmp_distance);
+		return targets;
+	}
+
 	/* Scan for targets */
 	for (y = min_y; y < max_y; y++) {
 		for (x = min_x; x < max_x; x++) {
@@ -435,15 +483,6 @@ struct point_set *target_get_monsters(int mode)
 			/* Require "interesting" contents */
 			if (!target_accept(y, x)) continue;
 
-			/* Special mode */
-			if (mode & (TARGET_KILL)) {
-				/* Must contain a monster */
-				if (!(cave->squares[y][x].mon > 0)) continue;
-
-				/* Must be a targettable monster */
-			 	if (!target_able(square_monster(cave, y, x))) continue;
-			}
-
 			/* Save the location */
 			add_to_point_set(targets, y, x);
 		}
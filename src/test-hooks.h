@@ -0,0 +1,47 @@
+/**
+ * \file test-hooks.h
+ * \brief Switches and entry points which exist only for the unit tests
+ *
+ * Copyright (c) 2016 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+#ifndef TEST_HOOKS_H
+#define TEST_HOOKS_H
+
+/*
+ * The game never sets the switches itself; the tests set them to run the
+ * original, slower code as a reference for the faster code that replaced
+ * it.  Set them before loading a savefile, never part way through a game.
+ * The counters let the tests check the faster code was actually used, and
+ * the functions let them put the original code back together themselves.
+ */
+
+struct chunk;
+struct monster;
+
+/* Regenerate a monster's hitpoints, as every 100 game turns (mon-move.c) */
+void regen_monster(struct monster *mon);
+
+/* Let a monster which has just used up its move energy act (mon-move.c) */
+void monster_take_turn(struct chunk *c, struct monster *mon);
+
+/* Rest through every game turn, idle or not (game-world.c) */
+extern bool rest_every_turn;
+
+/* Count of the game turns rests have skipped over (game-world.c) */
+extern s32b rest_turns_skipped;
+
+/* Work out every projection path afresh, without the cache (project.c) */
+extern bool project_path_uncached;
+
+#endif /* TEST_HOOKS_H */
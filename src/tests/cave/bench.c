@@ -0,0 +1,105 @@
+/* cave/bench.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include <time.h>
+#include "cave.h"
+#include "init.h"
+#include "player.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(30, 0));
+	ok;
+}
+
+/**
+ * Time making and freeing full-sized chunks, and scanning every grid of the
+ * level for a square flag; run with -v to see the numbers
+ */
+int test_chunk(void *state) {
+	clock_t start = clock();
+	int i, y, x, rooms = 0;
+
+	for (i = 0; i < 1000; i++) {
+		struct chunk *c = cave_new(z_info->dungeon_hgt, z_info->dungeon_wid);
+
+		require(c);
+		cave_free(c);
+	}
+
+	if (verbose)
+		printf("    1000 chunks:    %8.3f ms\n",
+			   (1000.0 * (clock() - start)) / CLOCKS_PER_SEC);
+
+	start = clock();
+	for (i = 0; i < 1000; i++)
+		for (y = 0; y < cave->height; y++)
+			for (x = 0; x < cave->width; x++)
+				if (square_isroom(cave, y, x))
+					rooms++;
+	require(rooms > 0);
+
+	if (verbose)
+		printf("    1000 scans:     %8.3f ms\n",
+			   (1000.0 * (clock() - start)) / CLOCKS_PER_SEC);
+
+	ok;
+}
+
+/**
+ * Time los() between every third grid of the level and every grid within 20
+ * of it; run with -v to see the numbers
+ */
+int test_los(void *state) {
+	clock_t start = clock();
+	int y1, x1, y2, x2;
+	long pairs = 0, clear = 0;
+
+	for (y1 = 1; y1 < cave->height - 1; y1 += 3)
+		for (x1 = 1; x1 < cave->width - 1; x1 += 3)
+			for (y2 = y1 - 20; y2 <= y1 + 20; y2++)
+				for (x2 = x1 - 20; x2 <= x1 + 20; x2++) {
+					if (!square_in_bounds(cave, y2, x2)) continue;
+					pairs++;
+					if (los(cave, y1, x1, y2, x2))
+						clear++;
+				}
+	require(clear > 0 && clear < pairs);
+
+	if (verbose)
+		printf("    %ld pairs:  %8.3f ms\n", pairs,
+			   (1000.0 * (clock() - start)) / CLOCKS_PER_SEC);
+
+	ok;
+}
+
+const char *suite_name = "cave/bench";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "chunk", test_chunk },
+	{ "los", test_los },
+	{ NULL, NULL }
+};
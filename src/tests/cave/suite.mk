@@ -0,0 +1,2 @@
+TESTPROGS += cave/view
+TESTPROGS += cave/bench
@@ -0,0 +1,286 @@
+/* cave/view.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+#include "player.h"
+#include "player-timed.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character to look around with */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The reference view algorithm: the original full-map scan, which calls
+ * los() for every grid on the level.  It leaves SQUARE_VIEW and SQUARE_SEEN
+ * set for exactly the grids the player should be able to view and see.
+ */
+static void ref_become_viewable(struct chunk *c, int y, int x, int lit,
+								int py, int px)
+{
+	int xc = x;
+	int yc = y;
+	if (square_isview(c, y, x))
+		return;
+
+	sqinfo_on(c->squares[y][x].info, SQUARE_VIEW);
+
+	if (lit)
+		sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+
+	if (square_isglow(c, y, x)) {
+		if (square_iswall(c, y, x)) {
+			xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+			yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+		}
+		if (square_isglow(c, yc, xc))
+			sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+	}
+}
+
+static void ref_view_one(struct chunk *c, int y, int x, int radius, int py,
+						 int px)
+{
+	int dir;
+	int xc = x;
+	int yc = y;
+
+	int d = distance(y, x, py, px);
+	int lit = d < radius;
+
+	if (d > z_info->max_sight)
+		return;
+
+	for (dir = 0; dir < 8; dir++) {
+		if (!square_in_bounds(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
+			continue;
+		if (square_isbright(c, y + ddy_ddd[dir], x + ddx_ddd[dir]))
+			lit = TRUE;
+	}
+
+	if (square_iswall(c, y, x)) {
+		int dx = x - px;
+		int dy = y - py;
+		int ax = ABS(dx);
+		int ay = ABS(dy);
+		int sx = dx > 0 ? 1 : -1;
+		int sy = dy > 0 ? 1 : -1;
+
+		xc = (x < px) ? (x + 1) : (x > px) ? (x - 1) : x;
+		yc = (y < py) ? (y + 1) : (y > py) ? (y - 1) : y;
+
+		if (square_iswall(c, yc, xc)) {
+			xc = x;
+			yc = y;
+		}
+
+		if (ax == 2 && ay == 1) {
+			if (  !square_iswall(c, y, x - sx)
+				  && square_iswall(c, y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		} else if (ax == 1 && ay == 2) {
+			if (  !square_iswall(c, y - sy, x)
+				  && square_iswall(c, y - sy, x - sx)) {
+				xc = x;
+				yc = y;
+			}
+		}
+	}
+
+	if (los(c, py, px, yc, xc))
+		ref_become_viewable(c, y, x, lit, py, px);
+}
+
+static void ref_monster_lights(struct chunk *c, int py, int px)
+{
+	int i, j, k;
+
+	for (k = 1; k < cave_monster_max(c); k++) {
+		struct monster *m = cave_monster(c, k);
+		bool in_los = los(c, py, px, m->fy, m->fx);
+
+		if (!m->race)
+			continue;
+		if (!rf_has(m->race->flags, RF_HAS_LIGHT))
+			continue;
+
+		for (i = -1; i <= 1; i++)
+			for (j = -1; j <= 1; j++) {
+				int sy = m->fy + i;
+				int sx = m->fx + j;
+
+				if (!in_los && !square_isprojectable(c, sy, sx))
+					continue;
+				if (distance(py, px, sy, sx) > z_info->max_sight)
+					continue;
+				if (!los(c, py, px, sy, sx))
+					continue;
+
+				sqinfo_on(c->squares[sy][sx].info, SQUARE_VIEW);
+				sqinfo_on(c->squares[sy][sx].info, SQUARE_SEEN);
+			}
+	}
+}
+
+/**
+ * Run the reference algorithm and record its output in view and seen,
+ * leaving the chunk's flags as they were.
+ */
+static void ref_view(struct chunk *c, struct player *p, bool *view,
+					 bool *seen)
+{
+	int x, y;
+	int radius = p->state.cur_light;
+	bool *old_view = mem_zalloc(c->height * c->width * sizeof(bool));
+	bool *old_seen = mem_zalloc(c->height * c->width * sizeof(bool));
+
+	if (radius > 0) ++radius;
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			old_view[y * c->width + x] = square_isview(c, y, x);
+			old_seen[y * c->width + x] = square_isseen(c, y, x);
+			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
+			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+		}
+
+	ref_monster_lights(c, p->py, p->px);
+
+	sqinfo_on(c->squares[p->py][p->px].info, SQUARE_VIEW);
+	if (radius > 0 || square_isglow(c, p->py, p->px))
+		sqinfo_on(c->squares[p->py][p->px].info, SQUARE_SEEN);
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
+			ref_view_one(c, y, x, radius, p->py, p->px);
+
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++) {
+			view[y * c->width + x] = square_isview(c, y, x);
+			seen[y * c->width + x] = square_isseen(c, y, x) &&
+				!p->timed[TMD_BLIND];
+
+			sqinfo_off(c->squares[y][x].info, SQUARE_VIEW);
+			sqinfo_off(c->squares[y][x].info, SQUARE_SEEN);
+			if (old_view[y * c->width + x])
+				sqinfo_on(c->squares[y][x].info, SQUARE_VIEW);
+			if (old_seen[y * c->width + x])
+				sqinfo_on(c->squares[y][x].info, SQUARE_SEEN);
+		}
+
+	mem_free(old_view);
+	mem_free(old_seen);
+}
+
+/**
+ * Walk the player around a generated level, checking that update_view()
+ * agrees with the reference algorithm everywhere on the map.
+ */
+static int check_level(int depth, u32b seed)
+{
+	int x, y, n = 0;
+	bool *view, *seen;
+
+	player->depth = depth;
+	Rand_state_init(seed);
+	cave_generate(&cave, player);
+	notnull(cave);
+
+	view = mem_zalloc(cave->height * cave->width * sizeof(bool));
+	seen = mem_zalloc(cave->height * cave->width * sizeof(bool));
+
+	for (y = 1; y < cave->height - 1; y++)
+		for (x = 1; x < cave->width - 1; x++) {
+			int i;
+
+			if (!square_ispassable(cave, y, x))
+				continue;
+
+			/* Sample a spread of positions, light radii and blindness */
+			if (n++ % 5)
+				continue;
+			player->py = y;
+			player->px = x;
+			player->state.cur_light = (n / 5) % 4;
+			player->timed[TMD_BLIND] = ((n / 5) % 7 == 0);
+
+			ref_view(cave, player, view, seen);
+			update_view(cave, player);
+
+			for (i = 0; i < cave->height * cave->width; i++) {
+				int sy = i / cave->width, sx = i % cave->width;
+				eq(square_isview(cave, sy, sx), view[i]);
+				eq(square_isseen(cave, sy, sx), seen[i]);
+				eq(square_wasseen(cave, sy, sx), FALSE);
+			}
+		}
+
+	player->timed[TMD_BLIND] = 0;
+	mem_free(view);
+	mem_free(seen);
+	return 0;
+}
+
+int test_view_town(void *state) {
+	if (check_level(0, 101)) return 1;
+	ok;
+}
+
+int test_view_shallow(void *state) {
+	if (check_level(5, 202)) return 1;
+	ok;
+}
+
+int test_view_deep(void *state) {
+	if (check_level(40, 303)) return 1;
+	if (check_level(70, 404)) return 1;
+	ok;
+}
+
+const char *suite_name = "cave/view";
+struct test tests[] = {
+	{ "town", test_view_town },
+	{ "shallow", test_view_shallow },
+	{ "deep", test_view_deep },
+	{ NULL, NULL }
+};
@@ -9,6 +9,7 @@
 #include "cmd-core.h"
 #include "game-event.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "savefile.h"
 #include "player.h"
@@ -92,6 +93,76 @@ int test_loadgame(void *state) {
 	ok;
 }
 
+int test_savegrids(void *state) {
+	byte *feat, *feat_k;
+	bitflag *info, *info_k;
+	int height, width, y, x, i;
+
+	/* Keep copies of the level and the player's map of it */
+	eq(savefile_load("Test1", FALSE), TRUE);
+	height = cave->height;
+	width = cave->width;
+	feat = mem_alloc(height * width);
+	feat_k = mem_alloc(height * width);
+	info = mem_alloc(height * width * SQUARE_SIZE);
+	info_k = mem_alloc(height * width * SQUARE_SIZE);
+	for (y = 0, i = 0; y < height; y++) {
+		for (x = 0; x < width; x++, i++) {
+			feat[i] = cave->squares[y][x].feat;
+			feat_k[i] = cave_k->squares[y][x].feat;
+			sqinfo_copy(&info[i * SQUARE_SIZE], cave->squares[y][x].info);
+			sqinfo_copy(&info_k[i * SQUARE_SIZE], cave_k->squares[y][x].info);
+		}
+	}
+
+	/* Both should come back through a save unchanged */
+	eq(savefile_save("Test1"), TRUE);
+	eq(savefile_load("Test1", FALSE), TRUE);
+	eq(cave->height, height);
+	eq(cave->width, width);
+	for (y = 0, i = 0; y < height; y++) {
+		for (x = 0; x < width; x++, i++) {
+			eq(cave->squares[y][x].feat, feat[i]);
+			eq(cave_k->squares[y][x].feat, feat_k[i]);
+			require(sqinfo_is_equal(cave->squares[y][x].info,
+									&info[i * SQUARE_SIZE]));
+			require(sqinfo_is_equal(cave_k->squares[y][x].info,
+									&info_k[i * SQUARE_SIZE]));
+		}
+	}
+
+	mem_free(feat);
+	mem_free(feat_k);
+	mem_free(info);
+	mem_free(info_k);
+
+	ok;
+}
+
+int test_storedchunk(void *state) {
+	struct chunk *town;
+
+	/* The town should be kept back, and written back as it came */
+	eq(savefile_load("Test1", FALSE), TRUE);
+	eq(chunk_list_max, 0);
+	eq(chunk_stored_max, 1);
+	eq(savefile_save("Test1"), TRUE);
+	eq(chunk_list_remove("Town"), TRUE);
+	eq(chunk_stored_max, 0);
+
+	/* Then read when it's wanted */
+	eq(savefile_load("Test1", FALSE), TRUE);
+	eq(chunk_stored_max, 1);
+	town = chunk_find_name("Town");
+	notnull(town);
+	eq(chunk_stored_max, 0);
+	require(chunk_find(town));
+	eq(town->height, z_info->town_hgt);
+	eq(town->width, z_info->town_wid);
+
+	ok;
+}
+
 int test_stairs1(void *state) {
 
 	/* Load the saved game */
@@ -177,6 +248,8 @@ const char *suite_name = "game/basic";
 struct test tests[] = {
 	{ "newgame", test_newgame },
 	{ "loadgame", test_loadgame },
+	{ "savegrids", test_savegrids },
+	{ "storedchunk", test_storedchunk },
 	{ "stairs1", test_stairs1 },
 	{ "stairs2", test_stairs2 },
 	{ "droppickup", test_drop_pickup },
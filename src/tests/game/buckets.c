@@ -0,0 +1,155 @@
+/* game/buckets.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "z-util.h"
+
+#define BUCKET_ROUNDS	200
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Check a rectangle query against a scan of the whole monster list
+ */
+static bool rect_matches(int y1, int x1, int y2, int x2)
+{
+	s16b *found;
+	int i, j = 0, n = mon_buckets_rect(cave, y1, x1, y2, x2, &found);
+	bool same = TRUE;
+
+	for (i = 1; i < cave_monster_max(cave) && same; i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race || mon->fy < y1 || mon->fy > y2 || mon->fx < x1 ||
+			mon->fx > x2)
+			continue;
+		if (j == n || found[j] != i)
+			same = FALSE;
+		j++;
+	}
+	if (j != n)
+		same = FALSE;
+
+	mem_free(found);
+	return same;
+}
+
+/**
+ * Check a radius query against a scan of the whole monster list
+ */
+static bool near_matches(int y, int x, int r)
+{
+	s16b *found;
+	int i, j = 0, n = mon_buckets_near(cave, y, x, r, &found);
+	bool same = TRUE;
+
+	for (i = 1; i < cave_monster_max(cave) && same; i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race || distance(y, x, mon->fy, mon->fx) > r)
+			continue;
+		if (j == n || found[j] != i)
+			same = FALSE;
+		j++;
+	}
+	if (j != n)
+		same = FALSE;
+
+	mem_free(found);
+	return same;
+}
+
+/**
+ * Move a monster to a random empty floor grid next to it, unless it is
+ * sitting on the object it pretends to be
+ */
+static void shuffle_monster(struct monster *mon)
+{
+	int y = mon->fy + randint0(3) - 1;
+	int x = mon->fx + randint0(3) - 1;
+
+	if (mon->mimicked_obj) return;
+	if (!square_in_bounds_fully(cave, y, x)) return;
+	if (!square_isempty(cave, y, x)) return;
+	monster_swap(mon->fy, mon->fx, y, x);
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(15, 300));
+	require(cave_monster_count(cave) > 100);
+
+	ok;
+}
+
+int test_queries(void *state) {
+	int i, j;
+
+	for (i = 0; i < BUCKET_ROUNDS; i++) {
+		int y = randint0(cave->height);
+		int x = randint0(cave->width);
+
+		/* Move, kill and make monsters */
+		for (j = 1; j < cave_monster_max(cave); j++) {
+			struct monster *mon = cave_monster(cave, j);
+
+			if (!mon->race) continue;
+			if (one_in_(50))
+				delete_monster_idx(j);
+			else
+				shuffle_monster(mon);
+		}
+		for (j = 0; j < 5; j++)
+			pick_and_place_distant_monster(cave, loc(player->px, player->py),
+										   3, TRUE, player->depth);
+
+		/* Shuffle the monster list now and then */
+		if (i % 50 == 25)
+			compact_monsters(0);
+
+		require(rect_matches(y - randint0(20), x - randint0(40),
+							 y + randint0(20), x + randint0(40)));
+		require(rect_matches(0, 0, cave->height - 1, cave->width - 1));
+		require(near_matches(y, x, randint0(30)));
+	}
+
+	/* Nothing left */
+	wipe_mon_list(cave, player);
+	require(rect_matches(0, 0, cave->height - 1, cave->width - 1));
+
+	ok;
+}
+
+const char *suite_name = "game/buckets";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "queries", test_queries },
+	{ NULL, NULL }
+};
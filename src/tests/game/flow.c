@@ -0,0 +1,312 @@
+/* game/flow.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "z-util.h"
+
+#define FLOW_STEPS	1000
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The flow as a full fill works it out, kept apart from the game's own
+ */
+static byte **ref_cost, **ref_when;
+static int ref_save;
+
+static void ref_forget(void)
+{
+	int y, x;
+
+	if (!ref_save) return;
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			ref_cost[y][x] = ref_when[y][x] = 0;
+	ref_save = 0;
+}
+
+/**
+ * Fill the costs in order, each pass through the level passing on the costs
+ * of the grids at the next cost up
+ */
+static void ref_update(void)
+{
+	int n, y, x, d;
+
+	if (ref_save++ == 255) {
+		for (y = 0; y < cave->height; y++)
+			for (x = 0; x < cave->width; x++)
+				ref_when[y][x] = (ref_when[y][x] >= 128) ?
+					ref_when[y][x] - 128 : 0;
+		ref_save = 128;
+	}
+
+	ref_when[player->py][player->px] = ref_save;
+	ref_cost[player->py][player->px] = 0;
+
+	for (n = 0; n < z_info->max_flow_depth; n++) {
+		for (y = 0; y < cave->height; y++) {
+			for (x = 0; x < cave->width; x++) {
+				if (ref_when[y][x] != ref_save) continue;
+				if (ref_cost[y][x] != n) continue;
+
+				for (d = 0; d < 8; d++) {
+					int yy = y + ddy_ddd[d];
+					int xx = x + ddx_ddd[d];
+					struct feature *f;
+					int m;
+
+					if (!square_in_bounds(cave, yy, xx)) continue;
+					f = &f_info[cave->squares[yy][xx].feat];
+					if (f->prop & FEAT_PROP_NO_FLOW) continue;
+					m = n + f->flow_cost;
+					if (m >= z_info->max_flow_depth) continue;
+					if ((ref_when[yy][xx] == ref_save) &&
+						(ref_cost[yy][xx] <= m))
+						continue;
+					ref_when[yy][xx] = ref_save;
+					ref_cost[yy][xx] = m;
+				}
+			}
+		}
+	}
+}
+
+static bool flow_matches(void)
+{
+	int y, x;
+
+	for (y = 0; y < cave->height; y++)
+		for (x = 0; x < cave->width; x++)
+			if ((cave_flow_when(cave, y, x) != ref_when[y][x]) ||
+				(cave_flow_cost(cave, y, x) != ref_cost[y][x]))
+				return FALSE;
+	return TRUE;
+}
+
+/**
+ * Move the player a step, or now and then teleport them; walls are only
+ * walked into rarely, as with a ghostly player
+ */
+static void move_player(void)
+{
+	int y, x;
+
+	if (one_in_(40)) {
+		do {
+			y = randint1(cave->height - 2);
+			x = randint1(cave->width - 2);
+		} while (!square_ispassable(cave, y, x));
+	} else {
+		y = player->py + randint0(3) - 1;
+		x = player->px + randint0(3) - 1;
+		if (!square_in_bounds_fully(cave, y, x)) return;
+		if (!square_ispassable(cave, y, x) && !one_in_(50)) return;
+	}
+	player->py = y;
+	player->px = x;
+}
+
+/**
+ * Open, close or obstruct some grids near the player
+ */
+static void change_terrain(void)
+{
+	int feats[] = { FEAT_GRANITE, FEAT_GRANITE, FEAT_GRANITE, FEAT_RUBBLE,
+					FEAT_PASS_RUBBLE, FEAT_CLOSED };
+	int i, n = one_in_(20) ? 100 : randint0(4);
+
+	for (i = 0; i < n; i++) {
+		int y = player->py + randint0(31) - 15;
+		int x = player->px + randint0(31) - 15;
+		int feat;
+
+		if (!square_in_bounds_fully(cave, y, x)) continue;
+		if ((y == player->py) && (x == player->px) && !one_in_(10)) continue;
+		feat = cave->squares[y][x].feat;
+		if (square_isfloor(cave, y, x))
+			square_set_feat(cave, y, x, feats[randint0(N_ELEMENTS(feats))]);
+		else if ((feat == FEAT_GRANITE) || (feat == FEAT_RUBBLE) ||
+				 (feat == FEAT_PASS_RUBBLE) || (feat == FEAT_CLOSED))
+			square_set_feat(cave, y, x, one_in_(4) ?
+							feats[randint0(N_ELEMENTS(feats))] : FEAT_FLOOR);
+	}
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(15, 50));
+
+	ok;
+}
+
+int test_flow(void *state) {
+	int i, y;
+
+	ref_cost = mem_zalloc(cave->height * sizeof(*ref_cost));
+	ref_when = mem_zalloc(cave->height * sizeof(*ref_when));
+	for (y = 0; y < cave->height; y++) {
+		ref_cost[y] = mem_zalloc(cave->width);
+		ref_when[y] = mem_zalloc(cave->width);
+	}
+
+	/* Start both from nothing, as on a new level */
+	ref_save = 1;
+	cave_forget_flow(cave);
+	ref_forget();
+	require(flow_matches());
+
+	for (i = 0; i < FLOW_STEPS; i++) {
+		move_player();
+		if (one_in_(3))
+			change_terrain();
+
+		/* Forget the flow now and then, as the game does on new levels and
+		 * most terrain changes, but not so often that the "when" stamps never
+		 * cycle */
+		if (i % 400 == 399) {
+			cave_forget_flow(cave);
+			ref_forget();
+			require(flow_matches());
+		}
+
+		cave_update_flow(cave);
+		ref_update();
+		require(flow_matches());
+	}
+
+	for (y = 0; y < cave->height; y++) {
+		mem_free(ref_cost[y]);
+		mem_free(ref_when[y]);
+	}
+	mem_free(ref_cost);
+	mem_free(ref_when);
+	ok;
+}
+
+/**
+ * An ordinary monster which can only walk, and always heads for the player
+ */
+static struct monster_race *plain_race(void)
+{
+	int i;
+
+	for (i = 1; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+
+		if (!race->rarity || race->level > 20 || race->aaf < 20) continue;
+		if (race->freq_innate || race->freq_spell) continue;
+		if (flags_test(race->flags, RF_SIZE, RF_UNIQUE, RF_NEVER_MOVE,
+					   RF_RAND_25, RF_RAND_50, RF_PASS_WALL, RF_KILL_WALL,
+					   RF_GROUP_AI, FLAG_END))
+			continue;
+		return race;
+	}
+
+	return NULL;
+}
+
+int test_rubble(void *state) {
+	/* Two ways round from the monster to the player:
+	 *
+	 *   #############
+	 *   #m....:....@#
+	 *   #.#########.#
+	 *   #.#########.#
+	 *   #...........#
+	 *   #############
+	 *
+	 * The top one is shorter, but blocked by rubble nothing can walk into */
+	const char *map[] = {
+		"#############",
+		"#m....:....@#",
+		"#.#########.#",
+		"#.#########.#",
+		"#...........#",
+		"#############"
+	};
+	struct monster_race *race = plain_race();
+	struct monster *mon = NULL;
+	int y0 = 1, x0 = 1, y, x, i;
+
+	require(race);
+	wipe_mon_list(cave, player);
+
+	for (y = 0; y < (int) N_ELEMENTS(map); y++) {
+		for (x = 0; map[y][x]; x++) {
+			int yy = y0 + y, xx = x0 + x;
+
+			square_excise_pile(cave, yy, xx);
+			square_destroy_trap(cave, yy, xx);
+			if (map[y][x] == '#')
+				square_set_feat(cave, yy, xx, FEAT_GRANITE);
+			else if (map[y][x] == ':')
+				square_set_feat(cave, yy, xx, FEAT_RUBBLE);
+			else
+				square_set_feat(cave, yy, xx, FEAT_FLOOR);
+		}
+	}
+	/* The flow test above moves the player without telling the cave */
+	if (cave->squares[player->py][player->px].mon < 0)
+		cave->squares[player->py][player->px].mon = 0;
+	player_place(cave, player, y0 + 1, x0 + 11);
+	require(place_new_monster(cave, y0 + 1, x0 + 1, race, FALSE, FALSE,
+							  ORIGIN_DROP));
+	mon = square_monster(cave, y0 + 1, x0 + 1);
+	require(mon);
+
+	cave_forget_flow(cave);
+	player->timed[TMD_INVULN] = 100;
+
+	/* The monster must find its way round, however slow it is */
+	for (i = 0; i < 1000; i++) {
+		if (distance(mon->fy, mon->fx, player->py, player->px) <= 1) break;
+
+		update_view(cave, player);
+		cave_update_flow(cave);
+		process_monsters(cave, 0);
+		reset_monsters();
+		turn++;
+	}
+	require(distance(mon->fy, mon->fx, player->py, player->px) <= 1);
+
+	ok;
+}
+
+const char *suite_name = "game/flow";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "flow", test_flow },
+	{ "rubble", test_rubble },
+	{ NULL, NULL }
+};
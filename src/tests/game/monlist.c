@@ -0,0 +1,197 @@
+/* game/monlist.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-list.h"
+#include "mon-make.h"
+#include "mon-timed.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "project.h"
+#include "z-util.h"
+
+#define MONLIST_ROUNDS	200
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Check a collected list against a count of every monster on the level
+ */
+static bool list_matches(const monster_list_t *list)
+{
+	u16b *count = mem_zalloc(z_info->r_max * MONSTER_LIST_SECTION_MAX *
+							 sizeof(u16b));
+	u16b *asleep = mem_zalloc(z_info->r_max * MONSTER_LIST_SECTION_MAX *
+							  sizeof(u16b));
+	int i, s, races = 0, monsters[MONSTER_LIST_SECTION_MAX] = { 0, 0 };
+	bool same = TRUE;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		int field;
+
+		if (!mon->race || !mflag_has(mon->mflag, MFLAG_VISIBLE) ||
+			mflag_has(mon->mflag, MFLAG_UNAWARE))
+			continue;
+
+		field = projectable(cave, player->py, player->px, mon->fy, mon->fx,
+							PROJECT_NONE) ? MONSTER_LIST_SECTION_LOS :
+			MONSTER_LIST_SECTION_ESP;
+		if (!count[mon->race->ridx * MONSTER_LIST_SECTION_MAX] &&
+			!count[mon->race->ridx * MONSTER_LIST_SECTION_MAX + 1])
+			races++;
+		count[mon->race->ridx * MONSTER_LIST_SECTION_MAX + field]++;
+		if (mon->m_timed[MON_TMD_SLEEP] > 0)
+			asleep[mon->race->ridx * MONSTER_LIST_SECTION_MAX + field]++;
+		monsters[field]++;
+	}
+
+	if (list->distinct_entries != races)
+		same = FALSE;
+	for (s = 0; s < MONSTER_LIST_SECTION_MAX; s++)
+		if (list->total_monsters[s] != monsters[s])
+			same = FALSE;
+
+	for (i = 0; i < list->distinct_entries && same; i++) {
+		const monster_list_entry_t *entry = &list->entries[i];
+
+		for (s = 0; s < MONSTER_LIST_SECTION_MAX; s++) {
+			int r = entry->race->ridx * MONSTER_LIST_SECTION_MAX + s;
+
+			if (entry->count[s] != count[r] || entry->asleep[s] != asleep[r])
+				same = FALSE;
+		}
+
+		/* In order */
+		if (i > 0 && monster_list_standard_compare(&list->entries[i - 1],
+												   entry) >= 0)
+			same = FALSE;
+	}
+
+	mem_free(count);
+	mem_free(asleep);
+	return same;
+}
+
+/**
+ * Collect and sort a list the way the subwindow does
+ */
+static monster_list_t *collect_shared(void)
+{
+	monster_list_t *list = monster_list_shared_instance();
+
+	monster_list_reset(list);
+	monster_list_collect(list);
+	monster_list_sort(list, monster_list_standard_compare);
+	return list;
+}
+
+/**
+ * Move a monster to a random empty floor grid next to it, unless it is
+ * sitting on the object it pretends to be
+ */
+static void shuffle_monster(struct monster *mon)
+{
+	int y = mon->fy + randint0(3) - 1;
+	int x = mon->fx + randint0(3) - 1;
+
+	if (mon->mimicked_obj) return;
+	if (!square_in_bounds_fully(cave, y, x)) return;
+	if (!square_isempty(cave, y, x)) return;
+	monster_swap(mon->fy, mon->fx, y, x);
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(15, 300));
+	require(cave_monster_count(cave) > 100);
+
+	ok;
+}
+
+int test_collect(void *state) {
+	monster_list_t *list;
+	int i, j, seen = 0;
+
+	for (i = 0; i < MONLIST_ROUNDS; i++) {
+		/* Move, kill, make, detect and forget monsters */
+		for (j = 1; j < cave_monster_max(cave); j++) {
+			struct monster *mon = cave_monster(cave, j);
+
+			if (!mon->race) continue;
+			if (one_in_(50)) {
+				delete_monster_idx(j);
+				continue;
+			}
+			if (one_in_(10)) {
+				if (mflag_has(mon->mflag, MFLAG_MARK))
+					mflag_off(mon->mflag, MFLAG_MARK);
+				else
+					mflag_on(mon->mflag, MFLAG_MARK);
+				update_mon(mon, cave, FALSE);
+			}
+			if (one_in_(20))
+				mon_clear_timed(mon, MON_TMD_SLEEP, MON_TMD_FLG_NOMESSAGE,
+								FALSE);
+			shuffle_monster(mon);
+		}
+		for (j = 0; j < 5; j++)
+			pick_and_place_distant_monster(cave, loc(player->px, player->py),
+										   3, TRUE, player->depth);
+
+		/* Shuffle the monster list now and then */
+		if (i % 50 == 25)
+			compact_monsters(0);
+
+		/* Collect once each turn, as the subwindow would */
+		turn++;
+		list = collect_shared();
+		require(list_matches(list));
+		seen += list->distinct_entries;
+
+		/* Collecting again on the same turn changes nothing */
+		list = collect_shared();
+		require(list_matches(list));
+	}
+	require(seen > 0);
+
+	/* A new list finds the same */
+	list = monster_list_new();
+	monster_list_collect(list);
+	monster_list_sort(list, monster_list_standard_compare);
+	require(list_matches(list));
+	monster_list_free(list);
+
+	ok;
+}
+
+const char *suite_name = "game/monlist";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "collect", test_collect },
+	{ NULL, NULL }
+};
@@ -0,0 +1,135 @@
+/* game/paths.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "project.h"
+#include "test-hooks.h"
+#include "z-util.h"
+
+#define PATH_ROUNDS	200
+#define PATH_CHECKS	200
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_tests(void **state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Check a path, and whether its end is projectable, against the same worked
+ * out afresh
+ */
+static bool path_matches(int y1, int x1, int y2, int x2, int range, int flg)
+{
+	struct loc cached[512], fresh[512];
+	int n, m;
+	bool proj, fresh_proj;
+
+	n = project_path(cached, range, y1, x1, y2, x2, flg);
+	proj = projectable(cave, y1, x1, y2, x2, flg);
+	project_path_uncached = TRUE;
+	m = project_path(fresh, range, y1, x1, y2, x2, flg);
+	fresh_proj = projectable(cave, y1, x1, y2, x2, flg);
+	project_path_uncached = FALSE;
+
+	return n == m && proj == fresh_proj &&
+		!memcmp(cached, fresh, n * sizeof(*cached));
+}
+
+/**
+ * Move a monster to a random empty floor grid next to it, unless it is
+ * sitting on the object it pretends to be
+ */
+static void shuffle_monster(struct monster *mon)
+{
+	int y = mon->fy + randint0(3) - 1;
+	int x = mon->fx + randint0(3) - 1;
+
+	if (mon->mimicked_obj) return;
+	if (!square_in_bounds_fully(cave, y, x)) return;
+	if (!square_isempty(cave, y, x)) return;
+	monster_swap(mon->fy, mon->fx, y, x);
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(15, 300));
+	require(cave_monster_count(cave) > 100);
+
+	ok;
+}
+
+int test_paths(void *state) {
+	static const int flags[] = {
+		PROJECT_NONE, PROJECT_STOP, PROJECT_THRU, PROJECT_STOP | PROJECT_THRU
+	};
+	int i, j, hits = 0;
+
+	for (i = 0; i < PATH_ROUNDS; i++) {
+		/* Move monsters and change the terrain */
+		for (j = 1; j < cave_monster_max(cave); j++) {
+			struct monster *mon = cave_monster(cave, j);
+
+			if (mon->race)
+				shuffle_monster(mon);
+		}
+		for (j = 0; j < 20; j++) {
+			int y = randint1(cave->height - 2);
+			int x = randint1(cave->width - 2);
+
+			if (square_isempty(cave, y, x))
+				square_set_feat(cave, y, x, FEAT_GRANITE);
+			else if (cave->squares[y][x].feat == FEAT_GRANITE)
+				square_set_feat(cave, y, x, FEAT_FLOOR);
+		}
+
+		/* Look at paths near the player, as the game does, and elsewhere */
+		for (j = 0; j < PATH_CHECKS; j++) {
+			int y1 = player->py, x1 = player->px;
+			int y2 = y1 + randint0(41) - 20;
+			int x2 = x1 + randint0(81) - 40;
+			int range = one_in_(4) ? randint1(40) : z_info->max_range;
+
+			if (one_in_(4)) {
+				y1 = randint0(cave->height);
+				x1 = randint0(cave->width);
+			}
+			if (!square_in_bounds(cave, y2, x2)) continue;
+			require(path_matches(y1, x1, y2, x2, range, flags[j % 4]));
+			if (projectable(cave, y1, x1, y2, x2, flags[j % 4])) hits++;
+		}
+	}
+	require(hits > 0);
+
+	ok;
+}
+
+const char *suite_name = "game/paths";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "paths", test_paths },
+	{ NULL, NULL }
+};
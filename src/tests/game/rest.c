@@ -0,0 +1,110 @@
+/* game/rest.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-timed.h"
+#include "monster.h"
+#include "savefile.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "test-hooks.h"
+#include "z-util.h"
+
+#define REST_TURNS	20000
+
+int setup_tests(void **state) {
+	return setup_game_tests();
+}
+
+int teardown_tests(void **state) {
+	return teardown_game_tests("Rest1");
+}
+
+/**
+ * Rest, as the player would, until enough game turns have gone by
+ */
+static void rest_turns(int n)
+{
+	s32b end = turn + n;
+
+	while (turn < end && !player->is_dead && !player->upkeep->generate_level) {
+		/* Keep the player around, and hungry for rest */
+		player->timed[TMD_INVULN] = 100;
+		player->food = PY_FOOD_FULL - 1;
+		if (player->chp == player->mhp)
+			player->chp = 1;
+
+		cmdq_push(CMD_REST);
+		cmd_set_arg_choice(cmdq_peek(), "choice", REST_COMPLETE);
+		run_game_loop();
+	}
+}
+
+int test_newgame(void *state) {
+	int i;
+
+	/* Go somewhere with monsters, but none close by or awake */
+	require(make_busy_level(15, 0));
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race) continue;
+		if (!mon->m_timed[MON_TMD_SLEEP] ||
+			distance(player->py, player->px, mon->fy, mon->fx) <
+			MAX(z_info->max_sight, mon->race->aaf) + 5)
+			delete_monster_idx(i);
+	}
+	require(cave_monster_count(cave) > 20);
+
+	eq(savefile_save("Rest1"), TRUE);
+
+	ok;
+}
+
+int test_equivalence(void *state) {
+	struct game_state full, fast;
+	s32b start;
+
+	/* Run every game turn of the rest */
+	rest_every_turn = TRUE;
+	eq(load_game("Rest1"), TRUE);
+	start = turn;
+	rest_turns(REST_TURNS);
+	get_state(&full);
+
+	/* Skip the ones on which nothing happens */
+	rest_every_turn = FALSE;
+	eq(load_game("Rest1"), TRUE);
+	rest_turns_skipped = 0;
+	rest_turns(REST_TURNS);
+	get_state(&fast);
+
+	/* Make sure the player rested, and got the same out of it */
+	require(full.turn >= start + REST_TURNS);
+	require(full.resting_turn > 0);
+	require(rest_turns_skipped > 0);
+	require(same_state(&full, &fast));
+
+	mem_free(full.mons);
+	mem_free(fast.mons);
+
+	ok;
+}
+
+const char *suite_name = "game/rest";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "equivalence", test_equivalence },
+	{ NULL, NULL }
+};
@@ -0,0 +1,118 @@
+/* game/save.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "init.h"
+#include "savefile.h"
+#include "player.h"
+#include "z-util.h"
+
+static int save_done_count;
+static bool save_done_flag;
+
+static void save_done(game_event_type type, game_event_data *data, void *user) {
+	save_done_count++;
+	save_done_flag = data->flag;
+}
+
+int setup_tests(void **state) {
+	event_add_handler(EVENT_SAVE_DONE, save_done, NULL);
+	return setup_game_tests();
+}
+
+int teardown_tests(void **state) {
+	event_remove_handler(EVENT_SAVE_DONE, save_done, NULL);
+	file_delete("Save2");
+	return teardown_game_tests("Save1");
+}
+
+/**
+ * Count the temporary savefiles left lying about in the current directory
+ */
+static int count_new_savefiles(void)
+{
+	ang_dir *dir = my_dopen(".");
+	char name[1024];
+	int n = 0;
+
+	if (!dir) return -1;
+	while (my_dread(dir, name, sizeof(name)))
+		if (prefix(name, "Save") && suffix(name, ".new"))
+			n++;
+	my_dclose(dir);
+
+	return n;
+}
+
+int test_newgame(void *state) {
+	require(make_busy_level(5, 0));
+	eq(savefile_save("Save1"), TRUE);
+	eq(count_new_savefiles(), 0);
+	ok;
+}
+
+int test_async(void *state) {
+	s32b saved_turn = turn;
+	int depth = player->depth;
+
+	/* Save in the background, over the top of an older save */
+	save_done_count = 0;
+	savefile_save_async("Save1");
+	savefile_wait();
+	eq(save_done_count, 1);
+	eq(save_done_flag, TRUE);
+	eq(character_saved, TRUE);
+	eq(count_new_savefiles(), 0);
+
+	/* Nothing more to report once it's done */
+	savefile_poll();
+	savefile_wait();
+	eq(save_done_count, 1);
+
+	/* And with no older save in the way */
+	savefile_save_async("Save2");
+	savefile_wait();
+	eq(save_done_count, 2);
+	eq(save_done_flag, TRUE);
+	eq(count_new_savefiles(), 0);
+
+	/* Both load back as the same game */
+	turn = 1;
+	eq(load_game("Save1"), TRUE);
+	eq(turn, saved_turn);
+	eq(player->depth, depth);
+	require(cave != NULL);
+
+	turn = 1;
+	eq(load_game("Save2"), TRUE);
+	eq(turn, saved_turn);
+	eq(player->depth, depth);
+
+	ok;
+}
+
+int test_failed(void *state) {
+	/* A save which can't be written is reported, and leaves nothing behind */
+	save_done_count = 0;
+	savefile_save_async("no-such-directory/Save3");
+	savefile_wait();
+	eq(save_done_count, 1);
+	eq(save_done_flag, FALSE);
+	eq(character_saved, FALSE);
+	eq(file_exists("no-such-directory/Save3"), FALSE);
+	ok;
+}
+
+const char *suite_name = "game/save";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "async", test_async },
+	{ "failed", test_failed },
+	{ NULL, NULL }
+};
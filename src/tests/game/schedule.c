@@ -0,0 +1,226 @@
+/* game/schedule.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "game-world.h"
+#include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "mon-timed.h"
+#include "monster.h"
+#include "savefile.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "test-hooks.h"
+#include "z-util.h"
+
+#define SCHED_TURNS	3000
+
+int setup_tests(void **state) {
+	return setup_game_tests();
+}
+
+int teardown_tests(void **state) {
+	return teardown_game_tests("Sched1");
+}
+
+/**
+ * The original monster loop, which visits every monster on every game turn,
+ * as the reference for the schedule in process_monsters()
+ */
+static void process_monsters_unscheduled(struct chunk *c, int minimum_energy)
+{
+	int i;
+	int mspeed;
+
+	/* Only process some things every so often */
+	bool regen = FALSE;
+
+	/* Regenerate hitpoints and mana every 100 game turns */
+	if (turn % 100 == 0)
+		regen = TRUE;
+
+	/* Process the monsters (backwards) */
+	for (i = cave_monster_max(c) - 1; i >= 1; i--)
+	{
+		struct monster *mon;
+		bool moving;
+
+		/* Handle "leaving" */
+		if (player->is_dead || player->upkeep->generate_level) break;
+
+		/* Get a 'live' monster */
+		mon = cave_monster(c, i);
+		if (!mon->race) continue;
+
+		/* Ignore monsters that have already been handled */
+		if (mflag_has(mon->mflag, MFLAG_HANDLED))
+			continue;
+
+		/* Not enough energy to move yet */
+		if (mon->energy < minimum_energy) continue;
+
+		/* Does this monster have enough energy to move? */
+		moving = mon->energy >= z_info->move_energy ? TRUE : FALSE;
+
+		/* Prevent reprocessing */
+		mflag_on(mon->mflag, MFLAG_HANDLED);
+
+		/* Handle monster regeneration if requested */
+		if (regen)
+			regen_monster(mon);
+
+		/* Calculate the net speed */
+		mspeed = mon->mspeed;
+		if (mon->m_timed[MON_TMD_FAST])
+			mspeed += 10;
+		if (mon->m_timed[MON_TMD_SLOW])
+			mspeed -= 10;
+
+		/* Give this monster some energy, and tell the schedule so it
+		 * doesn't hand out the same energy again */
+		mon->energy += turn_energy(mspeed);
+		mon->energy_turn = turn + 1;
+
+		/* End the turn of monsters without enough energy to move */
+		if (!moving)
+			continue;
+
+		/* Use up "some" energy */
+		mon->energy -= z_info->move_energy;
+
+		/* Act */
+		monster_take_turn(c, mon);
+	}
+
+	/* Every monster has had this game turn now, even those made during it */
+	if (minimum_energy <= 0) {
+		for (i = 1; i < cave_monster_max(c); i++) {
+			struct monster *mon = cave_monster(c, i);
+			if (mon->race)
+				mon->energy_turn = turn + 1;
+		}
+	}
+
+	/* Update monster visibility after this */
+	player->upkeep->update |= PU_MONSTERS;
+}
+
+/**
+ * The original reset_monsters(), to go with process_monsters_unscheduled()
+ */
+static void reset_monsters_unscheduled(struct chunk *c)
+{
+	int i;
+
+	for (i = cave_monster_max(c) - 1; i >= 1; i--)
+		mflag_off(cave_monster(c, i)->mflag, MFLAG_HANDLED);
+}
+
+/**
+ * The monster half of run_game_loop(), for a player who only waits, with
+ * either the original monster loop or the schedule
+ */
+static void run_turns(int n, bool full_scan)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Keep the player around to be attacked */
+		player->timed[TMD_INVULN] = 100;
+
+		/* Monsters with more energy than the player go first */
+		while (player->energy >= z_info->move_energy) {
+			if (full_scan)
+				process_monsters_unscheduled(cave, player->energy + 1);
+			else
+				process_monsters(cave, player->energy + 1);
+			if (player->is_dead || player->upkeep->generate_level)
+				return;
+			player->energy -= z_info->move_energy;
+		}
+
+		/* Then the rest */
+		if (full_scan) {
+			process_monsters_unscheduled(cave, 0);
+			reset_monsters_unscheduled(cave);
+		} else {
+			process_monsters(cave, 0);
+			reset_monsters();
+		}
+		notice_stuff(player);
+		handle_stuff(player);
+		if (player->is_dead || player->upkeep->generate_level)
+			return;
+
+		if (!(turn % 10))
+			process_world(cave);
+
+		/* Change the speed of a monster now and then */
+		if (i % 37 == 0 && cave_monster_max(cave) > 1) {
+			struct monster *mon = cave_monster(cave,
+				1 + (i / 37) % (cave_monster_max(cave) - 1));
+
+			if (mon->race)
+				mon_inc_timed(mon, (i % 2) ? MON_TMD_FAST : MON_TMD_SLOW,
+							  20, MON_TMD_FLG_NOMESSAGE, FALSE);
+		}
+
+		player->energy += turn_energy(player->state.speed);
+		turn++;
+	}
+}
+
+int test_newgame(void *state) {
+	/* Go somewhere busy, and make it busier */
+	require(make_busy_level(15, 400));
+	require(cave_monster_count(cave) > 200);
+
+	eq(savefile_save("Sched1"), TRUE);
+
+	ok;
+}
+
+int test_equivalence(void *state) {
+	struct game_state start, full, sched;
+	int i;
+	bool moved = FALSE;
+
+	/* Visit every monster on every turn, as before */
+	eq(load_game("Sched1"), TRUE);
+	get_state(&start);
+	eq(load_game("Sched1"), TRUE);
+	run_turns(SCHED_TURNS, TRUE);
+	get_state(&full);
+
+	/* Only visit the monsters which move */
+	eq(load_game("Sched1"), TRUE);
+	run_turns(SCHED_TURNS, FALSE);
+	get_state(&sched);
+
+	/* Make sure something happened, and it happened the same way */
+	for (i = 1; i < MIN(start.mon_max, full.mon_max); i++)
+		if (start.mons[i].fy != full.mons[i].fy ||
+			start.mons[i].fx != full.mons[i].fx)
+			moved = TRUE;
+	require(moved);
+	require(same_state(&full, &sched));
+
+	mem_free(start.mons);
+	mem_free(full.mons);
+	mem_free(sched.mons);
+
+	ok;
+}
+
+const char *suite_name = "game/schedule";
+struct test tests[] = {
+	{ "newgame", test_newgame },
+	{ "equivalence", test_equivalence },
+	{ NULL, NULL }
+};
@@ -1,2 +1,9 @@
 TESTPROGS += game/basic \
-	game/mage
+	game/mage \
+	game/schedule \
+	game/rest \
+	game/buckets \
+	game/monlist \
+	game/paths \
+	game/flow \
+	game/save
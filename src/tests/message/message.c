@@ -0,0 +1,93 @@
+/* message/message */
+
+#include "unit-test.h"
+#include "message.h"
+#include "z-form.h"
+
+int setup_tests(void **state) {
+	messages_init();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	messages_free();
+	return 0;
+}
+
+int test_add(void *state) {
+	message_add("You hit the orc.", MSG_GENERIC);
+	message_add("The orc dies.", MSG_KILL);
+	message_add("The orc dies.", MSG_KILL);
+
+	eq(messages_num(), 2);
+	require(streq(message_str(0), "The orc dies."));
+	eq(message_count(0), 2);
+	eq(message_type(0), MSG_KILL);
+	require(streq(message_str(1), "You hit the orc."));
+	eq(message_count(1), 1);
+
+	/* Too old to be there */
+	require(streq(message_str(2), ""));
+	eq(message_count(2), 0);
+
+	ok;
+}
+
+int test_wrap(void *state) {
+	char buf[40];
+	int i;
+
+	/* Go round the ring a few times; only the newest are kept */
+	for (i = 0; i < 10000; i++) {
+		strnfmt(buf, sizeof(buf), "Message %d", i);
+		message_add(buf, MSG_GENERIC);
+	}
+
+	eq(messages_num(), 2048);
+	for (i = 0; i < 2048; i++) {
+		strnfmt(buf, sizeof(buf), "Message %d", 9999 - i);
+		require(streq(message_str(i), buf));
+	}
+
+	ok;
+}
+
+int test_long(void *state) {
+	char buf[1024];
+	int i, n;
+
+	/* Long messages run out of text space before the ring is full */
+	for (i = 0; i < 1000; i++) {
+		memset(buf, 'a' + (i % 26), sizeof(buf) - 1);
+		buf[sizeof(buf) - 1] = '\0';
+		strnfmt(buf, 10, "%05d", i);
+		buf[5] = ' ';
+		message_add(buf, MSG_GENERIC);
+	}
+
+	n = messages_num();
+	require(n > 0);
+	require(n < 1000);
+	for (i = 0; i < n; i++) {
+		const char *str = message_str(i);
+
+		eq(atoi(str), 999 - i);
+		eq(strlen(str), sizeof(buf) - 1);
+		eq(str[sizeof(buf) - 2], 'a' + ((999 - i) % 26));
+	}
+
+	/* Short ones can be added after, and the long ones go in turn */
+	message_add("Short", MSG_GENERIC);
+	require(streq(message_str(0), "Short"));
+	eq(atoi(message_str(1)), 999);
+
+	ok;
+}
+
+const char *suite_name = "message/message";
+struct test tests[] = {
+	{ "add", test_add },
+	{ "wrap", test_wrap },
+	{ "long", test_long },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += message/message
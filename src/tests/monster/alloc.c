@@ -0,0 +1,232 @@
+/* monster/alloc */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "mon-make.h"
+#include "monster.h"
+#include "player.h"
+#include <time.h>
+
+/* The allocation table order: races by level, then by index */
+static int *race_order;
+static int race_count;
+
+int setup_tests(void **state) {
+	int level, i;
+
+	set_file_paths();
+	init_angband();
+
+	race_order = mem_zalloc(z_info->r_max * sizeof(*race_order));
+	for (level = 0; level < z_info->max_depth; level++)
+		for (i = 1; i < z_info->r_max - 1; i++)
+			if (r_info[i].rarity && r_info[i].level == level)
+				race_order[race_count++] = i;
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	mem_free(race_order);
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The "prob3" of a race at a level, worked out from the race data directly
+ */
+static long ref_prob(const struct monster_race *race, int level,
+					 bool (*hook)(struct monster_race *race), bool christmas)
+{
+	if (hook && !hook((struct monster_race *) race)) return 0;
+	if (level > 0 && race->level <= 0) return 0;
+	if (rf_has(race->flags, RF_SEASONAL) && !christmas) return 0;
+	if (rf_has(race->flags, RF_UNIQUE) && race->cur_num >= race->max_num)
+		return 0;
+	if (rf_has(race->flags, RF_FORCE_DEPTH) && race->level > player->depth)
+		return 0;
+	return 100 / race->rarity;
+}
+
+/**
+ * Pick a race by walking the races in allocation table order, as
+ * get_mon_num() used to
+ */
+static struct monster_race *ref_pick(long total, int level,
+									 bool (*hook)(struct monster_race *race),
+									 bool christmas)
+{
+	long value = randint0(total);
+	int i;
+
+	for (i = 0; i < race_count; i++) {
+		struct monster_race *race = &r_info[race_order[i]];
+		long prob;
+
+		if (race->level > level) break;
+		prob = ref_prob(race, level, hook, christmas);
+		if (value < prob) return race;
+		value -= prob;
+	}
+
+	return NULL;
+}
+
+/**
+ * Choose a race the way get_mon_num() does, consuming random numbers in the
+ * same way, but with a linear walk over the races
+ */
+static struct monster_race *ref_mon_num(int level,
+										bool (*hook)(struct monster_race *race))
+{
+	time_t cur_time = time(NULL);
+	struct tm *date = localtime(&cur_time);
+	bool christmas = date->tm_mon == 11 && date->tm_mday >= 24 &&
+		date->tm_mday <= 26;
+	struct monster_race *race;
+	long total = 0;
+	int i, p;
+
+	if (level > 0 && one_in_(z_info->ood_monster_chance))
+		level += MIN(level / 4 + 2, z_info->ood_monster_amount);
+
+	for (i = 0; i < race_count; i++) {
+		struct monster_race *race = &r_info[race_order[i]];
+
+		if (race->level > level) break;
+		total += ref_prob(race, level, hook, christmas);
+	}
+	if (total <= 0) return NULL;
+
+	race = ref_pick(total, level, hook, christmas);
+	p = randint0(100);
+	if (p < 60) {
+		struct monster_race *old = race;
+
+		race = ref_pick(total, level, hook, christmas);
+		if (race->level < old->level) race = old;
+	}
+	if (p < 10) {
+		struct monster_race *old = race;
+
+		race = ref_pick(total, level, hook, christmas);
+		if (race->level < old->level) race = old;
+	}
+
+	return race;
+}
+
+/**
+ * Put the RNG into a known state
+ */
+static void reseed(u32b seed)
+{
+	rng_state_init(Rand_context, seed);
+}
+
+/**
+ * Check that get_mon_num() picks exactly the race the reference walk picks
+ * for the same random numbers, across levels and player depths.
+ */
+static int check_draws(bool (*hook)(struct monster_race *race))
+{
+	int level, n;
+
+	get_mon_num_prep(hook);
+
+	for (level = 0; level < z_info->max_depth; level += 3) {
+		for (n = 0; n < 200; n++) {
+			u32b seed = level * 1000 + n;
+			struct monster_race *race, *expect;
+
+			/* Let out-of-depth FORCE_DEPTH races be turned away */
+			player->depth = (n % 2) ? level : level / 2;
+
+			reseed(seed);
+			race = get_mon_num(level);
+			reseed(seed);
+			expect = ref_mon_num(level, hook);
+
+			ptreq(race, expect);
+			if (race && hook) {
+				require(hook(race));
+			}
+		}
+	}
+
+	get_mon_num_prep(NULL);
+	player->depth = 0;
+
+	return 0;
+}
+
+static bool hook_animal(struct monster_race *race)
+{
+	return rf_has(race->flags, RF_ANIMAL);
+}
+
+int test_any(void *state) {
+	if (check_draws(NULL)) return 1;
+	ok;
+}
+
+int test_hook(void *state) {
+	if (check_draws(hook_animal)) return 1;
+	ok;
+}
+
+int test_town(void *state) {
+	int n;
+
+	/* Only town monsters in the town, and never out of depth */
+	for (n = 0; n < 1000; n++) {
+		struct monster_race *race, *expect;
+
+		reseed(n);
+		race = get_mon_num(0);
+		reseed(n);
+		expect = ref_mon_num(0, NULL);
+
+		require(race != NULL);
+		eq(race->level, 0);
+		ptreq(race, expect);
+	}
+
+	ok;
+}
+
+int test_uniques(void *state) {
+	int i, n;
+
+	/* Every shallow unique is already about */
+	for (i = 1; i < z_info->r_max; i++)
+		if (rf_has(r_info[i].flags, RF_UNIQUE) && r_info[i].level <= 20)
+			r_info[i].cur_num = r_info[i].max_num;
+
+	if (check_draws(NULL)) return 1;
+	for (n = 0; n < 1000; n++) {
+		struct monster_race *race;
+
+		reseed(n);
+		race = get_mon_num(10);
+		require(race != NULL);
+		require(!rf_has(race->flags, RF_UNIQUE) || race->level > 20);
+	}
+
+	for (i = 1; i < z_info->r_max; i++)
+		if (rf_has(r_info[i].flags, RF_UNIQUE))
+			r_info[i].cur_num = 0;
+
+	ok;
+}
+
+const char *suite_name = "monster/alloc";
+struct test tests[] = {
+	{ "any", test_any },
+	{ "hook", test_hook },
+	{ "town", test_town },
+	{ "uniques", test_uniques },
+	{ NULL, NULL }
+};
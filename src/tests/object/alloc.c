@@ -0,0 +1,148 @@
+/* object/alloc */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "init.h"
+#include "object.h"
+#include "obj-make.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include <time.h>
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * The allocation probability of a kind at a level, worked out from the
+ * object data directly
+ */
+static int ref_rarity(const struct object_kind *kind, int level, bool good)
+{
+	if (!kind->alloc_prob) return 0;
+	if (level < kind->alloc_min || level > kind->alloc_max) return 0;
+	if (good && !kind_is_good(kind)) return 0;
+	return kind->alloc_prob;
+}
+
+/**
+ * Pick an object kind by walking all the kinds in order, consuming random
+ * numbers in the same way as get_obj_num()
+ */
+static struct object_kind *ref_obj_num(int level, bool good, int tval)
+{
+	int item;
+	u32b total = 0, value;
+
+	if ((level > 0) && one_in_(z_info->great_obj))
+		level = 1 + (level * z_info->max_obj_depth /
+					 randint1(z_info->max_obj_depth));
+	level = MIN(level, z_info->max_obj_depth);
+	level = MAX(level, 0);
+
+	for (item = 1; item < z_info->k_max; item++)
+		if (!tval || k_info[item].tval == tval)
+			total += ref_rarity(&k_info[item], level, good);
+
+	if (tval && !total) return NULL;
+
+	value = randint0(total);
+	for (item = 1; item < z_info->k_max; item++) {
+		int rarity;
+
+		if (tval && k_info[item].tval != tval) continue;
+		rarity = ref_rarity(&k_info[item], level, good);
+		if (value < (u32b) rarity) break;
+		value -= rarity;
+	}
+
+	return objkind_byid(item);
+}
+
+/**
+ * Put the RNG into a known state
+ */
+static void reseed(u32b seed)
+{
+	rng_state_init(Rand_context, seed);
+}
+
+/**
+ * Check that get_obj_num() picks exactly the kind the reference walk picks
+ * for the same random numbers, across levels, goodness and tvals.
+ */
+static int check_draws(int tval)
+{
+	int level, n;
+
+	for (level = 0; level <= z_info->max_obj_depth; level += 3) {
+		for (n = 0; n < 200; n++) {
+			u32b seed = level * 1000 + n;
+			bool good = (n % 4 == 0);
+			struct object_kind *kind, *expect;
+
+			reseed(seed);
+			kind = get_obj_num(level, good, tval);
+			reseed(seed);
+			expect = ref_obj_num(level, good, tval);
+
+			ptreq(kind, expect);
+		}
+	}
+
+	return 0;
+}
+
+int test_any(void *state) {
+	if (check_draws(0)) return 1;
+	ok;
+}
+
+int test_tval(void *state) {
+	if (check_draws(TV_SWORD)) return 1;
+	if (check_draws(TV_POTION)) return 1;
+	if (check_draws(TV_MAGIC_BOOK)) return 1;
+	if (check_draws(TV_LIGHT)) return 1;
+	ok;
+}
+
+/**
+ * Time ten million draws, spread over the levels and with a tenth of them
+ * restricted to a tval; run with -v to see the numbers
+ */
+int test_bench(void *state) {
+	clock_t start;
+	int i, found = 0;
+
+	reseed(0);
+	start = clock();
+	for (i = 0; i < 10000000; i++) {
+		int level = i % (z_info->max_obj_depth + 1);
+
+		if (get_obj_num(level, FALSE, (i % 10) ? 0 : TV_POTION))
+			found++;
+	}
+	require(found > 0);
+
+	if (verbose)
+		printf("    10000000 draws: %8.3f ms\n",
+			   (1000.0 * (clock() - start)) / CLOCKS_PER_SEC);
+
+	ok;
+}
+
+const char *suite_name = "object/alloc";
+struct test tests[] = {
+	{ "any", test_any },
+	{ "tval", test_tval },
+	{ "bench", test_bench },
+	{ NULL, NULL }
+};
@@ -1 +1 @@
-TESTPROGS += object/attack object/util object/pile
+TESTPROGS += object/alloc object/attack object/util object/pile
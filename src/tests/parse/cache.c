@@ -0,0 +1,399 @@
+/* parse/cache */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include "generate.h"
+#include "init.h"
+#include "monster.h"
+#include "object.h"
+#include "obj-tval.h"
+#include "parser.h"
+#include "player-spell.h"
+#include "z-dice.h"
+#include "z-expression.h"
+
+/*
+ * Every record is hashed whole, with its pointers replaced by hashes of what
+ * they point to, so a field the cache forgets shows up as a difference even
+ * if nothing here knows about it.  A new pointer field shows up too, as its
+ * address is different each time; add it to the hash functions below.
+ */
+static const char *cache_names[] = {
+	"object", "artifact", "monster", "room_template", "vault"
+};
+
+struct fingerprint {
+	u32b *kinds;
+	u32b *artifacts;
+	u32b *races;
+	u32b svals;
+	u32b rooms;
+	u32b vaults;
+	int k_max;
+	int a_max;
+	int r_max;
+};
+
+static struct fingerprint parsed, cached;
+
+static u32b hash_bytes(u32b h, const void *data, size_t n) {
+	const byte *b = data;
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		h = (h ^ b[i]) * 16777619UL;
+	return h;
+}
+
+static u32b hash_u32b(u32b h, u32b v) {
+	return hash_bytes(h, &v, sizeof(v));
+}
+
+static u32b hash_str(u32b h, const char *s) {
+	h = hash_u32b(h, s != NULL);
+	return s ? hash_bytes(h, s, strlen(s) + 1) : h;
+}
+
+/* Hash the index of a record in an array, or -1 for NULL */
+#define hash_index(h, p, base) hash_u32b(h, (p) ? (u32b)((p) - (base)) : (u32b)-1)
+
+/*
+ * Point the game's paths at the data, with the caches kept in the current
+ * directory rather than the player's
+ */
+static void set_cache_paths(void) {
+	set_file_paths();
+	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = string_make(".");
+}
+
+/*
+ * cleanup_angband() frees the paths without forgetting them, so forget them
+ * here before init_file_paths() frees them again
+ */
+static void forget_file_paths(void) {
+	ANGBAND_DIR_GAMEDATA = ANGBAND_DIR_CUSTOMIZE = ANGBAND_DIR_HELP = NULL;
+	ANGBAND_DIR_SCREENS = ANGBAND_DIR_FONTS = ANGBAND_DIR_TILES = NULL;
+	ANGBAND_DIR_SOUNDS = ANGBAND_DIR_ICONS = ANGBAND_DIR_USER = NULL;
+	ANGBAND_DIR_SAVE = ANGBAND_DIR_SCORES = ANGBAND_DIR_INFO = NULL;
+}
+
+static void delete_caches(void) {
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(cache_names); i++)
+		file_delete(format("%s.cache", cache_names[i]));
+}
+
+int setup_tests(void **state) {
+	set_cache_paths();
+	delete_caches();
+	parse_cache = TRUE;
+	parse_timing = TRUE;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	delete_caches();
+	mem_free(parsed.kinds);
+	mem_free(parsed.artifacts);
+	mem_free(parsed.races);
+	mem_free(cached.kinds);
+	mem_free(cached.artifacts);
+	mem_free(cached.races);
+	return 0;
+}
+
+static u32b hash_brands(u32b h, const struct brand *b) {
+	for (; b; b = b->next) {
+		struct brand c;
+
+		memcpy(&c, b, sizeof(c));
+		h = hash_str(h, c.name);
+		c.name = NULL;
+		c.next = NULL;
+		h = hash_bytes(h, &c, sizeof(c));
+	}
+	return hash_u32b(h, 0);
+}
+
+static u32b hash_slays(u32b h, const struct slay *s) {
+	for (; s; s = s->next) {
+		struct slay c;
+
+		memcpy(&c, s, sizeof(c));
+		h = hash_str(h, c.name);
+		c.name = NULL;
+		c.next = NULL;
+		h = hash_bytes(h, &c, sizeof(c));
+	}
+	return hash_u32b(h, 0);
+}
+
+static u32b hash_effects(u32b h, const struct effect *e) {
+	for (; e; e = e->next) {
+		struct effect c;
+		const char *name;
+		const expression_t *expr;
+		int i;
+
+		memcpy(&c, e, sizeof(c));
+		if (c.dice) {
+			h = hash_str(h, dice_text(c.dice));
+			for (i = 0; dice_expression_slot(c.dice, i, &name, &expr); i++) {
+				if (!name || !expr)
+					continue;
+				h = hash_str(h, name);
+				h = hash_str(h, spell_value_base_name(
+								 expression_base_value(expr)));
+				h = hash_str(h, expression_text(expr));
+			}
+		}
+		c.dice = NULL;
+		c.next = NULL;
+		h = hash_bytes(h, &c, sizeof(c));
+	}
+	return hash_u32b(h, 0);
+}
+
+/*
+ * The next kind isn't hashed: nothing uses it, and when the artifacts are
+ * parsed k_info is reallocated underneath it
+ */
+static u32b hash_kind(const struct object_kind *k) {
+	struct object_kind c;
+	u32b h = 2166136261UL;
+
+	memcpy(&c, k, sizeof(c));
+	h = hash_str(h, c.name);
+	h = hash_str(h, c.text);
+	h = hash_index(h, c.base, kb_info);
+	h = hash_brands(h, c.brands);
+	h = hash_slays(h, c.slays);
+	h = hash_effects(h, c.effect);
+	h = hash_str(h, c.effect_msg);
+	c.name = c.text = c.effect_msg = NULL;
+	c.base = NULL;
+	c.next = NULL;
+	c.brands = NULL;
+	c.slays = NULL;
+	c.effect = NULL;
+	return hash_bytes(h, &c, sizeof(c));
+}
+
+static u32b hash_artifact(const struct artifact *a) {
+	struct artifact c;
+	u32b h = 2166136261UL;
+
+	memcpy(&c, a, sizeof(c));
+	h = hash_str(h, c.name);
+	h = hash_str(h, c.text);
+	h = hash_index(h, c.next, a_info);
+	h = hash_brands(h, c.brands);
+	h = hash_slays(h, c.slays);
+	h = hash_u32b(h, c.activation ? (u32b)c.activation->index : (u32b)-1);
+	h = hash_str(h, c.alt_msg);
+	c.name = c.text = c.alt_msg = NULL;
+	c.next = NULL;
+	c.brands = NULL;
+	c.slays = NULL;
+	c.activation = NULL;
+	return hash_bytes(h, &c, sizeof(c));
+}
+
+static u32b hash_race(const struct monster_race *r) {
+	struct monster_race c;
+	const struct monster_drop *d;
+	const struct monster_friends *f;
+	const struct monster_friends_base *fb;
+	const struct monster_mimic *m;
+	u32b h = 2166136261UL;
+	int i;
+
+	memcpy(&c, r, sizeof(c));
+	h = hash_index(h, c.next, r_info);
+	h = hash_str(h, c.name);
+	h = hash_str(h, c.text);
+	h = hash_str(h, c.plural);
+	h = hash_str(h, c.base ? c.base->name : NULL);
+
+	for (i = 0; c.blow && i < z_info->mon_blows_max; i++) {
+		struct monster_blow b;
+
+		memcpy(&b, &c.blow[i], sizeof(b));
+		h = hash_u32b(h, b.next != NULL);
+		b.next = NULL;
+		h = hash_bytes(h, &b, sizeof(b));
+	}
+	h = hash_u32b(h, c.blow != NULL);
+
+	for (d = c.drops; d; d = d->next) {
+		struct monster_drop e;
+
+		memcpy(&e, d, sizeof(e));
+		h = hash_index(h, e.kind, k_info);
+		h = hash_index(h, e.artifact, a_info);
+		e.next = NULL;
+		e.kind = NULL;
+		e.artifact = NULL;
+		h = hash_bytes(h, &e, sizeof(e));
+	}
+	h = hash_u32b(h, 0);
+
+	/* The friend's name is freed once it's been looked up */
+	for (f = c.friends; f; f = f->next) {
+		struct monster_friends e;
+
+		memcpy(&e, f, sizeof(e));
+		h = hash_index(h, e.race, r_info);
+		e.next = NULL;
+		e.name = NULL;
+		e.race = NULL;
+		h = hash_bytes(h, &e, sizeof(e));
+	}
+	h = hash_u32b(h, 0);
+
+	for (fb = c.friends_base; fb; fb = fb->next) {
+		struct monster_friends_base e;
+
+		memcpy(&e, fb, sizeof(e));
+		h = hash_str(h, e.base ? e.base->name : NULL);
+		e.next = NULL;
+		e.base = NULL;
+		h = hash_bytes(h, &e, sizeof(e));
+	}
+	h = hash_u32b(h, 0);
+
+	for (m = c.mimic_kinds; m; m = m->next)
+		h = hash_index(h, m->kind, k_info);
+	h = hash_u32b(h, 0);
+
+	c.next = NULL;
+	c.name = c.text = c.plural = NULL;
+	c.base = NULL;
+	c.blow = NULL;
+	c.drops = NULL;
+	c.friends = NULL;
+	c.friends_base = NULL;
+	c.mimic_kinds = NULL;
+	return hash_bytes(h, &c, sizeof(c));
+}
+
+static void get_fingerprint(struct fingerprint *fp) {
+	struct room_template *t;
+	struct vault *v;
+	int i;
+
+	fp->k_max = z_info->k_max;
+	fp->kinds = mem_zalloc(fp->k_max * sizeof(*fp->kinds));
+	for (i = 0; i < fp->k_max; i++)
+		fp->kinds[i] = hash_kind(&k_info[i]);
+
+	fp->a_max = z_info->a_max;
+	fp->artifacts = mem_zalloc(fp->a_max * sizeof(*fp->artifacts));
+	for (i = 0; i < fp->a_max; i++)
+		fp->artifacts[i] = hash_artifact(&a_info[i]);
+
+	fp->r_max = z_info->r_max;
+	fp->races = mem_zalloc(fp->r_max * sizeof(*fp->races));
+	for (i = 0; i < fp->r_max; i++)
+		fp->races[i] = hash_race(&r_info[i]);
+
+	fp->svals = 2166136261UL;
+	for (i = 0; i < TV_MAX; i++)
+		fp->svals = hash_u32b(fp->svals, kb_info[i].num_svals);
+
+	fp->rooms = 2166136261UL;
+	for (t = room_templates; t; t = t->next) {
+		struct room_template c;
+
+		memcpy(&c, t, sizeof(c));
+		fp->rooms = hash_str(fp->rooms, c.name);
+		fp->rooms = hash_str(fp->rooms, c.text);
+		c.next = NULL;
+		c.name = c.text = NULL;
+		fp->rooms = hash_bytes(fp->rooms, &c, sizeof(c));
+	}
+
+	fp->vaults = 2166136261UL;
+	for (v = vaults; v; v = v->next) {
+		struct vault c;
+
+		memcpy(&c, v, sizeof(c));
+		fp->vaults = hash_str(fp->vaults, c.name);
+		fp->vaults = hash_str(fp->vaults, c.text);
+		fp->vaults = hash_str(fp->vaults, c.typ);
+		c.next = NULL;
+		c.name = c.text = c.typ = NULL;
+		fp->vaults = hash_bytes(fp->vaults, &c, sizeof(c));
+	}
+}
+
+/*
+ * Count the files with caches that were read from them this time round
+ */
+static int count_cached(void) {
+	int i, n = 0;
+
+	for (i = 0; i < parse_times_count; i++)
+		if (parse_times[i].cached)
+			n++;
+	return n;
+}
+
+int test_parse(void *state) {
+	size_t i;
+
+	/* Parse the text, writing the caches */
+	parse_times_count = 0;
+	init_angband();
+	eq(count_cached(), 0);
+	for (i = 0; i < N_ELEMENTS(cache_names); i++) {
+		eq(file_exists(format("%s.cache", cache_names[i])), TRUE);
+	}
+
+	get_fingerprint(&parsed);
+	cleanup_angband();
+	forget_file_paths();
+	ok;
+}
+
+int test_load(void *state) {
+	int i;
+
+	/* Read the same data back from the caches */
+	set_cache_paths();
+	parse_times_count = 0;
+	init_angband();
+	eq(count_cached(), (int)N_ELEMENTS(cache_names));
+
+	get_fingerprint(&cached);
+	cleanup_angband();
+	forget_file_paths();
+
+	eq(cached.k_max, parsed.k_max);
+	for (i = 0; i < parsed.k_max; i++)
+		eq(cached.kinds[i], parsed.kinds[i]);
+	eq(cached.svals, parsed.svals);
+
+	eq(cached.a_max, parsed.a_max);
+	for (i = 0; i < parsed.a_max; i++)
+		eq(cached.artifacts[i], parsed.artifacts[i]);
+
+	eq(cached.r_max, parsed.r_max);
+	for (i = 0; i < parsed.r_max; i++)
+		eq(cached.races[i], parsed.races[i]);
+
+	eq(cached.rooms, parsed.rooms);
+	eq(cached.vaults, parsed.vaults);
+	ok;
+}
+
+const char *suite_name = "parse/cache";
+struct test tests[] = {
+	{ "parse", test_parse },
+	{ "load", test_load },
+	{ NULL, NULL }
+};
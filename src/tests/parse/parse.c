@@ -3,6 +3,7 @@
 #include "unit-test.h"
 
 #include "parser.h"
+#include "z-form.h"
 
 int setup_tests(void **state) {
 	struct parser *p = parser_new();
@@ -394,6 +395,43 @@ int test_char1(void *state) {
 	ok;
 }
 
+static enum parser_error helper_which(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = parser_getint(p, "n");
+	return PARSE_ERROR_NONE;
+}
+
+static enum parser_error helper_which_neg(struct parser *p) {
+	int *which = parser_priv(p);
+	*which = -parser_getint(p, "n");
+	return PARSE_ERROR_NONE;
+}
+
+int test_supersede(void *state) {
+	int which = 0;
+	eq(parser_reg(state, "test-super int n", helper_which), 0);
+	eq(parser_reg(state, "test-super int n", helper_which_neg), 0);
+	parser_setpriv(state, &which);
+	eq(parser_parse(state, "test-super:5"), PARSE_ERROR_NONE);
+	eq(which, -5);
+	ok;
+}
+
+int test_many(void *state) {
+	int i, which = 0;
+	parser_setpriv(state, &which);
+	for (i = 0; i < 200; i++)
+		eq(parser_reg(state, format("test-many%d int n", i), helper_which),
+		   0);
+	for (i = 0; i < 200; i++) {
+		eq(parser_parse(state, format("test-many%d:%d", i, i)),
+		   PARSE_ERROR_NONE);
+		eq(which, i);
+	}
+	eq(parser_parse(state, "test-many200:1"), PARSE_ERROR_UNDEFINED_DIRECTIVE);
+	ok;
+}
+
 const char *suite_name = "parse/parser";
 struct test tests[] = {
 	{ "priv", test_priv },
@@ -437,5 +475,8 @@ struct test tests[] = {
 
 	{ "baddir", test_baddir },
 
+	{ "supersede", test_supersede },
+	{ "many", test_many },
+
 	{ NULL, NULL }
 };
@@ -1,5 +1,6 @@
 TESTPROGS += parse/a-info \
 	parse/c-info \
+	parse/cache \
 	parse/e-info \
 	parse/f-info \
 	parse/flavor \
@@ -7,8 +7,20 @@
  */
 
 #include "h-basic.h"
+#include "cave.h"
+#include "cmd-core.h"
 #include "config.h"
+#include "game-world.h"
+#include "generate.h"
 #include "init.h"
+#include "mon-make.h"
+#include "mon-move.h"
+#include "monster.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "savefile.h"
+#include "test-utils.h"
+#include "z-rand.h"
 #include "z-util.h"
 
 /*
@@ -42,3 +54,135 @@ void read_edit_files(void) {
 	init_game_constants();
 	init_arrays();
 }
+
+/*
+ * Call this after init_angband() to make the same new character every time
+ * and put them on a full-sized level at the given depth, with the given
+ * number of extra monsters placed away from them, every other one awake.
+ * Returns FALSE if there is no living character on a level afterwards.
+ */
+bool make_busy_level(int depth, int monsters) {
+	int i;
+
+	rng_state_init(Rand_context, 42);
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	if (player->is_dead)
+		return FALSE;
+
+	player->depth = player->max_depth = depth;
+	do {
+		cave_generate(&cave, player);
+	} while (cave->height < z_info->dungeon_hgt);
+	on_new_level();
+	if (!cave)
+		return FALSE;
+
+	for (i = 0; i < monsters; i++)
+		pick_and_place_distant_monster(cave, loc(player->px, player->py), 3,
+									   i % 2, depth);
+
+	return TRUE;
+}
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+/*
+ * Call these from setup_tests() and teardown_tests() in suites which run
+ * through a game saved by an earlier test; the savefile is deleted afterwards.
+ */
+int setup_game_tests(void) {
+	/* Register a basic error handler */
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	return 0;
+}
+
+int teardown_game_tests(const char *savefile) {
+	file_delete(savefile);
+	cleanup_angband();
+	return 0;
+}
+
+/*
+ * Load the saved game, clearing out the monster counts and gear weight from
+ * the last run, so that it can be run again from the same start.
+ */
+bool load_game(const char *savefile) {
+	if (cave)
+		wipe_mon_list(cave, player);
+	player->upkeep->total_weight = 0;
+	player->upkeep->equip_cnt = 0;
+	if (!savefile_load(savefile, FALSE))
+		return FALSE;
+
+	/* Loading the stores uses the RNG, and they aren't cleared either */
+	rng_state_init(Rand_context, 42);
+
+	player->upkeep->update |= (PU_BONUS | PU_HP | PU_MANA | PU_MONSTERS |
+							   PU_UPDATE_VIEW | PU_UPDATE_FLOW | PU_DISTANCE);
+	handle_stuff(player);
+	return TRUE;
+}
+
+/*
+ * Record the state of the game to compare with another run with same_state().
+ * s->mons must be freed afterwards.
+ */
+void get_state(struct game_state *s) {
+	int i;
+
+	mon_sched_settle_all(cave);
+
+	s->mon_max = cave_monster_max(cave);
+	s->mon_cnt = cave_monster_count(cave);
+	s->mons = mem_zalloc(s->mon_max * sizeof(*s->mons));
+	for (i = 1; i < s->mon_max; i++) {
+		struct monster *mon = cave_monster(cave, i);
+
+		if (!mon->race) continue;
+		s->mons[i].ridx = mon->race->ridx;
+		s->mons[i].fy = mon->fy;
+		s->mons[i].fx = mon->fx;
+		s->mons[i].hp = mon->hp;
+		s->mons[i].energy = mon->energy;
+		memcpy(s->mons[i].m_timed, mon->m_timed, sizeof(mon->m_timed));
+	}
+	s->chp = player->chp;
+	s->chp_frac = player->chp_frac;
+	s->csp = player->csp;
+	s->csp_frac = player->csp_frac;
+	s->energy = player->energy;
+	s->food = player->food;
+	s->resting_turn = player->resting_turn;
+	s->turn = turn;
+	s->rand = randint0(0x10000000);
+}
+
+bool same_state(const struct game_state *a, const struct game_state *b) {
+	return a->mon_max == b->mon_max && a->mon_cnt == b->mon_cnt &&
+		a->chp == b->chp && a->chp_frac == b->chp_frac &&
+		a->csp == b->csp && a->csp_frac == b->csp_frac &&
+		a->energy == b->energy && a->food == b->food &&
+		a->resting_turn == b->resting_turn && a->turn == b->turn &&
+		a->rand == b->rand &&
+		!memcmp(a->mons, b->mons, a->mon_max * sizeof(*a->mons));
+}
@@ -9,7 +9,42 @@
 #ifndef TEST_UTILS_H
 #define TEST_UTILS_H
 
+#include "monster.h"
+
+/**
+ * What should come out the same when a saved game is run two different ways
+ */
+struct mon_state {
+	int ridx;
+	byte fy;
+	byte fx;
+	s16b hp;
+	byte energy;
+	s16b m_timed[MON_TMD_MAX];
+};
+
+struct game_state {
+	struct mon_state *mons;
+	int mon_max;
+	int mon_cnt;
+	s16b chp;
+	u16b chp_frac;
+	s16b csp;
+	u16b csp_frac;
+	s16b energy;
+	s16b food;
+	s32b resting_turn;
+	s32b turn;
+	u32b rand;
+};
+
 void set_file_paths(void);
 void read_edit_files(void);
+bool make_busy_level(int depth, int monsters);
+int setup_game_tests(void);
+int teardown_game_tests(const char *savefile);
+bool load_game(const char *savefile);
+void get_state(struct game_state *s);
+bool same_state(const struct game_state *a, const struct game_state *b);
 
 #endif /* TEST_UTIL_H */
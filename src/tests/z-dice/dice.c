@@ -195,11 +195,47 @@ int test_evaluate(void *state)
 	ok;
 }
 
+int test_text(void *state)
+{
+	expression_t *expression = expression_new();
+	const expression_t *bound;
+	dice_t *new = dice_new();
+	const char *name;
+	int i, found = 0;
+
+	require(dice_text(new) == NULL);
+	require(!dice_parse_string(new, "1+2d3M"));
+	require(dice_text(new) == NULL);
+
+	expression_set_base_value(expression, test_evaluate_base);
+	require(expression_add_operations_string(expression, "* 3") > 0);
+	require(expression_add_operations_string(expression, "- 1") > 0);
+	require(streq(expression_text(expression), "* 3 - 1"));
+	require(dice_parse_string(new, "$A + 2d3"));
+	require(streq(dice_text(new), "$A + 2d3"));
+	require(dice_bind_expression(new, "A", expression) >= 0);
+
+	for (i = 0; dice_expression_slot(new, i, &name, &bound); i++) {
+		if (!name)
+			continue;
+		require(streq(name, "A"));
+		require(expression_base_value(bound) == test_evaluate_base);
+		require(streq(expression_text(bound), "* 3 - 1"));
+		found++;
+	}
+	require(found == 1);
+
+	dice_free(new);
+	expression_free(expression);
+	ok;
+}
+
 const char *suite_name = "z-dice/dice";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "text", test_text },
 	{ NULL, NULL },
 };
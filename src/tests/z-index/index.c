@@ -0,0 +1,85 @@
+/* z-index/index */
+
+#include "unit-test.h"
+#include "z-index.h"
+#include "z-form.h"
+
+int setup_tests(void **state) {
+	struct name_index *idx = name_index_new();
+	*state = idx;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	name_index_free(state);
+	return 0;
+}
+
+static int data[8];
+
+int test_exact(void *state) {
+	struct name_index *idx = state;
+
+	name_index_add(idx, "Grip, Farmer Maggot's Dog", &data[0]);
+	name_index_add(idx, "Fang, Farmer Maggot's Dog", &data[1]);
+	name_index_add(idx, "Scruffy little dog", &data[2]);
+	name_index_add(idx, "Soldier ant", &data[3]);
+	eq(name_index_size(idx), 4);
+
+	ptreq(name_index_get(idx, "Scruffy little dog"), &data[2]);
+	ptreq(name_index_get(idx, "Soldier ant"), &data[3]);
+	null(name_index_get(idx, "soldier ant"));
+	null(name_index_get(idx, "Soldier"));
+
+	/* The first of two the same is kept */
+	name_index_add(idx, "Soldier ant", &data[4]);
+	eq(name_index_size(idx), 4);
+	ptreq(name_index_get(idx, "Soldier ant"), &data[3]);
+
+	ok;
+}
+
+int test_search(void *state) {
+	struct name_index *idx = state;
+
+	/* Substrings, ignoring case, with the first added preferred */
+	ptreq(name_index_search(idx, "maggot"), &data[0]);
+	ptreq(name_index_search(idx, "FANG"), &data[1]);
+	ptreq(name_index_search(idx, "dog"), &data[0]);
+	ptreq(name_index_search(idx, "little"), &data[2]);
+	ptreq(name_index_search(idx, "r a"), &data[3]);
+	null(name_index_search(idx, "kobold"));
+
+	/* Patterns too short for trigrams */
+	ptreq(name_index_search(idx, "an"), &data[1]);
+	ptreq(name_index_search(idx, "NT"), &data[3]);
+	ptreq(name_index_search(idx, "f"), &data[0]);
+	null(name_index_search(idx, "zz"));
+
+	ok;
+}
+
+int test_many(void *state) {
+	struct name_index *idx = name_index_new();
+	int i;
+
+	for (i = 0; i < 5000; i++)
+		name_index_add(idx, format("name %d", i), &data[i % 8]);
+	eq(name_index_size(idx), 5000);
+
+	for (i = 0; i < 5000; i++)
+		ptreq(name_index_get(idx, format("name %d", i)), &data[i % 8]);
+	ptreq(name_index_search(idx, "E 4999"), &data[4999 % 8]);
+	ptreq(name_index_search(idx, "77"), &data[77 % 8]);
+
+	name_index_free(idx);
+	ok;
+}
+
+const char *suite_name = "z-index/index";
+struct test tests[] = {
+	{ "exact", test_exact },
+	{ "search", test_search },
+	{ "many", test_many },
+	{ NULL, NULL }
+};
@@ -2,6 +2,7 @@
 
 #include "unit-test.h"
 #include "z-quark.h"
+#include "z-form.h"
 
 int setup_tests(void **state) {
 	quarks_init();
@@ -46,9 +47,36 @@ int test_dedup(void *state) {
 	ok;
 }
 
+int test_many(void *state) {
+	quark_t q[1000];
+	char buf[20];
+	int i;
+
+	/* Enough to grow the table and its index several times */
+	quarks_reserve(10);
+	for (i = 0; i < 1000; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		q[i] = quark_add(buf);
+		require(q[i]);
+	}
+
+	for (i = 0; i < 1000; i++) {
+		strnfmt(buf, sizeof(buf), "2-%d", i);
+		require(quark_add(buf) == q[i]);
+		require(!strcmp(quark_str(q[i]), buf));
+	}
+
+	/* Earlier quarks keep their numbers */
+	require(quark_add("1-foo") < q[0]);
+	require(!strcmp(quark_str(quark_add("1-foo")), "1-foo"));
+
+	ok;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "many", test_many },
 	{ NULL, NULL }
 };
@@ -0,0 +1,98 @@
+/* z-rand/rand */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+#define DRAWS 100
+
+static void draw(u32b *out)
+{
+	int i;
+
+	for (i = 0; i < DRAWS; i++)
+		out[i] = randint0(0x10000000);
+}
+
+int test_init(void *state)
+{
+	struct rng_state a, b;
+	struct rng_state *old;
+	u32b first[DRAWS], second[DRAWS];
+
+	/* The same seed gives the same stream, whatever came before */
+	rng_state_init(&a, 42);
+	old = Rand_set_context(&a);
+	draw(first);
+
+	rng_state_init(&b, 7);
+	Rand_set_context(&b);
+	draw(second);
+	rng_state_init(&b, 42);
+	draw(second);
+	Rand_set_context(old);
+
+	require(!memcmp(first, second, sizeof(first)));
+	ok;
+}
+
+int test_context(void *state)
+{
+	struct rng_state game, private;
+	struct rng_state *old;
+	u32b expect[DRAWS], got[DRAWS];
+
+	Rand_quick = FALSE;
+	Rand_state_init(1234);
+	rng_state_save(&game);
+	draw(expect);
+
+	/* Drawing from a private stream leaves the game's alone */
+	rng_state_restore(&game);
+	rng_state_init(&private, 99);
+	old = Rand_set_context(&private);
+	ptreq(Rand_context, &private);
+	draw(got);
+	ptreq(Rand_set_context(old), &private);
+	draw(got);
+
+	require(!memcmp(expect, got, sizeof(expect)));
+	ok;
+}
+
+int test_split(void *state)
+{
+	struct rng_state parent, child1, child2, again;
+	struct rng_state *old;
+	u32b a[DRAWS], b[DRAWS], c[DRAWS];
+
+	rng_state_init(&parent, 5);
+	rng_state_split(&parent, &child1);
+	rng_state_split(&parent, &child2);
+
+	old = Rand_set_context(&child1);
+	draw(a);
+	Rand_set_context(&child2);
+	draw(b);
+
+	/* Splits are reproducible */
+	rng_state_init(&parent, 5);
+	rng_state_split(&parent, &again);
+	Rand_set_context(&again);
+	draw(c);
+	Rand_set_context(old);
+
+	require(memcmp(a, b, sizeof(a)));
+	require(!memcmp(a, c, sizeof(a)));
+	ok;
+}
+
+const char *suite_name = "z-rand/rand";
+struct test tests[] = {
+	{ "init", test_init },
+	{ "context", test_context },
+	{ "split", test_split },
+	{ NULL, NULL }
+};
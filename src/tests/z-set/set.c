@@ -0,0 +1,122 @@
+/* z-set/set */
+
+#include "unit-test.h"
+#include "z-set.h"
+#include "z-virt.h"
+#include <time.h>
+
+int setup_tests(void **state) {
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	return 0;
+}
+
+int test_small(void *state) {
+	struct set *s = set_new();
+	int a, b, c;
+
+	set_add(s, &a);
+	set_add(s, &b);
+	set_add(s, &c);
+	eq(set_size(s), 3);
+	require(set_contains(s, &b));
+
+	require(set_del(s, &a));
+	require(!set_del(s, &a));
+	require(!set_contains(s, &a));
+	eq(set_size(s), 2);
+
+	/* The last element fills the hole */
+	ptreq(set_get(s, 0), &c);
+	ptreq(set_get(s, 1), &b);
+	null(set_get(s, 2));
+
+	set_free(s);
+	ok;
+}
+
+int test_indexed(void *state) {
+	struct set *s = set_new();
+	char *elems = mem_zalloc(1000);
+	size_t i;
+
+	for (i = 0; i < 1000; i++)
+		set_add(s, &elems[i]);
+	eq(set_size(s), 1000);
+
+	/* Drop the odd ones, and the rest are still found */
+	for (i = 1; i < 1000; i += 2)
+		require(set_del(s, &elems[i]));
+	eq(set_size(s), 500);
+	for (i = 0; i < 1000; i++)
+		eq(set_contains(s, &elems[i]), !(i & 1));
+
+	/* A second copy needs a second delete */
+	set_add(s, &elems[0]);
+	require(set_del(s, &elems[0]));
+	require(set_contains(s, &elems[0]));
+	require(set_del(s, &elems[0]));
+	require(!set_contains(s, &elems[0]));
+
+	/* Inserting past the end fills with NULLs, all of which are members */
+	set_insert(s, 600, &elems[1]);
+	eq(set_size(s), 601);
+	ptreq(set_get(s, 600), &elems[1]);
+	require(set_contains(s, &elems[1]));
+	require(set_contains(s, NULL));
+	set_insert(s, 600, &elems[3]);
+	require(!set_contains(s, &elems[1]));
+	require(set_contains(s, &elems[3]));
+
+	while (set_del(s, NULL))
+		;
+	eq(set_size(s), 499 + 1);
+	for (i = 2; i < 1000; i += 2)
+		require(set_contains(s, &elems[i]));
+
+	set_free(s);
+	mem_free(elems);
+	ok;
+}
+
+/**
+ * Time adding, finding and deleting every element for sets of 10 to 100000
+ * elements; run with -v to see the numbers
+ */
+int test_bench(void *state) {
+	size_t n;
+
+	for (n = 10; n <= 100000; n *= 10) {
+		struct set *s = set_new();
+		char *elems = mem_zalloc(n);
+		clock_t start = clock();
+		size_t i;
+
+		for (i = 0; i < n; i++)
+			set_add(s, &elems[i]);
+		for (i = 0; i < n; i++)
+			require(set_contains(s, &elems[i]));
+		for (i = 0; i < n; i++)
+			require(set_del(s, &elems[(i * 7919) % n]));
+		eq(set_size(s), 0);
+
+		if (verbose)
+			printf("    %6lu elements: %8.3f ms\n", (unsigned long)n,
+				   (1000.0 * (clock() - start)) / CLOCKS_PER_SEC);
+
+		set_free(s);
+		mem_free(elems);
+	}
+
+	ok;
+}
+
+const char *suite_name = "z-set/set";
+struct test tests[] = {
+	{ "small", test_small },
+	{ "indexed", test_indexed },
+	{ "bench", test_bench },
+	{ NULL, NULL }
+};
@@ -0,0 +1 @@
+TESTPROGS += z-set/set
@@ -23,9 +23,38 @@
 #include "player-attack.h"
 #include "player-util.h"
 #include "trap.h"
+#include "z-index.h"
 
 struct trap_kind *trap_info;
 
+/**
+ * Index of trap kinds by description, built once the game data has been
+ * parsed.  Lookups made while parsing search trap_info directly.
+ */
+static struct name_index *trap_descs;
+
+static void init_trap_lookup(void)
+{
+	int i;
+
+	trap_descs = name_index_new();
+	for (i = 1; i < z_info->trap_max; i++)
+		if (trap_info[i].name && trap_info[i].desc)
+			name_index_add(trap_descs, trap_info[i].desc, &trap_info[i]);
+}
+
+static void cleanup_trap_lookup(void)
+{
+	name_index_free(trap_descs);
+	trap_descs = NULL;
+}
+
+struct init_module trap_lookup_module = {
+	.name = "trap",
+	.init = init_trap_lookup,
+	.cleanup = cleanup_trap_lookup
+};
+
 /**
  * Find a trap kind based on its short description
  */
@@ -34,6 +63,12 @@ struct trap_kind *lookup_trap(const char *desc)
 	int i;
 	struct trap_kind *closest = NULL;
 
+	/* Look it up */
+	if (trap_descs) {
+		struct trap_kind *kind = name_index_get(trap_descs, desc);
+		return kind ? kind : name_index_search(trap_descs, desc);
+	}
+
 	/* Look for it */
 	for (i = 1; i < z_info->trap_max; i++) {
 		struct trap_kind *kind = &trap_info[i];
@@ -2178,7 +2178,7 @@ static void new_level_display_update(game_event_type type,
 
 	/* If autosave is pending, do it now. */
 	if (player->upkeep->autosave) {
-		save_game();
+		autosave_game();
 		player->upkeep->autosave = FALSE;
 	}
 
@@ -2242,6 +2242,15 @@ static void cheat_death(game_event_type type, game_event_data *data, void *user)
 	wiz_cheat_death();
 }
 
+/**
+ * Report a background save that didn't make it to the disk
+ */
+static void save_done(game_event_type type, game_event_data *data, void *user)
+{
+	if (!data->flag)
+		msg("Autosave failed!");
+}
+
 static void check_panel(game_event_type type, game_event_data *data, void *user)
 {
 	verify_panel();
@@ -2455,6 +2464,7 @@ static void ui_enter_world(game_event_type type, game_event_data *data,
 
 	/* Allow the player to cheat death, if appropriate */
 	event_add_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
+	event_add_handler(EVENT_SAVE_DONE, save_done, NULL);
 
 	/* Hack -- Decrease "icky" depth */
 	screen_save_depth--;
@@ -2517,6 +2527,7 @@ static void ui_leave_world(game_event_type type, game_event_data *data,
 
 	/* Allow the player to cheat death, if appropriate */
 	event_remove_handler(EVENT_CHEAT_DEATH, cheat_death, NULL);
+	event_remove_handler(EVENT_SAVE_DONE, save_done, NULL);
 
 	/* Prepare to interact with a store */
 	event_add_handler(EVENT_USE_STORE, use_store, NULL);
@@ -424,6 +424,9 @@ void play_game(bool new_game)
 	/* Get commands from the user, then process the game world until the
 	 * command queue is empty and a new player command is needed */
 	while (!player->is_dead && player->upkeep->playing) {
+		/* Hear back from any autosave that has finished */
+		savefile_poll();
+
 		if (current_graphics_mode && current_graphics_mode->overdrawRow)
 			pre_turn_refresh();
 		cmd_get_hook(CMD_GAME);
@@ -454,9 +457,10 @@ void savefile_set_name(const char *fname)
 }
 
 /**
- * Save the game
+ * Save the game, either waiting for the savefile to be written or leaving it
+ * to be written in the background
  */
-void save_game(void)
+static void save_game_aux(bool background)
 {
 	char path[1024];
 
@@ -470,10 +474,12 @@ void save_game(void)
 	handle_stuff(player);
 
 	/* Message */
-	prt("Saving game...", 0, 0);
+	if (!background) {
+		prt("Saving game...", 0, 0);
 
-	/* Refresh */
-	Term_fresh();
+		/* Refresh */
+		Term_fresh();
+	}
 
 	/* The player is not dead */
 	my_strcpy(player->died_from, "(saved)", sizeof(player->died_from));
@@ -481,8 +487,10 @@ void save_game(void)
 	/* Forbid suspend */
 	signals_ignore_tstp();
 
-	/* Save the player */
-	if (savefile_save(savefile))
+	/* Save the player; a background failure comes back as EVENT_SAVE_DONE */
+	if (background)
+		savefile_save_async(savefile);
+	else if (savefile_save(savefile))
 		prt("Saving game... done.", 0, 0);
 	else
 		prt("Saving game... failed!", 0, 0);
@@ -514,6 +522,22 @@ void save_game(void)
 	my_strcpy(player->died_from, "(alive and well)", sizeof(player->died_from));
 }
 
+/**
+ * Save the game
+ */
+void save_game(void)
+{
+	save_game_aux(FALSE);
+}
+
+/**
+ * Save the game without waiting for the savefile to reach the disk
+ */
+void autosave_game(void)
+{
+	save_game_aux(TRUE);
+}
+
 
 
 /**
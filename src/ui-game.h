@@ -37,6 +37,7 @@ void check_for_player_interrupt(game_event_type type, game_event_data *data,
 void play_game(bool new_game);
 void savefile_set_name(const char *fname);
 void save_game(void);
+void autosave_game(void);
 void close_game(void);
 
 #endif /* INCLUDED_UI_GAME_H */
@@ -246,8 +246,8 @@ static ui_event target_recall_loop_object(struct object *obj, int y, int x,
 			if (player->wizard) {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s (%d:%d, cost=%d, when=%d).", s1, s2, s3,
-						o_name, coords, y, x, (int)cave->squares[y][x].cost,
-						(int)cave->squares[y][x].when);
+						o_name, coords, y, x, cave_flow_cost(cave, y, x),
+						cave_flow_when(cave, y, x));
 			} else {
 				strnfmt(out_val, TARGET_OUT_VAL_SIZE,
 						"%s%s%s%s, %s.", s1, s2, s3, o_name, coords);
@@ -347,8 +347,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard)
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, cost=%d, when=%d).", s1, s2, s3,
-						name, coords, y, x, (int)cave->squares[y][x].cost,
-						(int)cave->squares[y][x].when);
+						name, coords, y, x, cave_flow_cost(cave, y, x),
+						cave_flow_when(cave, y, x));
 			else
 				strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.",
 						s1, s2, s3, name, coords);
@@ -411,8 +411,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s (%d:%d, cost=%d, when=%d).",
 									s1, s2, s3, m_name, buf, coords, y, x,
-									(int)cave->squares[y][x].cost,
-									(int)cave->squares[y][x].when);
+									cave_flow_cost(cave, y, x),
+									cave_flow_when(cave, y, x));
 						} else {
 							strnfmt(out_val, sizeof(out_val),
 									"%s%s%s%s (%s), %s.",
@@ -477,8 +477,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%s%s, %s (%d:%d, cost=%d, when=%d).",
 								s1, s2, s3, o_name, coords, y, x,
-								(int)cave->squares[y][x].cost,
-								(int)cave->squares[y][x].when);
+								cave_flow_cost(cave, y, x),
+								cave_flow_when(cave, y, x));
 					}
 
 					prt(out_val, 0, 0);
@@ -542,8 +542,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 					strnfmt(out_val, sizeof(out_val),
 							"%s%s%s%s, %s (%d:%d, cost=%d, when=%d).", s1, s2,
 							s3, trap->kind->name, coords, y, x,
-							(int)cave->squares[y][x].cost,
-							(int)cave->squares[y][x].when);
+							cave_flow_cost(cave, y, x),
+							cave_flow_when(cave, y, x));
 				} else {
 					strnfmt(out_val, sizeof(out_val), "%s%s%s%s, %s.", 
 							s1, s2, s3, trap->kind->desc, coords);
@@ -592,8 +592,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s (%d:%d, cost=%d, when=%d).",
 								s1, s2, s3, floor_num, coords, y, x,
-								(int)cave->squares[y][x].cost,
-								(int)cave->squares[y][x].when);
+								cave_flow_cost(cave, y, x),
+								cave_flow_when(cave, y, x));
 					} else {
 						strnfmt(out_val, sizeof(out_val),
 								"%s%s%sa pile of %d objects, %s.",
@@ -695,8 +695,8 @@ static ui_event target_set_interactive_aux(int y, int x, int mode)
 			if (player->wizard) {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s (%d:%d, cost=%d, when=%d).", s1, s2, s3,
-						name, coords, y, x, (int)cave->squares[y][x].cost,
-						(int)cave->squares[y][x].when);
+						name, coords, y, x, cave_flow_cost(cave, y, x),
+						cave_flow_when(cave, y, x));
 			} else {
 				strnfmt(out_val, sizeof(out_val),
 						"%s%s%s%s, %s.", s1, s2, s3, name, coords);
@@ -149,10 +149,10 @@ static void do_cmd_wiz_hack_ben(void)
 				if (!square_in_bounds_fully(cave, y, x)) continue;
 
 				/* Display proper cost */
-				if (cave->squares[y][x].cost != i) continue;
+				if (cave_flow_cost(cave, y, x) != i) continue;
 
 				/* Reliability in yellow */
-				if (cave->squares[y][x].when == cave->squares[py][px].when)
+				if (cave_flow_when(cave, y, x) == cave_flow_when(cave, py, px))
 					a = COLOUR_YELLOW;
 
 				/* Display player/floors/walls */
@@ -31,6 +31,7 @@ struct dice_s {
 	int b, x, y, m;
 	bool ex_b, ex_x, ex_y, ex_m;
 	dice_expression_entry_t *expressions;
+	char *text;
 };
 
 /**
@@ -172,6 +173,9 @@ static void dice_reset(dice_t *dice)
 	dice->ex_y = FALSE;
 	dice->ex_m = FALSE;
 
+	string_free(dice->text);
+	dice->text = NULL;
+
 	if (dice->expressions == NULL)
 		return;
 
@@ -494,6 +498,33 @@ bool dice_parse_string(dice_t *dice, const char *string)
 		}
 	}
 
+	dice->text = string_make(string);
+	return TRUE;
+}
+
+/**
+ * Return the string the dice were parsed from, or NULL.
+ */
+const char *dice_text(const dice_t *dice)
+{
+	return dice->text;
+}
+
+/**
+ * Get the variable name and bound expression in slot `i` of the dice.
+ *
+ * Either may be NULL for an unused slot or unbound variable.
+ *
+ * eturn FALSE if `i` is past the last slot.
+ */
+bool dice_expression_slot(const dice_t *dice, int i, const char **name,
+						  const expression_t **expression)
+{
+	if (i < 0 || i >= DICE_MAX_EXPRESSIONS)
+		return FALSE;
+
+	*name = dice->expressions ? dice->expressions[i].name : NULL;
+	*expression = dice->expressions ? dice->expressions[i].expression : NULL;
 	return TRUE;
 }
 
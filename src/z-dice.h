@@ -29,6 +29,9 @@ typedef struct dice_s dice_t;
 dice_t *dice_new(void);
 void dice_free(dice_t *dice);
 bool dice_parse_string(dice_t *dice, const char *string);
+const char *dice_text(const dice_t *dice);
+bool dice_expression_slot(const dice_t *dice, int i, const char **name,
+						  const expression_t **expression);
 int dice_bind_expression(dice_t *dice, const char *name,
 						 const expression_t *expression);
 void dice_random_value(dice_t *dice, random_value *v);
@@ -30,6 +30,7 @@ struct expression_s {
 	size_t operation_count;
 	size_t operations_size;
 	expression_operation_t *operations;
+	char *text;
 };
 
 /**
@@ -161,6 +162,7 @@ void expression_free(expression_t *expression)
 		expression->operations = NULL;
 	}
 
+	string_free(expression->text);
 	mem_free(expression);
 }
 
@@ -178,6 +180,7 @@ expression_t *expression_copy(const expression_t *source)
 	copy->base_value = source->base_value;
 	copy->operation_count = source->operation_count;
 	copy->operations_size = source->operations_size;
+	copy->text = string_make(source->text);
 
 	if (copy->operations_size == 0) {
 		copy->operations = NULL;
@@ -188,6 +191,7 @@ expression_t *expression_copy(const expression_t *source)
 								  sizeof(expression_operation_t));
 
 	if (copy->operations == NULL && source->operations != NULL) {
+		string_free(copy->text);
 		mem_free(copy);
 		return NULL;
 	}
@@ -209,6 +213,24 @@ void expression_set_base_value(expression_t *expression,
 	expression->base_value = function;
 }
 
+/**
+ * Return the base value function, or NULL if there isn't one.
+ */
+expression_base_value_f expression_base_value(const expression_t *expression)
+{
+	return expression->base_value;
+}
+
+/**
+ * Return the operations strings added to the expression, separated by
+ * spaces, or NULL if none were added.  Adding this string to a new expression
+ * with the same base value gives the same operations.
+ */
+const char *expression_text(const expression_t *expression)
+{
+	return expression->text;
+}
+
 /**
  * Evaluate the given expression. If the base value function is NULL,
  * expression is evaluated from zero.
@@ -381,6 +403,11 @@ s16b expression_add_operations_string(expression_t *expression,
 		expression_add_operation(expression, operations[i]);
 	}
 
+	/* Remember the text, so the expression can be written out again */
+	if (expression->text)
+		expression->text = string_append(expression->text, " ");
+	expression->text = string_append(expression->text, string);
+
 	string_free(parse_string);
 	return count;
 }
@@ -38,6 +38,8 @@ void expression_free(expression_t *expression);
 expression_t *expression_copy(const expression_t *source);
 void expression_set_base_value(expression_t *expression,
 							   expression_base_value_f function);
+expression_base_value_f expression_base_value(const expression_t *expression);
+const char *expression_text(const expression_t *expression);
 s32b expression_evaluate(expression_t const * const expression);
 s16b expression_add_operations_string(expression_t *expression,
 									  const char *string);
@@ -430,6 +430,22 @@ bool file_close(ang_file *f)
 	return TRUE;
 }
 
+/**
+ * Flush 'f' and, where the platform allows, force it out to the disk.
+ */
+bool file_sync(ang_file *f)
+{
+	if (fflush(f->fh) != 0)
+		return FALSE;
+
+#if defined(HAVE_FSYNC) && defined(UNIX)
+	if (fsync(fileno(f->fh)) != 0)
+		return FALSE;
+#endif /* HAVE_FSYNC && UNIX */
+
+	return TRUE;
+}
+
 
 
 /** Locking functions **/
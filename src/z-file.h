@@ -165,6 +165,14 @@ extern void (*file_open_hook)(const char *path, file_type ftype);
  */
 bool file_close(ang_file *f);
 
+/**
+ * Flush the file handle `f` and ask the OS to commit it to the disk, so a
+ * following file_move() cannot leave a half-written file behind.
+ *
+ * Returns TRUE if successful, FALSE otherwise.
+ */
+bool file_sync(ang_file *f);
+
 
 /** File locking **/
 
@@ -0,0 +1,234 @@
+/**
+ * \file z-index.c
+ * \brief Indexes from names to data, for exact and fuzzy lookups
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-index.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+/**
+ * Number of buckets that trigrams are hashed into for fuzzy searches
+ */
+#define TRIGRAM_BUCKETS	1024
+
+struct name_entry {
+	char *name;
+	void *data;
+};
+
+struct trigram_bucket {
+	u32b *entries;
+	size_t count;
+	size_t allocated;
+};
+
+/**
+ * Entries are kept in the order they were added, which is the order that
+ * fuzzy searches prefer them in.  The exact index is open-addressed with
+ * linear probing, holding entry numbers plus one, and is at most half full.
+ * Each trigram bucket lists, in order, the entries with a name containing
+ * a trigram that hashes to it.
+ */
+struct name_index {
+	struct name_entry *entries;
+	size_t count;
+	size_t allocated;
+
+	u32b *exact;
+	size_t exact_size;
+
+	struct trigram_bucket *trigrams;
+};
+
+/**
+ * FNV-1a hash of a string
+ */
+static u32b name_hash(const char *str)
+{
+	u32b h = 2166136261UL;
+
+	while (*str) {
+		h ^= (unsigned char)*str++;
+		h *= 16777619UL;
+	}
+
+	return h;
+}
+
+/**
+ * Hash the trigram at str, folding case as my_stristr() does
+ */
+static size_t trigram_hash(const char *str)
+{
+	u32b h = toupper((unsigned char)str[0]);
+	h = h * 31 + toupper((unsigned char)str[1]);
+	h = h * 31 + toupper((unsigned char)str[2]);
+	return (h * 2654435761UL >> 8) % TRIGRAM_BUCKETS;
+}
+
+static void exact_insert(struct name_index *idx, u32b n)
+{
+	size_t i = name_hash(idx->entries[n].name) & (idx->exact_size - 1);
+
+	while (idx->exact[i])
+		i = (i + 1) & (idx->exact_size - 1);
+	idx->exact[i] = n + 1;
+}
+
+static void exact_grow(struct name_index *idx)
+{
+	u32b n;
+
+	mem_free(idx->exact);
+	idx->exact_size = idx->exact_size ? idx->exact_size * 2 : 64;
+	idx->exact = mem_zalloc(idx->exact_size * sizeof(u32b));
+
+	for (n = 0; n < idx->count; n++)
+		exact_insert(idx, n);
+}
+
+static void trigrams_add(struct name_index *idx, u32b n)
+{
+	const char *name = idx->entries[n].name;
+	size_t i, len = strlen(name);
+
+	for (i = 0; i + 3 <= len; i++) {
+		struct trigram_bucket *b = &idx->trigrams[trigram_hash(name + i)];
+
+		/* Names repeating a trigram only need listing once */
+		if (b->count && b->entries[b->count - 1] == n)
+			continue;
+
+		if (b->count == b->allocated) {
+			b->allocated = b->allocated ? b->allocated * 2 : 4;
+			b->entries = mem_realloc(b->entries,
+									 b->allocated * sizeof(u32b));
+		}
+		b->entries[b->count++] = n;
+	}
+}
+
+struct name_index *name_index_new(void)
+{
+	struct name_index *idx = mem_zalloc(sizeof *idx);
+	idx->trigrams = mem_zalloc(TRIGRAM_BUCKETS * sizeof(*idx->trigrams));
+	return idx;
+}
+
+void name_index_free(struct name_index *idx)
+{
+	size_t i;
+
+	if (!idx)
+		return;
+
+	for (i = 0; i < idx->count; i++)
+		string_free(idx->entries[i].name);
+	for (i = 0; i < TRIGRAM_BUCKETS; i++)
+		mem_free(idx->trigrams[i].entries);
+	mem_free(idx->trigrams);
+	mem_free(idx->exact);
+	mem_free(idx->entries);
+	mem_free(idx);
+}
+
+/**
+ * Add `name`, standing for `data`, to the index.  If the name is already
+ * there the earlier entry is kept, as a search through the original list
+ * would find that one first.
+ */
+void name_index_add(struct name_index *idx, const char *name, void *data)
+{
+	if (name_index_get(idx, name))
+		return;
+
+	if (idx->count == idx->allocated) {
+		idx->allocated = idx->allocated ? idx->allocated * 2 : 64;
+		idx->entries = mem_realloc(idx->entries,
+								   idx->allocated * sizeof(*idx->entries));
+	}
+	idx->entries[idx->count].name = string_make(name);
+	idx->entries[idx->count].data = data;
+
+	if (2 * (idx->count + 1) > idx->exact_size) {
+		idx->count++;
+		exact_grow(idx);
+	} else {
+		exact_insert(idx, idx->count);
+		idx->count++;
+	}
+	trigrams_add(idx, idx->count - 1);
+}
+
+size_t name_index_size(const struct name_index *idx)
+{
+	return idx->count;
+}
+
+/**
+ * Return the data for exactly `name`, or NULL
+ */
+void *name_index_get(const struct name_index *idx, const char *name)
+{
+	size_t i;
+
+	if (!idx->exact_size)
+		return NULL;
+
+	i = name_hash(name) & (idx->exact_size - 1);
+	while (idx->exact[i]) {
+		struct name_entry *entry = &idx->entries[idx->exact[i] - 1];
+		if (streq(entry->name, name))
+			return entry->data;
+		i = (i + 1) & (idx->exact_size - 1);
+	}
+
+	return NULL;
+}
+
+/**
+ * Return the data for the first name added that contains `name`, ignoring
+ * case as my_stristr() does, or NULL.
+ *
+ * Any name containing `name` has each of its trigrams, so only the entries
+ * in the smallest of their buckets need checking.
+ */
+void *name_index_search(const struct name_index *idx, const char *name)
+{
+	const struct trigram_bucket *best = NULL;
+	size_t i, len = strlen(name);
+
+	/* Too short for trigrams, so look at everything */
+	if (len < 3) {
+		for (i = 0; i < idx->count; i++)
+			if (my_stristr(idx->entries[i].name, name))
+				return idx->entries[i].data;
+		return NULL;
+	}
+
+	for (i = 0; i + 3 <= len; i++) {
+		const struct trigram_bucket *b = &idx->trigrams[trigram_hash(name + i)];
+		if (!best || b->count < best->count)
+			best = b;
+	}
+
+	for (i = 0; i < best->count; i++) {
+		struct name_entry *entry = &idx->entries[best->entries[i]];
+		if (my_stristr(entry->name, name))
+			return entry->data;
+	}
+
+	return NULL;
+}
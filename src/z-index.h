@@ -0,0 +1,33 @@
+/**
+ * \file z-index.h
+ * \brief Indexes from names to data, for exact and fuzzy lookups
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef Z_INDEX_H
+#define Z_INDEX_H
+
+#include "h-basic.h"
+
+struct name_index;
+
+extern struct name_index *name_index_new(void);
+extern void name_index_free(struct name_index *idx);
+extern void name_index_add(struct name_index *idx, const char *name,
+						   void *data);
+extern size_t name_index_size(const struct name_index *idx);
+extern void *name_index_get(const struct name_index *idx, const char *name);
+extern void *name_index_search(const struct name_index *idx,
+							   const char *name);
+
+#endif /* !Z_INDEX_H */
@@ -25,28 +25,92 @@ static char **quarks;
 static size_t nr_quarks = 1;
 static size_t alloc_quarks = 0;
 
+/**
+ * Open-addressed hash index into quarks[]; 0 marks an empty slot, since
+ * quark 0 is never handed out.  It is kept at most half full.
+ */
+static quark_t *quark_index;
+static size_t index_size = 0;
+
 #define QUARKS_INIT	16
 
-quark_t quark_add(const char *str)
+/**
+ * FNV-1a hash of a string
+ */
+static u32b quark_hash(const char *str)
 {
-	quark_t q;
+	u32b h = 2166136261UL;
 
-	for (q = 1; q < nr_quarks; q++) {
-		if (!strcmp(quarks[q], str))
-			return q;
+	while (*str) {
+		h ^= (byte)*str++;
+		h *= 16777619UL;
 	}
 
-	if (nr_quarks == alloc_quarks) {
-		alloc_quarks *= 2;
+	return h;
+}
+
+/**
+ * Find the slot in the index where str is, or would go
+ */
+static size_t quark_slot(const char *str)
+{
+	size_t i = quark_hash(str) & (index_size - 1);
+
+	while (quark_index[i] && strcmp(quarks[quark_index[i]], str))
+		i = (i + 1) & (index_size - 1);
+
+	return i;
+}
+
+/**
+ * Make room for at least n quarks, rebuilding the index if it has to grow
+ */
+static void quarks_grow(size_t n)
+{
+	quark_t q;
+
+	if (n > alloc_quarks) {
+		while (n > alloc_quarks)
+			alloc_quarks *= 2;
 		quarks = mem_realloc(quarks, alloc_quarks * sizeof(char *));
 	}
 
+	if (2 * n <= index_size)
+		return;
+
+	while (2 * n > index_size)
+		index_size *= 2;
+	mem_free(quark_index);
+	quark_index = mem_zalloc(index_size * sizeof(quark_t));
+	for (q = 1; q < nr_quarks; q++)
+		quark_index[quark_slot(quarks[q])] = q;
+}
+
+quark_t quark_add(const char *str)
+{
+	quark_t q;
+	size_t i = quark_slot(str);
+
+	if (quark_index[i])
+		return quark_index[i];
+
+	if (nr_quarks + 1 > alloc_quarks || 2 * (nr_quarks + 1) > index_size) {
+		quarks_grow(nr_quarks + 1);
+		i = quark_slot(str);
+	}
+
 	q = nr_quarks++;
 	quarks[q] = string_make(str);
+	quark_index[i] = q;
 
 	return q;
 }
 
+void quarks_reserve(size_t n)
+{
+	quarks_grow(nr_quarks + n);
+}
+
 const char *quark_str(quark_t q)
 {
 	return (q >= nr_quarks ? NULL : quarks[q]);
@@ -56,6 +120,8 @@ void quarks_init(void)
 {
 	alloc_quarks = QUARKS_INIT;
 	quarks = mem_zalloc(alloc_quarks * sizeof(char*));
+	index_size = 2 * QUARKS_INIT;
+	quark_index = mem_zalloc(index_size * sizeof(quark_t));
 }
 
 void quarks_free(void)
@@ -67,6 +133,9 @@ void quarks_free(void)
 		string_free(quarks[i]);
 
 	mem_free(quarks);
+	mem_free(quark_index);
+	nr_quarks = 1;
+	index_size = 0;
 }
 
 struct init_module z_quark_module = {
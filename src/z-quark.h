@@ -34,6 +34,12 @@ typedef size_t quark_t;
  */
 quark_t quark_add(const char *str);
 
+/**
+ * Make room for 'n' more quarks at once, such as before reading a batch of
+ * inscriptions
+ */
+void quarks_reserve(size_t n);
+
 /**
  * Return the string corresponding to the quark
  */
@@ -50,29 +50,22 @@
 #define MAT0NEG(t, v) (v ^ (v << (-(t))))
 #define Identity(v) (v)
 
-u32b state_i = 0;
-u32b STATE[RAND_DEG] = {0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0,
-						0, 0, 0, 0, 0, 0, 0, 0};
-u32b z0, z1, z2;
-
-#define V0    STATE[state_i]
-#define VM1   STATE[(state_i + M1) & 0x0000001fU]
-#define VM2   STATE[(state_i + M2) & 0x0000001fU]
-#define VM3   STATE[(state_i + M3) & 0x0000001fU]
-#define VRm1  STATE[(state_i + 31) & 0x0000001fU]
-#define newV0 STATE[(state_i + 31) & 0x0000001fU]
-#define newV1 STATE[state_i]
-
-static u32b WELLRNG1024a (void){
-	z0      = VRm1;
-	z1      = Identity(V0) ^ MAT0POS (8, VM1);
-	z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
-	newV1   = z1 ^ z2; 
-	newV0   = MAT0NEG (-11,z0) ^ MAT0NEG(-7,z1) ^ MAT0NEG(-13,z2);
-	state_i = (state_i + 31) & 0x0000001fU;
-	return STATE[state_i];
+#define V0    r->state[r->index]
+#define VM1   r->state[(r->index + M1) & 0x0000001fU]
+#define VM2   r->state[(r->index + M2) & 0x0000001fU]
+#define VM3   r->state[(r->index + M3) & 0x0000001fU]
+#define VRm1  r->state[(r->index + 31) & 0x0000001fU]
+#define newV0 r->state[(r->index + 31) & 0x0000001fU]
+#define newV1 r->state[r->index]
+
+static u32b WELLRNG1024a (struct rng_state *r){
+	r->z0      = VRm1;
+	r->z1      = Identity(V0) ^ MAT0POS (8, VM1);
+	r->z2      = MAT0NEG (-19, VM2) ^ MAT0NEG(-14,VM3);
+	newV1      = r->z1 ^ r->z2; 
+	newV0      = MAT0NEG (-11,r->z0) ^ MAT0NEG(-7,r->z1) ^ MAT0NEG(-13,r->z2);
+	r->index = (r->index + 31) & 0x0000001fU;
+	return r->state[r->index];
 }
 /* end WELL RNG */
 
@@ -83,45 +76,110 @@ static u32b WELLRNG1024a (void){
 
 
 /**
- * Whether to use the simple RNG or not.
+ * The game's own RNG, which starts out using the simple RNG.
  */
-bool Rand_quick = TRUE;
+static struct rng_state Rand_game = { TRUE };
 
 /**
- * The current "seed" of the simple RNG.
+ * The RNG the random number functions currently draw from.
  */
-u32b Rand_value;
+struct rng_state *Rand_context = &Rand_game;
 
 static bool rand_fixed = FALSE;
 static u32b rand_fixval = 0;
 
 /**
- * Initialize the complex RNG using a new seed.
+ * Seed the complex RNG, starting from wherever the state index is.
  */
-void Rand_state_init(u32b seed)
+static void rand_seed(struct rng_state *r, u32b seed)
 {
 	int i, j;
 
 	/* Seed the table */
-	STATE[0] = seed;
+	r->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		r->state[i] = LCRNG(r->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (r->index + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		r->state[j] += r->state[r->index];
 
 		/* Advance the index */
-		state_i = j;
+		r->index = j;
 	}
 }
 
+/**
+ * Initialize the complex RNG using a new seed.
+ *
+ * The result depends on the current state index as well as the seed; use
+ * rng_state_init() for a stream that depends only on the seed.
+ */
+void Rand_state_init(u32b seed)
+{
+	rand_seed(Rand_context, seed);
+}
+
+/**
+ * Make an RNG context current, returning the previous one.  NULL means the
+ * game's own.
+ */
+struct rng_state *Rand_set_context(struct rng_state *rng)
+{
+	struct rng_state *old = Rand_context;
+
+	Rand_context = rng ? rng : &Rand_game;
+	return old;
+}
+
+/**
+ * Set up a context to use the complex RNG, seeded with `seed` alone.
+ */
+void rng_state_init(struct rng_state *rng, u32b seed)
+{
+	memset(rng, 0, sizeof(*rng));
+	rand_seed(rng, seed);
+}
+
+/**
+ * Set up the child context with state drawn from the parent's complex RNG.
+ *
+ * After the split the child's stream is independent of the parent's.  The
+ * parent moves on by RAND_DEG + 1 numbers, so splitting the same parent
+ * repeatedly gives a reproducible set of separate streams.
+ */
+void rng_state_split(struct rng_state *parent, struct rng_state *child)
+{
+	int i;
+
+	memset(child, 0, sizeof(*child));
+	for (i = 0; i < RAND_DEG; i++)
+		child->state[i] = WELLRNG1024a(parent);
+	child->value = WELLRNG1024a(parent);
+}
+
+/**
+ * Copy the current context's state to `rng`.
+ */
+void rng_state_save(struct rng_state *rng)
+{
+	*rng = *Rand_context;
+}
+
+/**
+ * Copy the state in `rng` back into the current context.
+ */
+void rng_state_restore(const struct rng_state *rng)
+{
+	*Rand_context = *rng;
+}
+
 /**
  * Initialise the RNG
  */
@@ -194,7 +252,7 @@ u32b Rand_div(u32b m)
 		/* Use a complex RNG */
 		while (1) {
 			/* Get the next pseudorandom number */
-			r = WELLRNG1024a();
+			r = WELLRNG1024a(Rand_context);
 
 			/* Mutate a 28-bit "random" number */
 			r = ((r >> 4) & 0x0FFFFFFF) / n;
@@ -90,24 +90,65 @@ typedef enum {
 #define one_in_(x) (!randint0(x))
 
 /**
- * Whether we are currently using the "quick" method or not.
+ * The complete state of a random number generator.
+ *
+ * All the random number functions below draw from the current context,
+ * which is the game's own generator unless Rand_set_context() says otherwise.
+ * Code that needs a stream of its own - a level generated in parallel, say -
+ * can keep one of these, seed it with rng_state_init() or rng_state_split(),
+ * and make it current while it works.
+ */
+struct rng_state {
+	/* Whether to use the "quick" method or not */
+	bool quick;
+
+	/* The state used by the "quick" RNG */
+	u32b value;
+
+	/* The state used by the "complex" RNG */
+	u32b index;
+	u32b state[RAND_DEG];
+	u32b z0;
+	u32b z1;
+	u32b z2;
+};
+
+/**
+ * The context the random number functions currently draw from.
  */
-extern bool Rand_quick;
+extern struct rng_state *Rand_context;
 
 /**
- * The state used by the "quick" RNG.
+ * The fields of the current context, under their traditional names.
  */
-extern u32b Rand_value;
+#define Rand_quick	(Rand_context->quick)
+#define Rand_value	(Rand_context->value)
+#define state_i		(Rand_context->index)
+#define STATE		(Rand_context->state)
+
 
 /**
- * The state used by the "complex" RNG.
+ * Make the given RNG context current, or the game's own if it is NULL, and
+ * return the one that was current before.
  */
-extern u32b state_i;
-extern u32b STATE[RAND_DEG];
-extern u32b z0;
-extern u32b z1;
-extern u32b z2;
+struct rng_state *Rand_set_context(struct rng_state *rng);
 
+/**
+ * Seed the complex RNG of the given context from scratch.
+ */
+void rng_state_init(struct rng_state *rng, u32b seed);
+
+/**
+ * Seed the child context with numbers drawn from the parent, to give a
+ * stream independent of the parent's.
+ */
+void rng_state_split(struct rng_state *parent, struct rng_state *child);
+
+/**
+ * Copy the state of the current context out, or back in.
+ */
+void rng_state_save(struct rng_state *rng);
+void rng_state_restore(const struct rng_state *rng);
 
 /**
  * Initialise the RNG state with the given seed.
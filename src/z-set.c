@@ -21,15 +21,99 @@
 #include "z-rand.h"
 #include "z-virt.h"
 
+/**
+ * Sets past this size get a hash index, so finding an element doesn't mean
+ * looking at all of them
+ */
+#define SET_INDEX_MIN	32
+
+/**
+ * The index is open-addressed with linear probing; each slot holds an
+ * element's position in elems[] plus one, or 0 when empty.  An element that
+ * is in the set more than once has a slot for each copy.
+ */
 struct set {
 	void **elems;
 	size_t allocated;
 	size_t filled;
+
+	size_t *index;
+	size_t index_size;
 };
 
 static void _set_check(struct set *s) {
 	assert(s->allocated >= s->filled);
 	assert(!s->allocated || s->elems);
+	assert(!s->index || s->index_size >= 2 * s->filled);
+}
+
+static size_t _set_hash(struct set *s, void *p) {
+	size_t h = (size_t)p;
+	h ^= h >> 4;
+	h *= 0x9E3779B1UL;
+	h ^= h >> 16;
+	return h & (s->index_size - 1);
+}
+
+/**
+ * Find the index slot for position pos, or for any copy of p if pos is
+ * out of range
+ */
+static size_t _set_index_find(struct set *s, void *p, size_t pos) {
+	size_t i = _set_hash(s, p);
+	while (s->index[i]) {
+		size_t at = s->index[i] - 1;
+		if (pos < s->filled ? at == pos : s->elems[at] == p)
+			return i;
+		i = (i + 1) & (s->index_size - 1);
+	}
+	return s->index_size;
+}
+
+static void _set_index_add(struct set *s, size_t pos) {
+	size_t i = _set_hash(s, s->elems[pos]);
+	while (s->index[i])
+		i = (i + 1) & (s->index_size - 1);
+	s->index[i] = pos + 1;
+}
+
+/**
+ * Empty slot i, shifting back any later entries that probed past it
+ */
+static void _set_index_remove(struct set *s, size_t i) {
+	size_t mask = s->index_size - 1;
+	size_t j = i;
+
+	while (TRUE) {
+		size_t home;
+
+		j = (j + 1) & mask;
+		if (!s->index[j])
+			break;
+
+		/* Leave entries which would still be found from their home slot */
+		home = _set_hash(s, s->elems[s->index[j] - 1]);
+		if (((j - home) & mask) < ((j - i) & mask))
+			continue;
+
+		s->index[i] = s->index[j];
+		i = j;
+	}
+	s->index[i] = 0;
+}
+
+/**
+ * (Re)build the index at a size fit for the set
+ */
+static void _set_index_build(struct set *s) {
+	size_t i, nsz = s->index_size ? s->index_size : 2 * SET_INDEX_MIN;
+	while (nsz < 2 * s->filled)
+		nsz *= 2;
+	mem_free(s->index);
+	s->index = mem_zalloc(nsz * sizeof(size_t));
+	s->index_size = nsz;
+	for (i = 0; i < s->filled; i++)
+		_set_index_add(s, i);
 }
 
 static void _set_grow(struct set *s) {
@@ -39,8 +123,23 @@ static void _set_grow(struct set *s) {
 	s->allocated = nsz;
 }
 
+/**
+ * Note that elems[pos] is about to be filled, indexing the set if it's
+ * grown enough to need it
+ */
+static void _set_filled(struct set *s, size_t pos) {
+	if (s->index && 2 * s->filled <= s->index_size)
+		_set_index_add(s, pos);
+	else if (s->index || s->filled >= SET_INDEX_MIN)
+		_set_index_build(s);
+}
+
 static int _set_find(struct set *s, void *p) {
 	size_t i;
+	if (s->index) {
+		i = _set_index_find(s, p, s->filled);
+		return i < s->index_size ? (int)(s->index[i] - 1) : -1;
+	}
 	for (i = 0; i < s->filled; i++)
 		if (s->elems[i] == p)
 			return i;
@@ -54,6 +153,7 @@ struct set *set_new(void) {
 
 void set_free(struct set *s) {
 	_set_check(s);
+	mem_free(s->index);
 	mem_free(s->elems);
 	mem_free(s);
 }
@@ -63,18 +163,30 @@ void set_add(struct set *s, void *p) {
 	if (s->allocated == s->filled)
 		_set_grow(s);
 	s->elems[s->filled++] = p;
+	_set_filled(s, s->filled - 1);
 }
 
 bool set_del(struct set *s, void *p) {
 	ssize_t i;
+	size_t last;
 	_set_check(s);
 
 	i = _set_find(s, p);
 	if (i < 0)
 		return FALSE;
+	last = s->filled - 1;
+
+	/* the last elem moves into the hole, so its index entry moves too */
+	if (s->index) {
+		_set_index_remove(s, _set_index_find(s, p, i));
+		if ((size_t)i != last)
+			s->index[_set_index_find(s, s->elems[last], last)] = i + 1;
+	}
+
 	/* overwrite elem i with the last elem, drop the size of the set
 	 * if the elem to delete is the last elem, this is a noop */
-	s->elems[i] = s->elems[--s->filled];
+	s->elems[i] = s->elems[last];
+	s->filled--;
 	return TRUE;
 }
 
@@ -96,10 +208,33 @@ void *set_get(struct set *s, size_t index) {
 	return s->elems[index];
 }
 
+bool set_contains(struct set *s, void *p) {
+	_set_check(s);
+	return _set_find(s, p) >= 0;
+}
+
 void set_insert(struct set *s, size_t index, void *p) {
 	while (index >= s->allocated)
 		_set_grow(s);
+
+	/* replace, or fill the gap with NULLs as set_get() would return */
+	if (index < s->filled) {
+		if (s->index)
+			_set_index_remove(s,
+				_set_index_find(s, s->elems[index], index));
+		s->elems[index] = p;
+		if (s->index)
+			_set_index_add(s, index);
+		return;
+	}
+
+	while (s->filled <= index) {
+		s->elems[s->filled++] = NULL;
+		_set_filled(s, s->filled - 1);
+	}
+	if (s->index)
+		_set_index_remove(s, _set_index_find(s, NULL, index));
 	s->elems[index] = p;
-	if (index >= s->filled)
-		s->filled = index + 1;
+	if (s->index)
+		_set_index_add(s, index);
 }
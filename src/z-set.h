@@ -32,6 +32,7 @@ extern bool set_del(struct set *s, void *p);
 extern size_t set_size(struct set *s);
 extern void *set_choose(struct set *s);
 extern void *set_get(struct set *s, size_t index);
+extern bool set_contains(struct set *s, void *p);
 extern void set_insert(struct set *s, size_t index, void *p);
 
 #endif /* !Z_SET_H */
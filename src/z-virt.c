@@ -19,6 +19,7 @@
 #include "z-util.h"
 
 unsigned int mem_flags = 0;
+unsigned long mem_alloc_count = 0;
 
 #define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
 
@@ -41,6 +42,7 @@ void *mem_alloc(size_t len)
 	mem = malloc(len + sizeof(size_t));
 	if (!mem)
 		quit("Out of Memory!");
+	mem_alloc_count++;
 	mem += sizeof(size_t);
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
@@ -77,6 +79,7 @@ void *mem_realloc(void *p, size_t len)
 
 	/* Handle OOM */
 	if (!m) quit("Out of Memory!");
+	mem_alloc_count++;
 	SZ(m) = len;
 
 	return m;
@@ -34,4 +34,10 @@ enum {
 
 extern unsigned int mem_flags;
 
+/**
+ * Number of blocks handed out by mem_alloc() and mem_realloc(); used by
+ * the benchmark front end to count allocations.
+ */
+extern unsigned long mem_alloc_count;
+
 #endif /* INCLUDED_Z_VIRT_H */